@@ -0,0 +1,75 @@
+#include "AudioRing.h"
+#include <assert.h>
+#include <string.h>
+
+AudioRing::AudioRing(uint32_t capacity) :
+    m_mask        (0),
+    m_write_index (0),
+    m_read_index  (0),
+    m_last_sample (0),
+    m_underruns   (0),
+    m_overruns    (0)
+{
+    assert(capacity > 0 && capacity <= (1u << 31) && "Invalid audio ring capacity");
+
+    uint32_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    m_samples.resize(size, 0);
+    m_mask = size - 1;
+}
+
+uint32_t AudioRing::Write(const int16_t* samples, uint32_t count)
+{
+    // The indices run freely and wrap around 2^32, their difference is the number queued.
+    const uint32_t write = m_write_index.load(std::memory_order_relaxed);
+    const uint32_t read  = m_read_index.load(std::memory_order_acquire);
+    const uint32_t space = GetCapacity() - (write - read);
+
+    if (count > space)
+    {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        count = space;
+    }
+
+    // At most two copies, before and after the end of the buffer.
+    const uint32_t start = write & m_mask;
+    const uint32_t first = count < GetCapacity() - start ? count : GetCapacity() - start;
+    memcpy(&m_samples[start], samples, first * sizeof(int16_t));
+    memcpy(&m_samples[0], samples + first, (count - first) * sizeof(int16_t));
+
+    m_write_index.store(write + count, std::memory_order_release);
+    return count;
+}
+
+void AudioRing::Read(int16_t* out, uint32_t count)
+{
+    const uint32_t read   = m_read_index.load(std::memory_order_relaxed);
+    const uint32_t write  = m_write_index.load(std::memory_order_acquire);
+    const uint32_t queued = write - read;
+    const uint32_t taken  = count < queued ? count : queued;
+
+    const uint32_t start = read & m_mask;
+    const uint32_t first = taken < GetCapacity() - start ? taken : GetCapacity() - start;
+    memcpy(out, &m_samples[start], first * sizeof(int16_t));
+    memcpy(out + first, &m_samples[0], (taken - first) * sizeof(int16_t));
+
+    if (taken > 0)
+        m_last_sample = out[taken - 1];
+
+    m_read_index.store(read + taken, std::memory_order_release);
+
+    // Holding the last level instead of dropping to 0 avoids a click on top of the gap.
+    if (taken < count)
+    {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t i = taken; i < count; ++i)
+            out[i] = m_last_sample;
+    }
+}
+
+uint32_t AudioRing::GetNumQueued() const
+{
+    return m_write_index.load(std::memory_order_acquire) - m_read_index.load(std::memory_order_acquire);
+}
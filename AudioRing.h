@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Types.h"
+#include <atomic>
+#include <vector>
+
+/*
+    Samples on their way from the emulation thread to the audio device.
+
+    Single producer, single consumer: only the emulation thread calls Write and only the audio
+    callback calls Read. Each side owns one index and only reads the other's, so neither ever
+    waits on a lock or allocates; the buffer is allocated once by the constructor.
+
+    Neither side blocks when the other falls behind. Write drops what doesn't fit (an overrun, the
+    emulation runs faster than the device plays), Read pads the device buffer with the last sample
+    played (an underrun, the device drains faster than the emulation fills). Both are counted for
+    the debug UI.
+*/
+class AudioRing
+{
+public:
+    // capacity is rounded up to a power of two.
+    AudioRing(uint32_t capacity);
+
+    AudioRing(const AudioRing&) = delete;
+    AudioRing& operator=(const AudioRing&) = delete;
+
+    // Emulation thread. Returns how many samples were queued, the rest are dropped.
+    uint32_t Write (const int16_t* samples, uint32_t count);
+    // Audio thread. Always fills count samples.
+    void     Read  (int16_t* out, uint32_t count);
+
+    uint32_t GetCapacity  () const { return m_mask + 1; }
+    uint32_t GetNumQueued () const;
+    uint32_t GetUnderruns () const { return m_underruns.load(std::memory_order_relaxed); }
+    uint32_t GetOverruns  () const { return m_overruns.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<int16_t> m_samples;
+    uint32_t             m_mask;
+
+    // Each index on its own cache line, written by a single thread.
+    alignas(64) std::atomic<uint32_t> m_write_index;
+    alignas(64) std::atomic<uint32_t> m_read_index;
+    int16_t                           m_last_sample; // Audio thread only.
+
+    alignas(64) std::atomic<uint32_t> m_underruns;   // Reads that came up short.
+    std::atomic<uint32_t>             m_overruns;    // Writes that dropped samples.
+};
@@ -0,0 +1,167 @@
+#include "BandLimitedBuffer.h"
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+    using Kernel = int16_t[BandLimitedBuffer::KERNEL_PHASES][BandLimitedBuffer::KERNEL_WIDTH];
+
+    // Blackman windowed sinc, cut a bit under Nyquist. One row per sub-sample position of the step,
+    // each summing to 1 << 15 so a step of n ends up exactly n after integration.
+    void BuildKernel(Kernel& kernel)
+    {
+        constexpr double PI     = 3.14159265358979323846;
+        constexpr double CUTOFF = 0.9;
+        constexpr double HALF   = BandLimitedBuffer::KERNEL_WIDTH / 2.0;
+
+        for (uint32_t phase = 0; phase < BandLimitedBuffer::KERNEL_PHASES; ++phase)
+        {
+            double taps[BandLimitedBuffer::KERNEL_WIDTH];
+            double sum = 0.0;
+
+            for (uint32_t i = 0; i < BandLimitedBuffer::KERNEL_WIDTH; ++i)
+            {
+                const double x      = i + 1 - static_cast<double>(phase) / BandLimitedBuffer::KERNEL_PHASES - HALF;
+                const double sinc   = x == 0.0 ? 1.0 : sin(PI * CUTOFF * x) / (PI * CUTOFF * x);
+                const double window = 0.42 + 0.5 * cos(PI * x / HALF) + 0.08 * cos(2.0 * PI * x / HALF);
+
+                taps[i] = sinc * window;
+                sum    += taps[i];
+            }
+
+            int32_t  total   = 0;
+            uint32_t largest = 0;
+            for (uint32_t i = 0; i < BandLimitedBuffer::KERNEL_WIDTH; ++i)
+            {
+                kernel[phase][i] = static_cast<int16_t>(lround(taps[i] / sum * (1 << 15)));
+                total += kernel[phase][i];
+                largest = kernel[phase][i] > kernel[phase][largest] ? i : largest;
+            }
+
+            // Rounding goes on the biggest tap so the step size stays exact.
+            kernel[phase][largest] += static_cast<int16_t>((1 << 15) - total);
+        }
+    }
+
+    const Kernel& GetKernel()
+    {
+        static Kernel kernel;
+        static const bool built = (BuildKernel(kernel), true);
+        (void)built;
+        return kernel;
+    }
+};
+
+BandLimitedBuffer::BandLimitedBuffer(uint32_t max_samples) :
+    m_max_samples (max_samples),
+    m_base_factor (0),
+    m_factor      (0),
+    m_offset      (0),
+    m_available   (0),
+    m_integrator  (0)
+{
+    assert(max_samples > 0 && "The buffer must hold at least one sample");
+}
+
+void BandLimitedBuffer::SetRates(double clock_rate, double sample_rate)
+{
+    assert(clock_rate >= sample_rate && "The clock must be faster than the output");
+    m_base_factor = static_cast<uint64_t>(sample_rate / clock_rate * static_cast<double>(1ull << FRACTION_BITS));
+    m_factor      = m_base_factor;
+
+    // Room for a full buffer of unread samples plus a frame being built.
+    m_deltas.resize(m_max_samples * 2 + KERNEL_WIDTH);
+    GetKernel();
+    Clear();
+}
+
+void BandLimitedBuffer::SetRateAdjustment(double ratio)
+{
+    assert(ratio > 0.5 && ratio < 2.0 && "The rate is only meant to be adjusted slightly");
+    m_factor = static_cast<uint64_t>(static_cast<double>(m_base_factor) * ratio);
+}
+
+void BandLimitedBuffer::Clear()
+{
+    m_offset     = 0;
+    m_available  = 0;
+    m_integrator = 0;
+    std::fill(m_deltas.begin(), m_deltas.end(), 0);
+}
+
+void BandLimitedBuffer::AddDelta(uint32_t clock_time, int32_t delta)
+{
+    const uint64_t position = m_offset + clock_time * m_factor;
+    const uint64_t index    = position >> FRACTION_BITS;
+
+    // Before SetRates, or a frame far longer than the buffer (stepping in the debugger).
+    if (index + KERNEL_WIDTH > m_deltas.size())
+        return;
+
+    const uint32_t phase  = static_cast<uint32_t>(position >> (FRACTION_BITS - PHASE_BITS)) & (KERNEL_PHASES - 1);
+    const int16_t* kernel = GetKernel()[phase];
+    int32_t*       out    = &m_deltas[index];
+
+    for (uint32_t i = 0; i < KERNEL_WIDTH; ++i)
+        out[i] += delta * kernel[i];
+}
+
+void BandLimitedBuffer::EndFrame(uint32_t clock_duration)
+{
+    if (m_deltas.empty())
+        return;
+
+    const uint64_t limit = static_cast<uint64_t>(m_deltas.size() - KERNEL_WIDTH) << FRACTION_BITS;
+
+    m_offset += clock_duration * m_factor;
+    if (m_offset > limit)
+        m_offset = limit;
+
+    m_available = static_cast<uint32_t>(m_offset >> FRACTION_BITS);
+
+    // Nobody is reading, the oldest samples go. They are still integrated so the output doesn't jump.
+    if (m_available > m_max_samples)
+        ReadSamples(nullptr, m_available - m_max_samples);
+}
+
+uint32_t BandLimitedBuffer::ReadSamples(int16_t* out, uint32_t max_samples)
+{
+    const uint32_t count = max_samples < m_available ? max_samples : m_available;
+    if (count == 0)
+        return 0;
+
+    int32_t integrator = m_integrator;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        integrator += m_deltas[i];
+
+        int32_t sample = integrator >> DELTA_BITS;
+        integrator -= sample * (1 << (DELTA_BITS - BASS_SHIFT));
+
+        if (sample < INT16_MIN)
+            sample = INT16_MIN;
+        else if (sample > INT16_MAX)
+            sample = INT16_MAX;
+
+        if (out)
+            out[i] = static_cast<int16_t>(sample);
+    }
+    m_integrator = integrator;
+
+    RemoveSamples(count);
+    return count;
+}
+
+void BandLimitedBuffer::RemoveSamples(uint32_t count)
+{
+    // What is left: the unread samples and the kernel tails reaching past them.
+    const uint32_t remaining = m_available - count + KERNEL_WIDTH;
+
+    memmove(m_deltas.data(), &m_deltas[count], remaining * sizeof(int32_t));
+    memset(&m_deltas[remaining], 0, count * sizeof(int32_t));
+
+    m_offset    -= static_cast<uint64_t>(count) << FRACTION_BITS;
+    m_available -= count;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+
+/*
+    Audio output built from amplitude steps instead of samples.
+
+    A sound chip reports every change of its output level with AddDelta, timed in its own clock.
+    The step is not written as a hard edge but as a band-limited one: a windowed sinc kernel,
+    picked among KERNEL_PHASES sub-sample positions, is added to a buffer of deltas. ReadSamples
+    integrates the deltas into PCM, with a gentle high-pass so the unipolar chip output sits
+    around 0. The cost depends on the number of level changes, not on the chip clock, and the
+    result doesn't alias like a square wave sampled at 44.1kHz would.
+
+    Time restarts at 0 with each frame: EndFrame(duration) makes the samples of that much clock
+    available. When nobody reads them the oldest ones are dropped, the buffer never grows.
+*/
+class BandLimitedBuffer
+{
+public:
+    static constexpr uint32_t KERNEL_WIDTH  = 16; // Samples touched by a step.
+    static constexpr uint32_t PHASE_BITS    = 6;
+    static constexpr uint32_t KERNEL_PHASES = 1 << PHASE_BITS;
+
+public:
+    BandLimitedBuffer(uint32_t max_samples);
+
+    // Clock of the times given to AddDelta, in Hz. Nothing is allocated or output before.
+    void SetRates(double clock_rate, double sample_rate);
+    // Stretches the output by ratio (1.0 is the rate given to SetRates), to follow a clock that
+    // drifts from the nominal sample rate. Only between frames, the current one has no deltas yet.
+    void SetRateAdjustment(double ratio);
+    void Clear();
+
+    void AddDelta (uint32_t clock_time, int32_t delta);
+    void EndFrame (uint32_t clock_duration);
+
+    uint32_t GetSamplesAvailable() const { return m_available; }
+    // Moves up to max_samples into out, returns how many.
+    uint32_t ReadSamples(int16_t* out, uint32_t max_samples);
+
+private:
+    void RemoveSamples(uint32_t count);
+
+private:
+    static constexpr uint32_t FRACTION_BITS = 32; // Of the sample positions.
+    static constexpr uint32_t DELTA_BITS    = 15; // Of the kernel and the deltas.
+    static constexpr uint32_t BASS_SHIFT    = 9;  // High-pass corner, about 14Hz at 44.1kHz.
+
+    uint32_t             m_max_samples;
+    uint64_t             m_base_factor; // Samples per clock, as given to SetRates.
+    uint64_t             m_factor;      // Same with the rate adjustment.
+    uint64_t             m_offset;      // Position of the frame start, from the first unread sample.
+    uint32_t             m_available;
+    int32_t              m_integrator;
+    std::vector<int32_t> m_deltas;      // Unread samples, the current frame and the tail of the kernel.
+};
@@ -0,0 +1,156 @@
+#include "CompressedRom.h"
+#include "Crc32.h"
+#include "Inflate.h"
+#include <ctype.h>
+#include <string.h>
+
+namespace
+{
+    constexpr uint32_t ZIP_LOCAL_HEADER     = 0x04034b50;
+    constexpr uint32_t ZIP_CENTRAL_HEADER   = 0x02014b50;
+    constexpr uint32_t ZIP_END_OF_DIRECTORY = 0x06054b50;
+
+    constexpr uint16_t ZIP_METHOD_STORED    = 0;
+    constexpr uint16_t ZIP_METHOD_DEFLATE   = 8;
+
+    constexpr byte     GZIP_FLAG_HCRC       = 1 << 1;
+    constexpr byte     GZIP_FLAG_EXTRA      = 1 << 2;
+    constexpr byte     GZIP_FLAG_NAME       = 1 << 3;
+    constexpr byte     GZIP_FLAG_COMMENT    = 1 << 4;
+
+    inline uint16_t Read16(const byte* data) { return static_cast<uint16_t>(data[0] | (data[1] << 8)); }
+    inline uint32_t Read32(const byte* data) { return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24); }
+
+    bool IsGzip(const byte* data, size_t size) { return size >= 18 && data[0] == 0x1f && data[1] == 0x8b; }
+    bool IsZip (const byte* data, size_t size) { return size >= 22 && Read32(data) == ZIP_LOCAL_HEADER; }
+
+    bool HasRomExtension(const byte* name, size_t length)
+    {
+        return length >= 4 && name[length - 4] == '.' && tolower(name[length - 3]) == 's' && tolower(name[length - 2]) == 'm' && tolower(name[length - 1]) == 's';
+    }
+
+    bool OpenGzip(const byte* data, size_t size, CompressedRomInfo& out_info)
+    {
+        const byte flags  = data[3];
+        size_t     offset = 10;
+
+        if (data[2] != 8) // Deflate is the only method.
+            return false;
+
+        if (flags & GZIP_FLAG_EXTRA)
+        {
+            if (offset + 2 > size)
+                return false;
+            offset += 2 + Read16(&data[offset]);
+        }
+        if (flags & GZIP_FLAG_NAME)
+            while (offset < size && data[offset++] != 0) {}
+        if (flags & GZIP_FLAG_COMMENT)
+            while (offset < size && data[offset++] != 0) {}
+        if (flags & GZIP_FLAG_HCRC)
+            offset += 2;
+
+        // The trailer holds the CRC32 and the size modulo 4GB, plenty for a cartridge.
+        if (offset + 8 > size)
+            return false;
+
+        out_info.data              = &data[offset];
+        out_info.compressed_size   = size - 8 - offset;
+        out_info.crc32             = Read32(&data[size - 8]);
+        out_info.uncompressed_size = Read32(&data[size - 4]);
+        out_info.stored            = false;
+        return true;
+    }
+
+    bool OpenZip(const byte* data, size_t size, CompressedRomInfo& out_info)
+    {
+        // The end of central directory record is at the end, followed by a comment of up to 64KB.
+        size_t end_of_directory = size - 22;
+        const size_t search_end = size > 22 + 0xffff ? size - 22 - 0xffff : 0;
+        while (Read32(&data[end_of_directory]) != ZIP_END_OF_DIRECTORY)
+        {
+            if (end_of_directory == search_end)
+                return false;
+            --end_of_directory;
+        }
+
+        const uint16_t num_entries = Read16(&data[end_of_directory + 10]);
+        size_t         entry       = Read32(&data[end_of_directory + 16]);
+
+        // Sizes are taken from the central directory, local headers may leave them to a trailing descriptor.
+        size_t chosen = 0;
+        bool   found  = false;
+        for (uint16_t i = 0; i < num_entries; ++i)
+        {
+            if (entry + 46 > size || Read32(&data[entry]) != ZIP_CENTRAL_HEADER)
+                return false;
+
+            const uint16_t name_length = Read16(&data[entry + 28]);
+            if (entry + 46 + name_length > size)
+                return false;
+
+            const bool is_rom = HasRomExtension(&data[entry + 46], name_length);
+            if (!found || is_rom)
+                chosen = entry;
+            found = true;
+
+            if (is_rom)
+                break;
+
+            entry += 46 + name_length + Read16(&data[entry + 30]) + Read16(&data[entry + 32]);
+        }
+
+        if (!found)
+            return false;
+
+        const uint16_t method       = Read16(&data[chosen + 10]);
+        const size_t   local_header = Read32(&data[chosen + 42]);
+
+        if ((method != ZIP_METHOD_STORED && method != ZIP_METHOD_DEFLATE) || local_header + 30 > size || Read32(&data[local_header]) != ZIP_LOCAL_HEADER)
+            return false;
+
+        const size_t offset = local_header + 30 + Read16(&data[local_header + 26]) + Read16(&data[local_header + 28]);
+
+        out_info.data              = &data[offset];
+        out_info.compressed_size   = Read32(&data[chosen + 20]);
+        out_info.uncompressed_size = Read32(&data[chosen + 24]);
+        out_info.crc32             = Read32(&data[chosen + 16]);
+        out_info.stored            = method == ZIP_METHOD_STORED;
+
+        return offset + out_info.compressed_size <= size;
+    }
+}
+
+bool CompressedRom::IsCompressed(const byte* data, size_t size)
+{
+    return data && (IsGzip(data, size) || IsZip(data, size));
+}
+
+bool CompressedRom::Open(const byte* data, size_t size, CompressedRomInfo& out_info)
+{
+    if (!data)
+        return false;
+    if (IsGzip(data, size))
+        return OpenGzip(data, size, out_info);
+    if (IsZip(data, size))
+        return OpenZip(data, size, out_info);
+    return false;
+}
+
+bool CompressedRom::Extract(const CompressedRomInfo& info, byte* out)
+{
+    if (info.stored)
+    {
+        if (info.compressed_size != info.uncompressed_size)
+            return false;
+        memcpy(out, info.data, info.uncompressed_size);
+    }
+    else
+    {
+        size_t written = 0;
+        if (!Inflate::Decompress(info.data, info.compressed_size, out, info.uncompressed_size, written) || written != info.uncompressed_size)
+            return false;
+    }
+
+    return Crc32::Compute(out, info.uncompressed_size) == info.crc32;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+
+struct CompressedRomInfo
+{
+    const byte* data;              // Compressed stream, inside the archive.
+    size_t      compressed_size;
+    size_t      uncompressed_size;
+    uint32_t    crc32;             // Of the uncompressed data, as stored in the archive.
+    bool        stored;            // Not compressed at all (zip method 0).
+};
+
+/*
+    gzip (RFC 1952) and zip archives holding a ROM.
+
+    Open parses the container in place and Extract decodes the stream straight into the caller's
+    buffer (see Inflate), so nothing is written to disk and the archive is only read once.
+    For zip files the first .sms entry is used, or the first entry if there isn't any.
+*/
+namespace CompressedRom
+{
+    bool IsCompressed (const byte* data, size_t size);
+    bool Open         (const byte* data, size_t size, CompressedRomInfo& out_info);
+    // out must hold info.uncompressed_size bytes. Fails on corrupt streams and CRC mismatches.
+    bool Extract      (const CompressedRomInfo& info, byte* out);
+};
@@ -0,0 +1,57 @@
+#include "Crc32.h"
+
+namespace
+{
+    constexpr uint32_t POLYNOMIAL = 0xEDB88320; // Reflected 0x04C11DB7.
+
+    struct Crc32Tables
+    {
+        uint32_t table[8][256];
+
+        // table[0] is the classic byte-wise table, table[n] advances a byte that is n positions further away.
+        constexpr Crc32Tables() : table()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (crc >> 1) ^ ((crc & 1) ? POLYNOMIAL : 0);
+                table[0][i] = crc;
+            }
+
+            for (uint32_t i = 0; i < 256; ++i)
+                for (int slice = 1; slice < 8; ++slice)
+                    table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xff];
+        }
+    };
+
+    constexpr Crc32Tables s_tables;
+}
+
+uint32_t Crc32::Compute(const byte* data, size_t size, uint32_t crc)
+{
+    const uint32_t (&table)[8][256] = s_tables.table;
+
+    crc = ~crc;
+
+    // 8 bytes per iteration, each one looked up in its own table so the loads don't depend on each other.
+    while (size >= 8)
+    {
+        // Little endian loads whatever the host is, the lowest byte is consumed first.
+        const uint32_t lo = (data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24)) ^ crc;
+        const uint32_t hi =  data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<uint32_t>(data[7]) << 24);
+
+        crc = table[7][ lo        & 0xff] ^ table[6][(lo >>  8) & 0xff] ^
+              table[5][(lo >> 16) & 0xff] ^ table[4][ lo >> 24        ] ^
+              table[3][ hi        & 0xff] ^ table[2][(hi >>  8) & 0xff] ^
+              table[1][(hi >> 16) & 0xff] ^ table[0][ hi >> 24        ];
+
+        data += 8;
+        size -= 8;
+    }
+
+    while (size--)
+        crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
+
+    return ~crc;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+
+/*
+    CRC-32 (IEEE 802.3, the one used by zip and every ROM database), slice-by-8.
+
+    The CRC32 instruction of SSE4.2 / ARMv8 computes CRC-32C, a different polynomial,
+    so it can't be used to look up ROM hashes.
+*/
+namespace Crc32
+{
+    // crc is the value returned by a previous call, to hash data in several pieces.
+    uint32_t Compute(const byte* data, size_t size, uint32_t crc = 0);
+};
@@ -0,0 +1,112 @@
+#include "Debugger.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+Debugger::Debugger()
+    : m_flags           (nullptr),
+      m_paused          (false),
+      m_skip_next_check (false),
+      m_step_requested  (false),
+      m_break_reason    (BreakReason::None),
+      m_break_address   (0)
+{
+}
+
+Debugger::~Debugger()
+{
+    free(m_flags);
+}
+
+void Debugger::AllocateFlags()
+{
+    // Every console has a debugger, most never set a single breakpoint.
+    if (!m_flags)
+        m_flags = (byte*)calloc(0x10000, sizeof(byte));
+}
+
+void Debugger::AddBreakpoint(word address)
+{
+    AllocateFlags();
+
+    if (m_flags[address] & BREAKPOINT)
+        return;
+
+    m_flags[address] |= BREAKPOINT;
+    m_breakpoints.insert(std::upper_bound(m_breakpoints.begin(), m_breakpoints.end(), address), address);
+}
+
+void Debugger::RemoveBreakpoint(word address)
+{
+    if (m_flags)
+        m_flags[address] &= ~BREAKPOINT;
+    RemoveFromList(m_breakpoints, address);
+}
+
+void Debugger::AddWatchpoint(word address, bool read, bool write)
+{
+    if (!read && !write)
+        return;
+
+    AllocateFlags();
+
+    if ((m_flags[address] & (WATCH_READ | WATCH_WRITE)) == 0)
+        m_watchpoints.insert(std::upper_bound(m_watchpoints.begin(), m_watchpoints.end(), address), address);
+
+    m_flags[address] |= (read ? WATCH_READ : 0) | (write ? WATCH_WRITE : 0);
+}
+
+void Debugger::RemoveWatchpoint(word address)
+{
+    if (m_flags)
+        m_flags[address] &= ~(WATCH_READ | WATCH_WRITE);
+    RemoveFromList(m_watchpoints, address);
+}
+
+void Debugger::Clear()
+{
+    if (m_flags)
+        memset(m_flags, 0, 0x10000);
+    m_breakpoints.clear();
+    m_watchpoints.clear();
+    Continue();
+}
+
+void Debugger::RequestBreak(BreakReason reason, word address)
+{
+    // Keep the first reason if several watchpoints are hit by the same instruction.
+    if (m_paused)
+        return;
+
+    m_paused        = true;
+    m_break_reason  = reason;
+    m_break_address = address;
+}
+
+void Debugger::Continue()
+{
+    m_skip_next_check = m_paused;
+    m_paused          = false;
+    m_step_requested  = false;
+    m_break_reason    = BreakReason::None;
+}
+
+void Debugger::RequestStep()
+{
+    if (m_paused)
+        m_step_requested = true;
+}
+
+bool Debugger::ConsumeStep()
+{
+    const bool step  = m_step_requested;
+    m_step_requested = false;
+    return step;
+}
+
+void Debugger::RemoveFromList(std::vector<word>& list, word address)
+{
+    const auto it = std::lower_bound(list.begin(), list.end(), address);
+    if (it != list.end() && *it == address)
+        list.erase(it);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+
+/*
+    PC breakpoints and memory watchpoints.
+
+    Lookups are a single indexed load in a 64KB flag table. The checks are only compiled in the
+    debug instantiation of the run loop (SMS::RunFrame) and in WatchpointMM, which is only
+    installed in front of the cartridge mapping while watchpoints exist. Without breakpoints
+    nor watchpoints the normal loop and memory path are used untouched.
+*/
+class Debugger
+{
+public:
+    enum class BreakReason : uint8_t
+    {
+        None = 0,
+        Breakpoint,
+        ReadWatchpoint,
+        WriteWatchpoint,
+        Step
+    };
+
+    enum Flag : byte
+    {
+        BREAKPOINT  = 1 << 0,
+        WATCH_READ  = 1 << 1,
+        WATCH_WRITE = 1 << 2
+    };
+
+public:
+    Debugger();
+    ~Debugger();
+
+    Debugger(const Debugger&) = delete;
+    Debugger& operator=(const Debugger&) = delete;
+
+    void AddBreakpoint    (word address);
+    void RemoveBreakpoint (word address);
+    void AddWatchpoint    (word address, bool read, bool write);
+    void RemoveWatchpoint (word address);
+    void Clear            ();
+
+    inline bool HasBreakpoints () const { return !m_breakpoints.empty(); }
+    inline bool HasWatchpoints () const { return !m_watchpoints.empty(); }
+    inline bool IsActive       () const { return HasBreakpoints() || HasWatchpoints() || m_paused; }
+
+    inline const std::vector<word>& GetBreakpoints () const { return m_breakpoints; }
+    inline const std::vector<word>& GetWatchpoints () const { return m_watchpoints; }
+    inline byte                     GetFlags       (word address) const { return m_flags ? m_flags[address] : 0; }
+
+public: // Run loop
+    inline bool ShouldBreakAt(word pc)
+    {
+        // The instruction we resume from must run once, even if it has a breakpoint.
+        if (m_skip_next_check)
+        {
+            m_skip_next_check = false;
+            return false;
+        }
+
+        // Paused by a step without any breakpoint, the flags may not exist.
+        if (m_flags && (m_flags[pc] & BREAKPOINT))
+        {
+            RequestBreak(BreakReason::Breakpoint, pc);
+            return true;
+        }
+        return false;
+    }
+
+    inline void OnRead(word address)
+    {
+        if (m_flags[address] & WATCH_READ)
+            RequestBreak(BreakReason::ReadWatchpoint, address);
+    }
+
+    inline void OnWrite(word address)
+    {
+        if (m_flags[address] & WATCH_WRITE)
+            RequestBreak(BreakReason::WriteWatchpoint, address);
+    }
+
+    void RequestBreak(BreakReason reason, word address);
+
+public: // Control
+    inline bool        IsPaused        () const { return m_paused; }
+    inline BreakReason GetBreakReason  () const { return m_break_reason; }
+    inline word        GetBreakAddress () const { return m_break_address; }
+
+    void Continue    ();
+    void RequestStep ();
+    bool ConsumeStep ();
+
+private:
+    void RemoveFromList(std::vector<word>& list, word address);
+    void AllocateFlags();
+
+private:
+    byte*             m_flags;           // Per address, allocated with the first breakpoint or watchpoint.
+    std::vector<word> m_breakpoints;
+    std::vector<word> m_watchpoints;
+
+    bool              m_paused;
+    bool              m_skip_next_check;
+    bool              m_step_requested;
+    BreakReason       m_break_reason;
+    word              m_break_address;
+};
@@ -0,0 +1,82 @@
+#include "Profiler.h"
+#include "Z80Disassembler.h"
+#include "GameRom.h"
+#include <algorithm>
+
+void Profiler::Reset(uint32_t rom_size)
+{
+    m_rom_size     = rom_size;
+    m_total_cycles = 0;
+
+    m_instructions.assign(rom_size + RAM_SIZE, 0);
+    m_cycles.assign(rom_size + RAM_SIZE, 0);
+    m_addresses.assign(rom_size + RAM_SIZE, 0);
+}
+
+void Profiler::GetHotSpots(const Memory& memory, const GameRom& game_rom, uint32_t max_hot_spots, std::vector<ProfilerHotSpot>& out_hot_spots) const
+{
+    out_hot_spots.clear();
+
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < m_instructions.size(); ++i)
+    {
+        if (m_instructions[i] != 0)
+            indices.push_back(i);
+    }
+
+    const uint32_t count = std::min<uint32_t>(max_hot_spots, static_cast<uint32_t>(indices.size()));
+    std::partial_sort(indices.begin(), indices.begin() + count, indices.end(), [this](uint32_t a, uint32_t b) { return m_cycles[a] > m_cycles[b]; });
+
+    const byte*    rom      = game_rom.GetRom();
+    const uint32_t rom_size = static_cast<uint32_t>(game_rom.GetSize());
+
+    out_hot_spots.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t   index    = indices[i];
+        ProfilerHotSpot& hot_spot = out_hot_spots[i];
+
+        hot_spot.rom_offset   = index < m_rom_size ? static_cast<int32_t>(index) : -1;
+        hot_spot.address      = m_addresses[index];
+        hot_spot.instructions = m_instructions[index];
+        hot_spot.cycles       = m_cycles[index];
+
+        // ROM code is decoded from the image, RAM code from its current contents.
+        byte bytes[Z80Disassembler::MAX_INSTRUCTION_SIZE] = {};
+        for (uint32_t b = 0; b < Z80Disassembler::MAX_INSTRUCTION_SIZE; ++b)
+        {
+            if (hot_spot.rom_offset >= 0)
+                bytes[b] = (index + b < rom_size && rom) ? rom[index + b] : 0;
+            else
+                bytes[b] = memory.PeekMemory(static_cast<word>(hot_spot.address + b));
+        }
+
+        Z80Disassembler::Disassemble(bytes, hot_spot.address, hot_spot.disassembly, sizeof(hot_spot.disassembly));
+    }
+}
+
+void Profiler::WriteReport(FILE* file, const Memory& memory, const GameRom& game_rom, uint32_t max_hot_spots) const
+{
+    if (!file)
+        return;
+
+    std::vector<ProfilerHotSpot> hot_spots;
+    GetHotSpots(memory, game_rom, max_hot_spots, hot_spots);
+
+    fprintf(file, "---- Hot spots (%llu cycles profiled) ----\n", static_cast<unsigned long long>(m_total_cycles));
+    fprintf(file, "%-8s %-6s %14s %16s %8s  %s\n", "bank", "pc", "instructions", "cycles", "%", "disassembly");
+
+    for (const ProfilerHotSpot& hot_spot : hot_spots)
+    {
+        char bank[8];
+        if (hot_spot.rom_offset >= 0)
+            snprintf(bank, sizeof(bank), "%02X", hot_spot.rom_offset / 0x4000);
+        else
+            snprintf(bank, sizeof(bank), "RAM");
+
+        const double percentage = m_total_cycles ? 100.0 * hot_spot.cycles / m_total_cycles : 0.0;
+
+        fprintf(file, "%-8s %04X   %14u %16llu %7.2f%%  %s\n", bank, hot_spot.address, hot_spot.instructions,
+                static_cast<unsigned long long>(hot_spot.cycles), percentage, hot_spot.disassembly);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Types.h"
+#include "Memory.h"
+#include <stdio.h>
+#include <vector>
+
+class GameRom;
+
+struct ProfilerHotSpot
+{
+    int32_t  rom_offset;      // -1 when the code runs from RAM.
+    word     address;         // Last CPU address the location was executed from.
+    uint32_t instructions;
+    uint64_t cycles;
+    char     disassembly[32];
+};
+
+/*
+    Execution profiler.
+
+    Counts instructions and cycles for every ROM offset (bank * 16KB + offset in bank) in flat
+    arrays sized to the cartridge, followed by the 32KB that can hold RAM (0x8000 - 0xFFFF).
+    It is only called from the profiled instantiation of the run loop (see SMS::RunFrame).
+*/
+class Profiler
+{
+public:
+    static constexpr uint32_t RAM_START = 0x8000;
+    static constexpr uint32_t RAM_SIZE  = 0x10000 - RAM_START;
+
+public:
+    Profiler() : m_enabled(false), m_rom_size(0), m_total_cycles(0) {}
+
+    void Reset(uint32_t rom_size);
+
+    inline bool     IsEnabled      () const         { return m_enabled; }
+    inline void     SetEnabled     (bool enabled)   { m_enabled = enabled; }
+    inline uint64_t GetTotalCycles () const         { return m_total_cycles; }
+
+    inline void Record(const Memory& memory, word pc, uint32_t cycles)
+    {
+        const int32_t rom_offset = memory.GetRomOffset(pc);
+
+        uint32_t index = 0;
+        if (rom_offset >= 0 && static_cast<uint32_t>(rom_offset) < m_rom_size)
+            index = rom_offset;
+        else if (pc >= RAM_START)
+            index = m_rom_size + (pc - RAM_START);
+        else
+            return;
+
+        ++m_instructions[index];
+        m_cycles[index]    += cycles;
+        m_addresses[index]  = pc;
+        m_total_cycles     += cycles;
+    }
+
+    // Locations sorted by cycles spent, most expensive first.
+    void GetHotSpots (const Memory& memory, const GameRom& game_rom, uint32_t max_hot_spots, std::vector<ProfilerHotSpot>& out_hot_spots) const;
+    void WriteReport (FILE* file, const Memory& memory, const GameRom& game_rom, uint32_t max_hot_spots) const;
+
+private:
+    bool                  m_enabled;
+    uint32_t              m_rom_size;
+    uint64_t              m_total_cycles;
+    std::vector<uint32_t> m_instructions;
+    std::vector<uint64_t> m_cycles;
+    std::vector<word>     m_addresses;
+};
@@ -0,0 +1,160 @@
+#include "Z80Disassembler.h"
+#include "Z80Instructions/Z80Mnemonics.h"
+#include <stdio.h>
+#include <string.h>
+
+uint8_t Z80Disassembler::Disassemble(const byte bytes[MAX_INSTRUCTION_SIZE], word address, char* out, size_t out_size)
+{
+    const byte opcode = bytes[0];
+
+    switch (opcode)
+    {
+    case 0xCB:
+    {
+        const char* mnemonic = Z80Instructions::s_opcode_cb_mnemonics[bytes[1]];
+        if (!mnemonic)
+            break;
+        return 2 + Format(mnemonic, &bytes[2], address + 2, nullptr, nullptr, out, out_size);
+    }
+    case 0xED:
+    {
+        const char* mnemonic = Z80Instructions::s_opcode_ed_mnemonics[bytes[1]];
+        if (!mnemonic)
+            break;
+        const uint8_t size = 2 + CountOperandBytes(mnemonic);
+        Format(mnemonic, &bytes[2], address + size, nullptr, nullptr, out, out_size);
+        return size;
+    }
+    case 0xDD:
+    case 0xFD:
+    {
+        const char* index_register = opcode == 0xDD ? "ix" : "iy";
+
+        // DDCB / FDCB: prefix, CB, displacement, opcode
+        if (bytes[1] == 0xCB)
+        {
+            const char* mnemonic = Z80Instructions::s_opcode_cb_mnemonics[bytes[3]];
+            if (!mnemonic)
+                break;
+            Format(mnemonic, nullptr, address + 4, index_register, &bytes[2], out, out_size);
+            return 4;
+        }
+
+        const char* mnemonic = Z80Instructions::s_opcode_mnemonics[bytes[1]];
+        if (!mnemonic || bytes[1] == 0xDD || bytes[1] == 0xED || bytes[1] == 0xFD)
+            break;
+
+        // EX de,hl is not affected by the prefix. JP (hl) uses the register, not an indexed address.
+        if (bytes[1] == 0xEB)
+            return 2 + Format(mnemonic, &bytes[2], address + 2, nullptr, nullptr, out, out_size);
+
+        const bool indexed = bytes[1] != 0xE9 && strstr(mnemonic, "(hl)") != nullptr;
+        const byte* operands = indexed ? &bytes[3] : &bytes[2];
+        const uint8_t size   = 2 + (indexed ? 1 : 0) + CountOperandBytes(mnemonic);
+
+        Format(mnemonic, operands, address + size, index_register, indexed ? &bytes[2] : nullptr, out, out_size);
+        return size;
+    }
+    default:
+    {
+        const char* mnemonic = Z80Instructions::s_opcode_mnemonics[opcode];
+        if (!mnemonic)
+            break;
+        const uint8_t size = 1 + CountOperandBytes(mnemonic);
+        Format(mnemonic, &bytes[1], address + size, nullptr, nullptr, out, out_size);
+        return size;
+    }
+    }
+
+    snprintf(out, out_size, "DB $%02X", opcode);
+    return 1;
+}
+
+uint8_t Z80Disassembler::CountOperandBytes(const char* mnemonic)
+{
+    uint8_t count = 0;
+    for (const char* c = mnemonic; *c; ++c)
+    {
+        if (*c != '{')
+            continue;
+
+        count += (c[1] == 'n' && c[2] == 'n') ? 2 : 1;
+    }
+    return count;
+}
+
+/*
+    Expands the placeholders of the mnemonic ({n}, {nn}, {e}) with the operand bytes.
+    When an index register is given, hl is replaced by it and (hl) by (ix+d).
+    Returns the number of operand bytes consumed.
+*/
+uint8_t Z80Disassembler::Format(const char* mnemonic, const byte* operands, word next_address, const char* index_register, const byte* displacement, char* out, size_t out_size)
+{
+    if (out_size == 0)
+        return 0;
+
+    size_t  length   = 0;
+    uint8_t consumed = 0;
+
+    auto append = [&](const char* text)
+    {
+        const size_t text_length = strlen(text);
+        const size_t available   = out_size - 1 - length;
+        const size_t copied      = text_length < available ? text_length : available;
+        memcpy(&out[length], text, copied);
+        length += copied;
+    };
+
+    char buffer[16];
+    const char* c = mnemonic;
+    while (*c)
+    {
+        if (c[0] == '{')
+        {
+            if (c[1] == 'n' && c[2] == 'n')
+            {
+                snprintf(buffer, sizeof(buffer), "$%04X", operands[consumed] | (operands[consumed + 1] << 8));
+                consumed += 2;
+            }
+            else if (c[1] == 'e')
+            {
+                const word target = static_cast<word>(next_address + static_cast<int8_t>(operands[consumed]));
+                snprintf(buffer, sizeof(buffer), "$%04X", target);
+                consumed += 1;
+            }
+            else
+            {
+                snprintf(buffer, sizeof(buffer), "$%02X", operands[consumed]);
+                consumed += 1;
+            }
+            append(buffer);
+
+            c = strchr(c, '}');
+            c = c ? c + 1 : c + strlen(c);
+            continue;
+        }
+
+        if (index_register && strncmp(c, "(hl)", 4) == 0 && displacement)
+        {
+            const int8_t offset = static_cast<int8_t>(*displacement);
+            snprintf(buffer, sizeof(buffer), "(%s%c$%02X)", index_register, offset < 0 ? '-' : '+', offset < 0 ? -offset : offset);
+            append(buffer);
+            c += 4;
+            continue;
+        }
+
+        if (index_register && strncmp(c, "hl", 2) == 0)
+        {
+            append(index_register);
+            c += 2;
+            continue;
+        }
+
+        const char character[2] = { *c, '\0' };
+        append(character);
+        ++c;
+    }
+
+    out[length] = '\0';
+    return consumed;
+}
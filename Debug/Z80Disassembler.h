@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+
+/*
+    Z80 disassembler built from the generated mnemonic tables (Z80Instructions/Z80Mnemonics.h).
+
+    Instructions are decoded from a window of MAX_INSTRUCTION_SIZE bytes, so the caller
+    decides where they come from (ROM image, mapped CPU memory, trace entries...).
+*/
+class Z80Disassembler
+{
+public:
+    static constexpr uint8_t MAX_INSTRUCTION_SIZE = 4;
+
+public:
+    // Writes the instruction found in bytes into out and returns its size in bytes.
+    // address is the CPU address of the first byte, used to resolve relative jumps.
+    static uint8_t Disassemble(const byte bytes[MAX_INSTRUCTION_SIZE], word address, char* out, size_t out_size);
+
+private:
+    static uint8_t Format(const char* mnemonic, const byte* operands, word next_address, const char* index_register, const byte* displacement, char* out, size_t out_size);
+    static uint8_t CountOperandBytes(const char* mnemonic);
+};
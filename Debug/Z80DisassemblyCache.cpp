@@ -0,0 +1,91 @@
+#include "Z80DisassemblyCache.h"
+#include "Memory.h"
+#include <string.h>
+
+void Z80DisassemblyCache::Reset(uint32_t rom_size)
+{
+    m_num_rom_banks = (rom_size + BANK_SIZE - 1) / BANK_SIZE;
+
+    m_banks.clear();
+    m_banks.resize(m_num_rom_banks + (0x10000 - RAM_START) / BANK_SIZE);
+}
+
+const DisassemblyLine& Z80DisassemblyCache::Get(const Memory& memory, word address)
+{
+    const int32_t rom_offset = memory.GetRomOffset(address);
+
+    uint32_t bank_index;
+    uint32_t line_index;
+    if (rom_offset >= 0)
+    {
+        bank_index = static_cast<uint32_t>(rom_offset) / BANK_SIZE;
+        line_index = static_cast<uint32_t>(rom_offset) % BANK_SIZE;
+    }
+    else
+    {
+        bank_index = m_num_rom_banks + (address - RAM_START) / BANK_SIZE;
+        line_index = (address - RAM_START) % BANK_SIZE;
+    }
+
+    // Nothing mapped (ROM offset unknown below RAM) or a ROM size the cache wasn't reset for.
+    if ((rom_offset < 0 && address < RAM_START) || bank_index >= m_banks.size())
+    {
+        Decode(memory, address, m_uncached_line);
+        return m_uncached_line;
+    }
+
+    std::unique_ptr<Bank>& bank = m_banks[bank_index];
+    if (!bank)
+        bank.reset(new Bank());
+
+    DisassemblyLine& line = bank->lines[line_index];
+
+    // RAM can change at any time and an instruction crossing a 16KB slot can read from another bank,
+    // so those lines are only valid while memory still holds the bytes they were decoded from.
+    const bool validate = rom_offset < 0 || line_index + Z80Disassembler::MAX_INSTRUCTION_SIZE > BANK_SIZE;
+
+    bool valid = line.size != 0 && line.address == address;
+    for (uint8_t b = 0; valid && validate && b < line.size; ++b)
+        valid = memory.PeekMemory(static_cast<word>(address + b)) == line.bytes[b];
+
+    if (!valid)
+        Decode(memory, address, line);
+
+    return line;
+}
+
+word Z80DisassemblyCache::GetPreviousAddress(const Memory& memory, word address)
+{
+    // Z80 code can't be decoded backwards. Decode forward from increasingly far points and keep the
+    // first chain of instructions that ends exactly on address; longer chains resynchronize better.
+    static constexpr uint16_t MAX_LOOKBEHIND = 16;
+
+    for (uint16_t distance = MAX_LOOKBEHIND; distance > 0; --distance)
+    {
+        word current  = static_cast<word>(address - distance);
+        word previous = current;
+
+        uint16_t walked = 0;
+        while (walked < distance)
+        {
+            const uint8_t size = Get(memory, current).size;
+            previous = current;
+            current  = static_cast<word>(current + size);
+            walked  += size;
+        }
+
+        if (walked == distance)
+            return previous;
+    }
+
+    return static_cast<word>(address - 1);
+}
+
+void Z80DisassemblyCache::Decode(const Memory& memory, word address, DisassemblyLine& line)
+{
+    for (uint8_t b = 0; b < Z80Disassembler::MAX_INSTRUCTION_SIZE; ++b)
+        line.bytes[b] = memory.PeekMemory(static_cast<word>(address + b));
+
+    line.address = address;
+    line.size    = Z80Disassembler::Disassemble(line.bytes, address, line.text, sizeof(line.text));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Types.h"
+#include "Z80Disassembler.h"
+#include <memory>
+#include <vector>
+
+class Memory;
+
+struct DisassemblyLine
+{
+    uint8_t size;                                          // 0 while the slot hasn't been decoded.
+    word    address;                                       // CPU address the text was formatted for.
+    byte    bytes[Z80Disassembler::MAX_INSTRUCTION_SIZE];  // Bytes the line was decoded from.
+    char    text[27];
+};
+
+/*
+    Decoded instruction cache for the debugger views.
+
+    ROM lines are stored per 16KB cartridge bank and indexed by ROM offset (see Memory::GetRomOffset),
+    so a bank switch simply makes the lookup land in another bank and ROM is decoded only once.
+    The text depends on the CPU address (relative jump targets), so a bank mapped in another slot
+    than the one it was decoded in is formatted again.
+    Lines decoded from RAM (0x8000 - 0xFFFF) keep the bytes they were decoded from and are decoded
+    again when the memory no longer matches, which invalidates them after a write without adding
+    anything to the CPU write path.
+*/
+class Z80DisassemblyCache
+{
+public:
+    static constexpr uint32_t BANK_SIZE = 0x4000;
+    static constexpr uint32_t RAM_START = 0x8000;
+
+public:
+    Z80DisassemblyCache() : m_num_rom_banks(0) {}
+
+    void Reset(uint32_t rom_size);
+
+    // Instruction at address as currently mapped.
+    const DisassemblyLine& Get(const Memory& memory, word address);
+
+    // Best guess for the start of the instruction that ends at address, used to scroll up.
+    word GetPreviousAddress(const Memory& memory, word address);
+
+private:
+    struct Bank
+    {
+        DisassemblyLine lines[BANK_SIZE];
+    };
+
+    static void Decode(const Memory& memory, word address, DisassemblyLine& line);
+
+private:
+    std::vector<std::unique_ptr<Bank>> m_banks; // ROM banks followed by the two 16KB RAM slots, allocated on first use.
+    uint32_t                           m_num_rom_banks;
+    DisassemblyLine                    m_uncached_line;
+};
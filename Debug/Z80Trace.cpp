@@ -0,0 +1,58 @@
+#include "Z80Trace.h"
+#include "Z80Disassembler.h"
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    // Traces are mostly loops, so each PC is decoded once per dump and reused while its bytes match.
+    struct TraceDecodeSlot
+    {
+        word    pc;
+        byte    bytes[Z80Disassembler::MAX_INSTRUCTION_SIZE];
+        bool    valid;
+        char    text[27];
+    };
+
+    constexpr uint32_t DECODE_SLOTS = 1024; // Must be a power of 2.
+}
+
+void Z80Trace::Dump(FILE* file, uint32_t max_entries) const
+{
+    if (!file)
+        return;
+
+    const uint32_t head      = m_head.load(std::memory_order_acquire);
+    const uint32_t available = head < MAX_READABLE ? head : MAX_READABLE;
+    const uint32_t count     = available < max_entries ? available : max_entries;
+
+    std::vector<TraceDecodeSlot> decoded(DECODE_SLOTS);
+
+    fprintf(file, "---- Z80 trace (%u instructions) ----\n", count);
+
+    for (uint32_t i = head - count; i != head; ++i)
+    {
+        const Z80TraceEntry& entry = m_entries[i & INDEX_MASK];
+
+        char bytes[16] = {};
+        for (uint8_t b = 0; b < entry.num_bytes; ++b)
+            snprintf(&bytes[b * 3], sizeof(bytes) - b * 3, "%02X ", entry.opcode[b]);
+
+        // Bytes the instruction didn't fetch are unknown, they are only used as operands of an invalid decode.
+        byte opcode[Z80Disassembler::MAX_INSTRUCTION_SIZE] = {};
+        memcpy(opcode, entry.opcode, entry.num_bytes);
+
+        TraceDecodeSlot& slot = decoded[entry.pc & (DECODE_SLOTS - 1)];
+        if (!slot.valid || slot.pc != entry.pc || memcmp(slot.bytes, opcode, sizeof(opcode)) != 0)
+        {
+            slot.pc    = entry.pc;
+            slot.valid = true;
+            memcpy(slot.bytes, opcode, sizeof(opcode));
+            Z80Disassembler::Disassemble(opcode, entry.pc, slot.text, sizeof(slot.text));
+        }
+
+        fprintf(file, "%12llu  %04X  %-12s %-20s AF:%04X BC:%04X DE:%04X HL:%04X IX:%04X IY:%04X SP:%04X\n",
+                static_cast<unsigned long long>(entry.cycle), entry.pc, bytes, slot.text,
+                entry.af, entry.bc, entry.de, entry.hl, entry.ix, entry.iy, entry.sp);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Types.h"
+#include <assert.h>
+#include <atomic>
+#include <stdio.h>
+
+/*
+    Instruction trace.
+
+    Set SMS_ENABLE_TRACE to 1 in the project preprocessor definitions to record every
+    executed instruction in a fixed size ring buffer. When it is 0 nothing is compiled
+    into the CPU loop.
+
+    The emulation thread is the only writer. Dumps must be taken on the emulation thread
+    (the UI between two frames, the assertion handler) or while it is paused: the head
+    only tells which entries were committed, a dump racing the CPU could copy entries that
+    are being overwritten.
+*/
+#ifndef SMS_ENABLE_TRACE
+#define SMS_ENABLE_TRACE 0
+#endif
+
+struct Z80TraceEntry
+{
+    uint64_t cycle;     // CPU cycle stamp before the instruction is executed.
+    word     pc;
+    word     af;
+    word     bc;
+    word     de;
+    word     hl;
+    word     ix;
+    word     iy;
+    word     sp;
+    byte     opcode[4]; // Bytes fetched through ReadByte/ReadWord while executing the instruction.
+    uint8_t  num_bytes;
+};
+
+class Z80Trace
+{
+public:
+    static constexpr uint32_t NUM_ENTRIES  = 1 << 14; // Must be a power of 2.
+    static constexpr uint32_t INDEX_MASK   = NUM_ENTRIES - 1;
+    static constexpr uint32_t MAX_READABLE = NUM_ENTRIES - 1;
+
+public:
+    Z80Trace() : m_current(&m_entries[0]), m_head(0) {}
+
+    // The entry is filled in place while the instruction runs and published by Commit,
+    // so recording never copies nor reads memory twice.
+    inline Z80TraceEntry& Begin()
+    {
+        m_current = &m_entries[m_head.load(std::memory_order_relaxed) & INDEX_MASK];
+        m_current->num_bytes = 0;
+        return *m_current;
+    }
+
+    inline void AddByte(byte data)
+    {
+        if (m_current->num_bytes < sizeof(m_current->opcode))
+            m_current->opcode[m_current->num_bytes++] = data;
+    }
+
+    inline void Commit()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    inline void     Clear        ()       { m_head.store(0, std::memory_order_release); }
+    // The slot after the head may be being written, so one entry is never readable.
+    inline uint32_t GetNumEntries() const { const uint32_t head = m_head.load(std::memory_order_acquire); return head < MAX_READABLE ? head : MAX_READABLE; }
+
+    // Prints the last max_entries instructions, oldest first. Emulation thread or paused only.
+    void Dump(FILE* file, uint32_t max_entries = MAX_READABLE) const;
+
+private:
+    Z80TraceEntry         m_entries[NUM_ENTRIES];
+    Z80TraceEntry*        m_current;
+    std::atomic<uint32_t> m_head;
+};
+
+#if SMS_ENABLE_TRACE
+// Dumps the instruction trace before failing the assertion.
+#define Z80_TRACE_ASSERT(cpu, cond) do { if (!(cond)) { (cpu).GetTrace().Dump(stderr, 64); assert(cond); } } while (0)
+#else
+#define Z80_TRACE_ASSERT(cpu, cond) assert(cond)
+#endif
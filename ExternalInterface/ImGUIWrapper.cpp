@@ -2,6 +2,11 @@
 
 #include "SDLInterface.h"
 #include "Z80.h"
+#include "GameRom.h"
+#include "AudioRing.h"
+#include "Debug/Profiler.h"
+#include "Debug/Debugger.h"
+#include "Debug/Z80DisassemblyCache.h"
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_sdl2.h"
@@ -61,32 +66,287 @@ void ImGUIWrapper::DrawRegisters(const Z80* z80)
     const ImVec4 title_color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
 
     ImGui::TextColored(title_color, "S Z Y H X P/V N C");
-    AddBinaryText("%c %c %c %c %c  %c  %c %c", z80->m_reg_AF.lo);
+    AddBinaryText("%c %c %c %c %c  %c  %c %c", z80->m_state.reg_AF.lo);
 
     ImGui::Separator();
 
     if (ImGui::BeginTable("register_table", 3))
     {
-        AddRegisterText("A",  z80->m_reg_AF.hi);
-        AddRegisterText("F",  z80->m_reg_AF.lo);
-        AddRegisterText("A'", z80->m_reg_AF_shadow.hi);
-        AddRegisterText("F'", z80->m_reg_AF_shadow.lo);
-        AddRegisterText("B",  z80->m_reg_BC.hi);
-        AddRegisterText("C",  z80->m_reg_BC.lo);
-        AddRegisterText("B'", z80->m_reg_BC_shadow.hi);
-        AddRegisterText("C'", z80->m_reg_BC_shadow.lo);
-        AddRegisterText("D'", z80->m_reg_DE.hi);
-        AddRegisterText("E'", z80->m_reg_DE.lo);
-        AddRegisterText("D'", z80->m_reg_DE_shadow.hi);
-        AddRegisterText("E'", z80->m_reg_DE_shadow.lo);
-        AddRegisterText("H",  z80->m_reg_HL.hi);
-        AddRegisterText("L",  z80->m_reg_HL.lo);
-        AddRegisterText("H'", z80->m_reg_HL_shadow.hi);
-        AddRegisterText("L'", z80->m_reg_HL_shadow.lo);
+        AddRegisterText("A",  z80->m_state.reg_AF.hi);
+        AddRegisterText("F",  z80->m_state.reg_AF.lo);
+        AddRegisterText("A'", z80->m_state.reg_AF_shadow.hi);
+        AddRegisterText("F'", z80->m_state.reg_AF_shadow.lo);
+        AddRegisterText("B",  z80->m_state.reg_BC.hi);
+        AddRegisterText("C",  z80->m_state.reg_BC.lo);
+        AddRegisterText("B'", z80->m_state.reg_BC_shadow.hi);
+        AddRegisterText("C'", z80->m_state.reg_BC_shadow.lo);
+        AddRegisterText("D'", z80->m_state.reg_DE.hi);
+        AddRegisterText("E'", z80->m_state.reg_DE.lo);
+        AddRegisterText("D'", z80->m_state.reg_DE_shadow.hi);
+        AddRegisterText("E'", z80->m_state.reg_DE_shadow.lo);
+        AddRegisterText("H",  z80->m_state.reg_HL.hi);
+        AddRegisterText("L",  z80->m_state.reg_HL.lo);
+        AddRegisterText("H'", z80->m_state.reg_HL_shadow.hi);
+        AddRegisterText("L'", z80->m_state.reg_HL_shadow.lo);
 
         ImGui::EndTable();
     }
 
+#if SMS_ENABLE_TRACE
+    ImGui::Separator();
+    if (ImGui::Button("Dump trace"))
+        z80->GetTrace().Dump(stdout);
+#endif
+
+    ImGui::End();
+}
+
+void ImGUIWrapper::DrawProfiler(Profiler* profiler, const Memory* memory, const GameRom* game_rom)
+{
+    // Sorting the whole ROM every UI frame is too expensive, refresh the list a couple of times per second.
+    static constexpr uint32_t REFRESH_FRAMES = 30;
+    static constexpr uint32_t MAX_HOT_SPOTS  = 32;
+
+    static std::vector<ProfilerHotSpot> hot_spots;
+    static uint32_t                     frames_since_refresh = REFRESH_FRAMES;
+
+    ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    bool enabled = profiler->IsEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled))
+        profiler->SetEnabled(enabled);
+
+    ImGui::SameLine();
+    if (ImGui::Button("Reset") && game_rom)
+    {
+        profiler->Reset(static_cast<uint32_t>(game_rom->GetSize()));
+        hot_spots.clear();
+    }
+
+    if (game_rom && game_rom->IsValid() && ++frames_since_refresh >= REFRESH_FRAMES)
+    {
+        profiler->GetHotSpots(*memory, *game_rom, MAX_HOT_SPOTS, hot_spots);
+        frames_since_refresh = 0;
+    }
+
+    const uint64_t total_cycles = profiler->GetTotalCycles();
+
+    if (ImGui::BeginTable("profiler_table", 5))
+    {
+        const ImVec4 title_color = ImVec4(0.0f, 1.0f, 1.0f, 1.0f);
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::TextColored(title_color, "Bank");
+        ImGui::TableNextColumn(); ImGui::TextColored(title_color, "PC");
+        ImGui::TableNextColumn(); ImGui::TextColored(title_color, "Cycles");
+        ImGui::TableNextColumn(); ImGui::TextColored(title_color, "%%");
+        ImGui::TableNextColumn(); ImGui::TextColored(title_color, "Instruction");
+
+        for (const ProfilerHotSpot& hot_spot : hot_spots)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (hot_spot.rom_offset >= 0)
+                ImGui::Text("%02X", hot_spot.rom_offset / 0x4000);
+            else
+                ImGui::Text("RAM");
+            ImGui::TableNextColumn();
+            ImGui::Text("%04X", hot_spot.address);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(hot_spot.cycles));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", total_cycles ? 100.0 * hot_spot.cycles / total_cycles : 0.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", hot_spot.disassembly);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+void ImGUIWrapper::DrawDebugger(Debugger* debugger, const Z80* z80)
+{
+    static word address = 0x0000;
+
+    ImGui::Begin("Debugger", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    const ImVec4 title_color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
+
+    if (debugger->IsPaused())
+    {
+        static const char* reasons[] = { "", "Breakpoint", "Read watchpoint", "Write watchpoint", "Step" };
+        ImGui::TextColored(title_color, "Paused (%s %04X) at PC %04X", reasons[static_cast<uint8_t>(debugger->GetBreakReason())], debugger->GetBreakAddress(), z80->m_state.program_counter);
+
+        if (ImGui::Button("Continue"))
+            debugger->Continue();
+        ImGui::SameLine();
+        if (ImGui::Button("Step"))
+            debugger->RequestStep();
+    }
+    else
+    {
+        ImGui::TextColored(title_color, "Running");
+        if (ImGui::Button("Break"))
+            debugger->RequestBreak(Debugger::BreakReason::Step, z80->m_state.program_counter);
+    }
+
+    ImGui::Separator();
+
+    ImGui::SetNextItemWidth(60.0f);
+    ImGui::InputScalar("Address", ImGuiDataType_U16, &address, nullptr, nullptr, "%04X", ImGuiInputTextFlags_CharsHexadecimal);
+
+    if (ImGui::Button("Breakpoint"))
+        debugger->AddBreakpoint(address);
+    ImGui::SameLine();
+    if (ImGui::Button("Watch R"))
+        debugger->AddWatchpoint(address, true, false);
+    ImGui::SameLine();
+    if (ImGui::Button("Watch W"))
+        debugger->AddWatchpoint(address, false, true);
+    ImGui::SameLine();
+    if (ImGui::Button("Watch RW"))
+        debugger->AddWatchpoint(address, true, true);
+
+    // Removing entries invalidates the lists, so it is applied after drawing them.
+    int32_t remove_breakpoint = -1;
+    int32_t remove_watchpoint = -1;
+
+    for (const word breakpoint : debugger->GetBreakpoints())
+    {
+        ImGui::PushID(breakpoint);
+        if (ImGui::SmallButton("x"))
+            remove_breakpoint = breakpoint;
+        ImGui::SameLine();
+        ImGui::Text("Break  %04X", breakpoint);
+        ImGui::PopID();
+    }
+
+    for (const word watchpoint : debugger->GetWatchpoints())
+    {
+        const byte flags = debugger->GetFlags(watchpoint);
+
+        ImGui::PushID(0x10000 + watchpoint);
+        if (ImGui::SmallButton("x"))
+            remove_watchpoint = watchpoint;
+        ImGui::SameLine();
+        ImGui::Text("Watch  %04X %c%c", watchpoint, (flags & Debugger::WATCH_READ) ? 'R' : '-', (flags & Debugger::WATCH_WRITE) ? 'W' : '-');
+        ImGui::PopID();
+    }
+
+    if (remove_breakpoint >= 0)
+        debugger->RemoveBreakpoint(static_cast<word>(remove_breakpoint));
+    if (remove_watchpoint >= 0)
+        debugger->RemoveWatchpoint(static_cast<word>(remove_watchpoint));
+
+    ImGui::End();
+}
+
+void ImGUIWrapper::DrawDisassembly(Z80DisassemblyCache* disassembly, Debugger* debugger, const Z80* z80)
+{
+    static constexpr uint32_t NUM_LINES = 32;
+
+    static bool follow_pc   = true;
+    static word top_address = 0x0000;
+
+    const Memory& memory = *z80->GetMemory();
+    const word    pc     = z80->m_state.program_counter;
+
+    ImGui::Begin("Disassembly", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    ImGui::Checkbox("Follow PC", &follow_pc);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(60.0f);
+    if (ImGui::InputScalar("Go to", ImGuiDataType_U16, &top_address, nullptr, nullptr, "%04X", ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue))
+        follow_pc = false;
+
+    // Keep a few instructions of context above the PC.
+    if (follow_pc)
+    {
+        top_address = pc;
+        for (uint32_t i = 0; i < 4; ++i)
+            top_address = disassembly->GetPreviousAddress(memory, top_address);
+    }
+
+    if (ImGui::IsWindowHovered())
+    {
+        const float wheel = ImGui::GetIO().MouseWheel;
+        if (wheel != 0.0f)
+            follow_pc = false;
+
+        if (wheel > 0.0f)
+            top_address = disassembly->GetPreviousAddress(memory, top_address);
+        else if (wheel < 0.0f)
+            top_address = static_cast<word>(top_address + disassembly->Get(memory, top_address).size);
+    }
+
+    ImGui::Separator();
+
+    const ImVec4 pc_color         = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
+    const ImVec4 breakpoint_color = ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+
+    word address = top_address;
+    for (uint32_t i = 0; i < NUM_LINES; ++i)
+    {
+        const DisassemblyLine& line = disassembly->Get(memory, address);
+        const bool breakpoint = (debugger->GetFlags(address) & Debugger::BREAKPOINT) != 0;
+
+        char bytes[16] = {};
+        for (uint8_t b = 0; b < line.size; ++b)
+            snprintf(&bytes[b * 3], sizeof(bytes) - b * 3, "%02X ", line.bytes[b]);
+
+        // Clicking a line toggles its breakpoint.
+        ImGui::PushID(i);
+        ImGui::PushStyleColor(ImGuiCol_Text, address == pc ? pc_color : (breakpoint ? breakpoint_color : ImGui::GetStyleColorVec4(ImGuiCol_Text)));
+
+        char text[64];
+        snprintf(text, sizeof(text), "%c %04X  %-12s %s", breakpoint ? '*' : ' ', address, bytes, line.text);
+        if (ImGui::Selectable(text, address == pc))
+            breakpoint ? debugger->RemoveBreakpoint(address) : debugger->AddBreakpoint(address);
+
+        ImGui::PopStyleColor();
+        ImGui::PopID();
+
+        address = static_cast<word>(address + line.size);
+    }
+
+    ImGui::End();
+}
+
+void ImGUIWrapper::DrawSpeed(double speed, bool fast_forward, uint32_t* frame_skip, uint32_t max_frame_skip)
+{
+    ImGui::Begin("Speed", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    const ImVec4 title_color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
+    ImGui::Text("Speed      x%.2f", speed);
+    if (fast_forward)
+    {
+        ImGui::SameLine();
+        ImGui::TextColored(title_color, "Fast-forward");
+    }
+
+    const uint32_t min_frame_skip = 0;
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::SliderScalar("Frame skip", ImGuiDataType_U32, frame_skip, &min_frame_skip, &max_frame_skip);
+    ImGui::TextDisabled("Hold Tab to fast-forward");
+
+    ImGui::End();
+}
+
+void ImGUIWrapper::DrawAudio(const AudioRing* audio_ring, uint32_t sample_rate, double rate_adjustment)
+{
+    ImGui::Begin("Audio", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    const uint32_t queued = audio_ring->GetNumQueued();
+    ImGui::Text("Queued     %5u / %u (%.1f ms)", queued, audio_ring->GetCapacity(), 1000.0 * queued / sample_rate);
+    ImGui::ProgressBar(static_cast<float>(queued) / audio_ring->GetCapacity(), ImVec2(200.0f, 0.0f), "");
+
+    // Underruns are heard as gaps, overruns as skips.
+    ImGui::Text("Underruns  %u", audio_ring->GetUnderruns());
+    ImGui::Text("Overruns   %u", audio_ring->GetOverruns());
+    ImGui::Text("Rate       %+.3f%%", (rate_adjustment - 1.0) * 100.0);
+
     ImGui::End();
 }
 
@@ -12,6 +12,11 @@ public:
     static void ProcessEvent(const SDL_Event* event);
     static void NewFrame();
     static void DrawRegisters(const class Z80* z80);
+    static void DrawProfiler(class Profiler* profiler, const class Memory* memory, const class GameRom* game_rom);
+    static void DrawDebugger(class Debugger* debugger, const class Z80* z80);
+    static void DrawDisassembly(class Z80DisassemblyCache* disassembly, class Debugger* debugger, const class Z80* z80);
+    static void DrawSpeed(double speed, bool fast_forward, uint32_t* frame_skip, uint32_t max_frame_skip);
+    static void DrawAudio(const class AudioRing* audio_ring, uint32_t sample_rate, double rate_adjustment);
     static void Shutdown();
 
 private:
@@ -1,6 +1,8 @@
 # include "SDLInterface.h"
 
 #include "Types.h"
+#include "IODevice.h"
+#include "AudioRing.h"
 
 // Suggested in stb_image.h header
 #define STB_IMAGE_IMPLEMENTATION
@@ -43,6 +45,36 @@ void SDLInterface::RenderFrame(const byte* const buffer)
     SDL_RenderPresent(m_renderer);
 }
 
+bool SDLInterface::InitAudio(uint32_t sample_rate, AudioRing* ring)
+{
+    assert(ring != nullptr);
+
+    SDL_AudioSpec desired = {};
+    desired.freq     = static_cast<int>(sample_rate);
+    desired.format   = AUDIO_S16SYS;
+    desired.channels = 1;
+    desired.samples  = 512; // About 12ms at 44.1kHz.
+    desired.callback = AudioCallback;
+    desired.userdata = ring;
+
+    // No changes allowed, SDL converts if the device wants another format, so the callback always gets this one.
+    SDL_AudioSpec obtained = {};
+    m_audio_device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, 0);
+    return m_audio_device != 0;
+}
+
+void SDLInterface::SetAudioPaused(bool paused)
+{
+    if (m_audio_device != 0)
+        SDL_PauseAudioDevice(m_audio_device, paused ? 1 : 0);
+}
+
+void SDLCALL SDLInterface::AudioCallback(void* user_data, Uint8* stream, int length)
+{
+    // Audio thread: no lock, no allocation, whatever is queued or the last sample held.
+    static_cast<AudioRing*>(user_data)->Read(reinterpret_cast<int16_t*>(stream), static_cast<uint32_t>(length) / sizeof(int16_t));
+}
+
 void SDLInterface::InitIcon(const char* ImagePath)
 {
     const int required_comp = STBI_rgb_alpha;
@@ -59,6 +91,10 @@ void SDLInterface::InitIcon(const char* ImagePath)
 
 void SDLInterface::Quit()
 {
+    if (m_audio_device != 0)
+        SDL_CloseAudioDevice(m_audio_device);
+    m_audio_device = 0;
+
     SDL_Quit();
 }
 
@@ -66,3 +102,40 @@ bool SDLInterface::ExitRequested(const SDL_Event& event)
 {
     return event.type == SDL_QUIT || (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(m_window));
 }
+
+bool SDLInterface::SaveStateRequested(const SDL_Event& event)
+{
+    return event.type == SDL_KEYDOWN && event.key.repeat == 0 && event.key.keysym.sym == SDLK_F5;
+}
+
+bool SDLInterface::LoadStateRequested(const SDL_Event& event)
+{
+    return event.type == SDL_KEYDOWN && event.key.repeat == 0 && event.key.keysym.sym == SDLK_F8;
+}
+
+bool SDLInterface::IsRewindHeld()
+{
+    // Held state rather than an event, the game rewinds for as long as the key is down.
+    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_BACKSPACE] != 0;
+}
+
+bool SDLInterface::IsFastForwardHeld()
+{
+    return SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_TAB] != 0;
+}
+
+uint16_t SDLInterface::ReadButtons()
+{
+    // Sampled once per frame, so a movie only has to store the result.
+    const Uint8* keys = SDL_GetKeyboardState(nullptr);
+
+    uint16_t buttons = 0;
+    buttons |= keys[SDL_SCANCODE_UP]     ? JOYPAD_1_UP       : 0;
+    buttons |= keys[SDL_SCANCODE_DOWN]   ? JOYPAD_1_DOWN     : 0;
+    buttons |= keys[SDL_SCANCODE_LEFT]   ? JOYPAD_1_LEFT     : 0;
+    buttons |= keys[SDL_SCANCODE_RIGHT]  ? JOYPAD_1_RIGHT    : 0;
+    buttons |= keys[SDL_SCANCODE_Z]      ? JOYPAD_1_BUTTON_1 : 0;
+    buttons |= keys[SDL_SCANCODE_X]      ? JOYPAD_1_BUTTON_2 : 0;
+    buttons |= keys[SDL_SCANCODE_RETURN] ? BUTTON_PAUSE      : 0;
+    return buttons;
+}
@@ -3,6 +3,7 @@
 #include "ExternalInterface.h"
 #include "SDL.h"
 
+class AudioRing;
 class SDLInterface
 {
 public:
@@ -10,19 +11,30 @@ public:
 
     bool InitWindow(uint32_t window_width, uint32_t window_height, uint32_t game_width, uint32_t game_height);
     void RenderFrame(const byte* const buffer);
+    // Mono 16 bits output pulled from ring by the audio thread. Opened paused, see SetAudioPaused.
+    bool InitAudio(uint32_t sample_rate, AudioRing* ring);
+    void SetAudioPaused(bool paused);
     void Quit();
     bool ExitRequested(const SDL_Event& event);
+    bool SaveStateRequested(const SDL_Event& event);
+    bool LoadStateRequested(const SDL_Event& event);
+    bool IsRewindHeld();
+    bool IsFastForwardHeld();
+    // JoypadButton bits of the keys held: arrows, Z and X for the first controller, Return for pause.
+    uint16_t ReadButtons();
 
     inline SDL_Window* GetWindow() const { return m_window; }
     inline SDL_Renderer* GetRenderer() const { return m_renderer; }
 
 private:
     void InitIcon(const char* ImagePath);
+    static void SDLCALL AudioCallback(void* user_data, Uint8* stream, int length);
 
 private:
     SDL_Window*   m_window   = nullptr;
     SDL_Renderer* m_renderer = nullptr;
     SDL_Texture*  m_texture  = nullptr;
+    SDL_AudioDeviceID m_audio_device = 0;
 
     uint32_t cached_width;
     uint32_t cached_height;
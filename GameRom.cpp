@@ -1,14 +1,28 @@
 #include "GameRom.h"
-#include "FileUtils.h"
+#include "CompressedRom.h"
+#include "Crc32.h"
+#include "RomDatabase.h"
 #include <iostream>
 #include <bitset>
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr long BANK_SIZE          = 0x4000;
+static constexpr long COPIER_HEADER_SIZE = 512; // Some dumps start with the header of the copier they were made with.
 
 GameRom::GameRom(const std::string& path) 
-    : m_rom             (nullptr),
+    : m_path            (path),
+      m_rom_buffer      (nullptr),
+      m_rom             (nullptr),
+      m_size            (0),
+      m_crc32           (0),
       m_region_and_size (0),
       m_type            (MemoryType::None),
-      m_valid           (false)
+      m_video_system    (VideoSystem::Unknown),
+      m_quirks          (0),
+      m_valid           (false),
+      m_num_banks       (0)
 {
     Load(path);
     ReadHeader();
@@ -16,24 +30,75 @@ GameRom::GameRom(const std::string& path)
 
 GameRom::~GameRom()
 {
-    free(m_rom);
+    free(m_rom_buffer);
 }
 
 void GameRom::Load(const std::string& path)
 {
-    FILE* file = fopen(path.c_str(), "r");
-    if (!file)
+    if (!m_file.Open(path))
         return;
-    
-    const long file_size = FileUtils::GetFileSize(file);
-    m_rom = (byte*)calloc(file_size, sizeof(byte));
-    
-    if (m_rom)
+
+    const byte* data = m_file.GetData();
+    long        size = static_cast<long>(m_file.GetSize());
+
+    // Compressed images are decoded straight from the mapped archive into the ROM buffer.
+    if (CompressedRom::IsCompressed(data, size))
+    {
+        CompressedRomInfo info;
+        if (!CompressedRom::Open(data, size, info))
+        {
+            std::cout << "Unsupported or corrupt archive " << path << std::endl;
+            return;
+        }
+
+        m_rom_buffer = (byte*)malloc(RoundUpToBank(static_cast<long>(info.uncompressed_size)));
+        if (!m_rom_buffer || !CompressedRom::Extract(info, m_rom_buffer))
+        {
+            std::cout << "Couldn't decompress " << path << std::endl;
+            return;
+        }
+
+        m_file.Close();
+
+        data = m_rom_buffer;
+        size = static_cast<long>(info.uncompressed_size);
+    }
+
+    if (size % BANK_SIZE == COPIER_HEADER_SIZE)
+    {
+        data += COPIER_HEADER_SIZE;
+        size -= COPIER_HEADER_SIZE;
+    }
+
+    // The bank count is 16 bits wide. Mappers only reach the first 256 banks, but the image is still usable.
+    if (RoundUpToBank(size) / BANK_SIZE > 0xFFFF)
+    {
+        std::cout << "ROM image too large " << path << std::endl;
+        return;
+    }
+
+    // Mappers switch whole 16KB banks, pad the last one so they never read past the image.
+    if (size % BANK_SIZE != 0)
     {
-        fread(m_rom, sizeof(byte), file_size, file);
+        if (!m_rom_buffer)
+        {
+            m_rom_buffer = (byte*)malloc(RoundUpToBank(size));
+            if (!m_rom_buffer)
+                return;
+        }
+
+        memmove(m_rom_buffer, data, size);
+        memset(m_rom_buffer + size, 0xff, RoundUpToBank(size) - size);
+        data = m_rom_buffer;
     }
 
-    fclose(file);
+    m_rom  = data;
+    m_size = size;
+}
+
+long GameRom::RoundUpToBank(long size)
+{
+    return (size + BANK_SIZE - 1) / BANK_SIZE * BANK_SIZE;
 }
 
 void GameRom::ReadHeader()
@@ -41,31 +106,62 @@ void GameRom::ReadHeader()
     if (!m_rom)
         return;
     
+    m_crc32     = Crc32::Compute(m_rom, m_size);
+    m_num_banks = static_cast<uint16_t>(RoundUpToBank(m_size) / BANK_SIZE);
+
     word header_address = 0;
-    const bool header_found = FindHeaderAddress(m_rom, header_address);
-    
-    if (!header_found)
-        return;
+    const bool header_found = FindHeaderAddress(m_rom, m_size, header_address);
     
-    m_region_and_size = m_rom[header_address + 15];
+    if (header_found)
+    {
+        m_region_and_size = m_rom[header_address + 15];
 
-    const byte size = m_region_and_size & 0x0f;
-    if (size >= 0xA && size <= 0xc)
-        m_type = MemoryType::ROMOnly;
-    else
-        m_type = MemoryType::Sega;
-    
-    m_num_banks = static_cast<uint8_t>(GetSize() / 0x4000);
+        const byte size = m_region_and_size & 0x0f;
+
+        // Mappers only ever see the real size, so a short file is still safe to run.
+        const long declared_size = GetSizeInBytes(size);
+        if (declared_size > m_size)
+            std::cout << "ROM header declares " << declared_size << " bytes but the file only has " << m_size << ", the dump is probably truncated." << std::endl;
+
+        if (size >= 0xA && size <= 0xc && m_size <= 3 * BANK_SIZE)
+            m_type = MemoryType::ROMOnly;
+        else
+            m_type = MemoryType::Sega;
+
+        // The header can't tell PAL from NTSC export cartridges, most of them run at 60Hz.
+        m_video_system = VideoSystem::NTSC;
+        m_valid        = true;
+    }
+
+    // Codemasters cartridges add their own header, with or without the Sega one.
+    if (HasCodemastersHeader(m_rom, m_size))
+    {
+        m_type  = MemoryType::Codemasters;
+        m_valid = true;
+    }
 
-    m_valid = true;
+    // Known cartridges override what was guessed, and don't need a header to be valid.
+    if (const RomDatabaseEntry* entry = RomDatabase::Find(m_crc32))
+    {
+        if (entry->mapper != MemoryType::None)
+            m_type = entry->mapper;
+        if (entry->region != VideoSystem::Unknown)
+            m_video_system = entry->region;
+
+        m_quirks = entry->quirks;
+        m_valid  = m_type != MemoryType::None;
+    }
+
+    if (m_valid && m_video_system == VideoSystem::Unknown)
+        m_video_system = VideoSystem::NTSC;
 }
 
-bool GameRom::FindHeaderAddress(byte* rom, word& out_address)
+bool GameRom::FindHeaderAddress(const byte* rom, long rom_size, word& out_address)
 {
     static const word header_addresses[3] = { 0x7ff0, 0x3ff0, 0x1ff0 }; // Ordered by % of success finding them at that location
     for (const int header_address : header_addresses)
     {
-        if (IsHeaderValid(rom, header_address))
+        if (IsHeaderValid(rom, rom_size, header_address))
         {
             out_address = header_address;
             return true;
@@ -74,9 +170,21 @@ bool GameRom::FindHeaderAddress(byte* rom, word& out_address)
     return false;
 }
 
-bool GameRom::IsHeaderValid(byte* rom, word header_address)
+bool GameRom::HasCodemastersHeader(const byte* rom, long rom_size)
 {
-    if (!rom)
+    // 0x7fe6 holds the checksum and 0x7fe8 its complement to 0x10000.
+    if (!rom || rom_size < 0x8000)
+        return false;
+
+    const uint32_t checksum   = rom[0x7fe6] | (rom[0x7fe7] << 8);
+    const uint32_t complement = rom[0x7fe8] | (rom[0x7fe9] << 8);
+
+    return checksum != 0 && checksum + complement == 0x10000;
+}
+
+bool GameRom::IsHeaderValid(const byte* rom, long rom_size, word header_address)
+{
+    if (!rom || header_address + 16 > rom_size)
         return false;
 
     static const std::string tmr_sega = "TMR SEGA";
@@ -91,14 +199,40 @@ bool GameRom::IsHeaderValid(byte* rom, word header_address)
     return true;
 }
 
-uint8_t GameRom::GetNumRomBanks() const
+byte* GameRom::GetCartridgeRam()
+{
+    if (!m_save_file.IsOpen())
+    {
+        const std::string save_path = GetSiblingPath(".sav");
+        if (!m_save_file.OpenWritable(save_path, CARTRIDGE_RAM_SIZE))
+            std::cout << "Couldn't open the save file " << save_path << ", the cartridge RAM won't be available." << std::endl;
+    }
+
+    return m_save_file.GetWritableData();
+}
+
+std::string GameRom::GetSiblingPath(const char* extension) const
+{
+    const size_t dot           = m_path.find_last_of('.');
+    const size_t separator     = m_path.find_last_of("/\\");
+    const bool   has_extension = dot != std::string::npos && (separator == std::string::npos || dot > separator);
+
+    return (has_extension ? m_path.substr(0, dot) : m_path) + extension;
+}
+
+void GameRom::FlushCartridgeRam()
+{
+    m_save_file.FlushAsync();
+}
+
+uint16_t GameRom::GetNumRomBanks() const
 {
     return m_num_banks;
 }
 
 long GameRom::GetSize() const
 {
-    return GetSizeInBytes(m_region_and_size & 0x0f);
+    return m_size;
 }
 
 GameRom::RegionCode GameRom::GetRegionCode() const
@@ -2,6 +2,7 @@
 
 #include <string>
 #include "Types.h"
+#include "MappedFile.h"
 
 /*
     SMS games contains a 16 bytes header with the following structure:
@@ -31,6 +32,23 @@
                                             2 = 1024KB  Unused, buggy
     
     The header can be located at three different addresses: 0x1ff0, 0x3ff0 or 0x7ff0
+
+    Codemasters cartridges have a second header at 0x7fe0 (bank count, build date, checksum and
+    its complement) which selects their mapper.
+
+    The declared size is only the range covered by the checksum, so the file size is what the
+    mappers use. A file shorter than its declared size is reported as a probably truncated dump.
+
+    Region, mapper and quirks of known cartridges come from the ROM database (see RomDatabase.h),
+    looked up with the CRC32 of the image.
+
+    The ROM is mapped read-only from the file (see MappedFile) and the mappers read it in place.
+    Only images that aren't a multiple of 16KB are copied, padded to a whole bank. gzip and zip
+    archives are decoded in memory into the same buffer (see CompressedRom).
+
+    The 32KB battery-backed cartridge RAM is a shared mapping of the save file next to the ROM
+    (same name, .sav extension), created the first time the game maps its RAM. Writes go straight
+    to the page cache; FlushCartridgeRam only schedules them to be written.
 */
 
 enum class MemoryType : byte
@@ -41,6 +59,13 @@ enum class MemoryType : byte
     Codemasters
 };
 
+enum class VideoSystem : byte
+{
+    Unknown = 0,
+    NTSC,
+    PAL
+};
+
 class GameRom
 {
     enum class RegionCode : byte
@@ -58,25 +83,47 @@ public:
 
     long        GetSize        () const;
     RegionCode  GetRegionCode  () const;
-    uint8_t     GetNumRomBanks () const;
+    uint16_t    GetNumRomBanks () const; // Mapper registers only reach the first 256 of a bigger image.
     MemoryType  GetMemoryType  () const { return m_type;  }
+    VideoSystem GetVideoSystem () const { return m_video_system; }
+    uint8_t     GetQuirks      () const { return m_quirks; } // RomQuirk flags (see RomDatabase.h).
+    uint32_t    GetCrc32       () const { return m_crc32; }
     const byte* GetRom         () const { return m_rom;   }
-    byte*       GetRom         ()       { return m_rom;   }
     bool        IsValid        () const { return m_valid; }
 
+    static constexpr uint32_t CARTRIDGE_RAM_SIZE = 0x8000;
+
+    // CARTRIDGE_RAM_SIZE bytes backed by the save file, nullptr if it can't be created.
+    byte*       GetCartridgeRam   ();
+    bool        HasCartridgeRam   () const { return m_save_file.IsOpen(); }
+    void        FlushCartridgeRam ();
+
+    // Path of the ROM with its extension replaced (".sav", ".state").
+    std::string GetSiblingPath(const char* extension) const;
+
 protected:
     void Load(const std::string& path);
     void ReadHeader();
 
 private:
-    byte*      m_rom;
-    byte       m_region_and_size;
-    MemoryType m_type;
-    bool	   m_valid;
-    uint8_t    m_num_banks;
+    std::string m_path;
+    MappedFile  m_file;
+    MappedFile  m_save_file;
+    byte*       m_rom_buffer; // Owned image when it can't be used in place (compressed or not filling its last bank).
+    const byte* m_rom;
+    long        m_size;
+    uint32_t    m_crc32;
+    byte        m_region_and_size;
+    MemoryType  m_type;
+    VideoSystem m_video_system;
+    uint8_t     m_quirks;
+    bool        m_valid;
+    uint16_t    m_num_banks;
 
 protected:
-    static bool    FindHeaderAddress (byte* rom, word& out_address);
-    static bool    IsHeaderValid     (byte* rom, word header_address);
-    static long    GetSizeInBytes    (byte b);
+    static bool    FindHeaderAddress    (const byte* rom, long rom_size, word& out_address);
+    static bool    IsHeaderValid        (const byte* rom, long rom_size, word header_address);
+    static bool    HasCodemastersHeader (const byte* rom, long rom_size);
+    static long    GetSizeInBytes       (byte b);
+    static long    RoundUpToBank        (long size);
 };
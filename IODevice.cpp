@@ -1,78 +1,136 @@
 #include "IODevice.h"
 #include "VDP.h"
+#include "PSG.h"
+#include "YM2413.h"
 
 static constexpr byte STARTING_ADDRESS               = 0x40;
 static constexpr byte MAX_COUNTER_READ_ADDRESS       = 0x7F;
 static constexpr byte MAX_DATA_CONTROL_ADDRESS       = 0xBF;
+static constexpr byte FM_ADDRESS_PORT                = 0xF0;
+static constexpr byte FM_DATA_PORT                   = 0xF1;
+static constexpr byte FM_CONTROL_PORT                = 0xF2;
 
-byte IODevice::Read(byte address)
+// Port 0xDD bits that aren't buttons: cartridge slot CONT and the TH lines of both controllers, all high.
+static constexpr byte JOYPAD_PORT_B_UNUSED_BITS = 0xE0;
+
+IODevice::IODevice(IOState& state) :
+    m_state(state)
 {
-    if (address < STARTING_ADDRESS)
-    {
-        // Do nothing?
-        return 255;
-    }
-    else if (address <= MAX_COUNTER_READ_ADDRESS)
-    {
-        // Even address - VCounter
-        // Odd address - HCounter
-        if (address % 2 == 0)
-        {
-            return m_context.vdp->GetVCounter();
-        }
-        else
-        {
-            return m_context.vdp->GetHCounter();
-        }
-    }
-    else if (address <= MAX_DATA_CONTROL_ADDRESS)
-    {
-        // Even adress = data port
-        // Odd address = control port
-        if (address % 2 == 0)
-        {
-            return m_context.vdp->ReadDataPort();
-        }
-        else
-        {
-            return m_context.vdp->ReadControlPort();
-        }
-    }
+    m_state.buttons = 0;
+    BuildPortTables();
+}
 
-    return 0;
+void IODevice::SetContext(const IODeviceContext& context)
+{
+    m_context = context;
+    BuildPortTables();
 }
 
-void IODevice::Write(byte address, byte data)
+void IODevice::BuildPortTables()
 {
-    if (address < STARTING_ADDRESS)
-    {
-        // Do nothing?
-        return;
-    }
-    else if (address <= MAX_COUNTER_READ_ADDRESS)
+    for (uint32_t address = 0; address < 256; ++address)
     {
-        // Even address - VCounter
-        // Odd address - HCounter
-        if (address % 2 == 0)
+        if (address < STARTING_ADDRESS)
         {
-            // SN76489 data(write)
+            m_read_funcs[address]  = ReadOpenBus;
+            m_write_funcs[address] = WriteIgnored;
         }
-        else
+        else if (address <= MAX_COUNTER_READ_ADDRESS)
         {
-            // SN76489 data(write, mirror)
+            m_read_funcs[address]  = m_context.vdp ? ReadCounters : ReadOpenBus;
+            m_write_funcs[address] = m_context.psg ? WritePSG : WriteIgnored;
         }
-    }
-    else if (address <= MAX_DATA_CONTROL_ADDRESS)
-    {
-        // Even adress = data port
-        // Odd address = control port
-        if (address % 2 == 0)
+        else if (address <= MAX_DATA_CONTROL_ADDRESS)
         {
-            m_context.vdp->WriteDataPort(data);
+            m_read_funcs[address]  = m_context.vdp ? ReadVDP : ReadOpenBus;
+            m_write_funcs[address] = m_context.vdp ? WriteVDP : WriteIgnored;
         }
         else
         {
-            m_context.vdp->WriteControlPort(data);
+            m_read_funcs[address]  = ReadJoypads;
+            m_write_funcs[address] = WriteIgnored;
         }
     }
+
+    // The FM unit decodes its three ports fully, on top of the controller ports.
+    if (m_context.fm)
+    {
+        m_write_funcs[FM_ADDRESS_PORT] = WriteFMAddress;
+        m_write_funcs[FM_DATA_PORT]    = WriteFMData;
+        m_write_funcs[FM_CONTROL_PORT] = WriteFMControl;
+        m_read_funcs[FM_CONTROL_PORT]  = ReadFMControl;
+    }
+}
+
+byte IODevice::ReadOpenBus(IODevice& /*io*/, byte /*address*/)
+{
+    return 255;
+}
+
+byte IODevice::ReadCounters(IODevice& io, byte address)
+{
+    // Even address - VCounter
+    // Odd address - HCounter
+    return (address & 1) == 0 ? io.m_context.vdp->GetVCounter() : io.m_context.vdp->GetHCounter();
+}
+
+byte IODevice::ReadVDP(IODevice& io, byte address)
+{
+    // Even adress = data port
+    // Odd address = control port
+    return (address & 1) == 0 ? io.m_context.vdp->ReadDataPort() : io.m_context.vdp->ReadControlPort();
+}
+
+byte IODevice::ReadJoypads(IODevice& io, byte address)
+{
+    // Buttons are active low.
+    const uint16_t released = static_cast<uint16_t>(~io.m_state.buttons);
+
+    // Even address - port 0xDC: first controller and up/down of the second.
+    // Odd address  - port 0xDD: the rest of the second controller and the reset button.
+    if ((address & 1) == 0)
+        return static_cast<byte>(released);
+    else
+        return static_cast<byte>((released >> 8) & 0x1f) | JOYPAD_PORT_B_UNUSED_BITS;
+}
+
+void IODevice::WriteIgnored(IODevice& /*io*/, byte /*address*/, byte /*data*/)
+{
+}
+
+void IODevice::WritePSG(IODevice& io, byte /*address*/, byte data)
+{
+    // SN76489 data, odd addresses are a mirror.
+    io.m_context.psg->Write(data);
+}
+
+void IODevice::WriteVDP(IODevice& io, byte address, byte data)
+{
+    // Even adress = data port
+    // Odd address = control port
+    if ((address & 1) == 0)
+        io.m_context.vdp->WriteDataPort(data);
+    else
+        io.m_context.vdp->WriteControlPort(data);
+}
+
+byte IODevice::ReadFMControl(IODevice& io, byte address)
+{
+    // Games detect the unit by reading back what they wrote, the upper bits still float with the controller port.
+    return (ReadJoypads(io, address) & 0xF8) | io.m_context.fm->ReadControl();
+}
+
+void IODevice::WriteFMAddress(IODevice& io, byte /*address*/, byte data)
+{
+    io.m_context.fm->WriteAddress(data);
+}
+
+void IODevice::WriteFMData(IODevice& io, byte /*address*/, byte data)
+{
+    io.m_context.fm->WriteData(data);
+}
+
+void IODevice::WriteFMControl(IODevice& io, byte /*address*/, byte data)
+{
+    io.m_context.fm->WriteControl(data);
 }
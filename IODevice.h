@@ -2,27 +2,94 @@
 
 #include "Types.h"
 
+// Controller and console buttons, a set bit means pressed (the ports report them inverted).
+// The first byte is laid out as port 0xDC, the next 5 bits as the low bits of port 0xDD.
+enum JoypadButton : uint16_t
+{
+    JOYPAD_1_UP       = 1 << 0,
+    JOYPAD_1_DOWN     = 1 << 1,
+    JOYPAD_1_LEFT     = 1 << 2,
+    JOYPAD_1_RIGHT    = 1 << 3,
+    JOYPAD_1_BUTTON_1 = 1 << 4,
+    JOYPAD_1_BUTTON_2 = 1 << 5,
+    JOYPAD_2_UP       = 1 << 6,
+    JOYPAD_2_DOWN     = 1 << 7,
+    JOYPAD_2_LEFT     = 1 << 8,
+    JOYPAD_2_RIGHT    = 1 << 9,
+    JOYPAD_2_BUTTON_1 = 1 << 10,
+    JOYPAD_2_BUTTON_2 = 1 << 11,
+    BUTTON_RESET      = 1 << 12,
+    BUTTON_PAUSE      = 1 << 13
+};
+
+// Part of the MachineState arena.
+struct IOState
+{
+    uint16_t buttons; // JoypadButton bits held during the current frame, set once per frame.
+};
+
 class VDP;
+class PSG;
+class YM2413;
 struct IODeviceContext
 {
     IODeviceContext() {}
-    IODeviceContext(VDP* _vdp) : vdp(_vdp) {}
+    IODeviceContext(VDP* _vdp, PSG* _psg, YM2413* _fm = nullptr) : vdp(_vdp), psg(_psg), fm(_fm) {}
 
-    VDP* vdp = nullptr;
+    VDP*    vdp = nullptr;
+    PSG*    psg = nullptr;
+    YM2413* fm  = nullptr; // Optional FM unit, the ports behave as on a console without one when null.
 };
 
+class IODevice;
+using PortReadFunc  = byte(*)(IODevice&, byte address);
+using PortWriteFunc = void(*)(IODevice&, byte address, byte data);
+
+/*
+    The Z80 I/O ports. The chips only decode a few address lines, so each one answers on a
+    whole range of ports:
+        0x00-0x3F  writes: memory control (even), I/O control (odd). Reads float high.
+        0x40-0x7F  reads: V counter (even), H counter (odd). Writes: PSG.
+        0x80-0xBF  VDP data (even) and control (odd) ports.
+        0xC0-0xFF  reads: controller ports 0xDC (even) and 0xDD (odd). Writes are ignored.
+        0xF0-0xF2  with the FM unit: register address, register data and audio control (read/write).
+
+    Rather than decoding the address on every access, a handler per port is looked up once in
+    SetContext, when the devices behind the ports are known, so an access is a single indexed call.
+*/
 class IODevice
 {
 public:
-    IODevice() {}
+    IODevice(IOState& state);
 
 public: // inline
-    inline void SetContext(const IODeviceContext& context) { m_context = context; }
+    inline void     SetButtons (uint16_t buttons) { m_state.buttons = buttons; }
+    inline uint16_t GetButtons () const { return m_state.buttons; }
+
+    inline byte Read  (byte address)            { return m_read_funcs[address](*this, address); }
+    inline void Write (byte address, byte data) { m_write_funcs[address](*this, address, data); }
 
 public:
-    byte Read  (byte address);
-    void Write (byte address, byte data);
+    void SetContext(const IODeviceContext& context);
+
+private:
+    void BuildPortTables();
+
+    static byte ReadOpenBus      (IODevice& io, byte address);
+    static byte ReadCounters     (IODevice& io, byte address);
+    static byte ReadVDP          (IODevice& io, byte address);
+    static byte ReadJoypads      (IODevice& io, byte address);
+    static void WriteIgnored     (IODevice& io, byte address, byte data);
+    static void WritePSG         (IODevice& io, byte address, byte data);
+    static void WriteVDP         (IODevice& io, byte address, byte data);
+    static byte ReadFMControl    (IODevice& io, byte address);
+    static void WriteFMAddress   (IODevice& io, byte address, byte data);
+    static void WriteFMData      (IODevice& io, byte address, byte data);
+    static void WriteFMControl   (IODevice& io, byte address, byte data);
 
 private:
+    IOState&        m_state;
     IODeviceContext m_context;
+    PortReadFunc    m_read_funcs  [256];
+    PortWriteFunc   m_write_funcs [256];
 };
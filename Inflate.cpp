@@ -0,0 +1,300 @@
+#include "Inflate.h"
+#include <string.h>
+
+namespace
+{
+    // Length and distance symbols are a base value plus extra bits (RFC 1951 3.2.5).
+    const uint16_t s_length_base[29]    = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    const uint8_t  s_length_extra[29]   = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    const uint16_t s_distance_base[30]  = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    const uint8_t  s_distance_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // Order the code length code lengths are stored in.
+    const uint8_t  s_code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    constexpr uint32_t END_OF_BLOCK = 256;
+}
+
+bool Inflate::Decompress(const byte* in, size_t in_size, byte* out, size_t out_size, size_t& out_written)
+{
+    BitReader reader = { in, in + in_size, 0, 0, 0 };
+
+    // Rebuilt for every compressed block.
+    Huffman litlen;
+    Huffman distances;
+
+    size_t position = 0;
+    bool   last     = false;
+    bool   ok       = true;
+
+    while (ok && !last)
+    {
+        last = GetBits(reader, 1) != 0;
+
+        switch (GetBits(reader, 2))
+        {
+        case 0: // Stored
+        {
+            // Drop the bits up to the byte boundary, the lengths are byte aligned.
+            GetBits(reader, reader.count & 7);
+
+            const uint32_t length  = GetBits(reader, 16);
+            const uint32_t nlength = GetBits(reader, 16);
+            if (length != (~nlength & 0xffff) || position + length > out_size)
+            {
+                ok = false;
+                break;
+            }
+
+            // Whole bytes still sitting in the bit buffer come first, then the input is copied directly.
+            uint32_t copied = 0;
+            while (copied < length && reader.count >= 8)
+                out[position + copied++] = static_cast<byte>(GetBits(reader, 8));
+
+            const size_t remaining = length - copied;
+            if (remaining > static_cast<size_t>(reader.end - reader.in))
+            {
+                ok = false;
+                break;
+            }
+
+            memcpy(&out[position + copied], reader.in, remaining);
+            reader.in += remaining;
+            position  += length;
+            break;
+        }
+        case 1: // Fixed Huffman codes
+        {
+            uint8_t lengths[MAX_LITLEN + MAX_DISTANCES];
+            memset(&lengths[0],   8, 144);
+            memset(&lengths[144], 9, 112);
+            memset(&lengths[256], 7, 24);
+            memset(&lengths[280], 8, 8);
+            memset(&lengths[MAX_LITLEN], 5, MAX_DISTANCES);
+
+            ok = Build(litlen, lengths, MAX_LITLEN) && Build(distances, &lengths[MAX_LITLEN], MAX_DISTANCES) &&
+                 InflateBlock(reader, litlen, distances, out, out_size, position);
+            break;
+        }
+        case 2: // Dynamic Huffman codes
+            ok = DecodeTables(reader, litlen, distances) && InflateBlock(reader, litlen, distances, out, out_size, position);
+            break;
+        default:
+            ok = false;
+            break;
+        }
+
+        ok = ok && !IsOverrun(reader);
+    }
+
+    out_written = position;
+    return ok;
+}
+
+bool Inflate::Build(Huffman& huffman, const uint8_t* lengths, uint32_t num_symbols)
+{
+    memset(huffman.counts, 0, sizeof(huffman.counts));
+    memset(huffman.fast,   0, sizeof(huffman.fast));
+
+    for (uint32_t symbol = 0; symbol < num_symbols; ++symbol)
+        huffman.counts[lengths[symbol]]++;
+    huffman.counts[0] = 0;
+
+    // Reject over-subscribed sets. Incomplete ones are valid (e.g. a single distance code).
+    int32_t left = 1;
+    for (uint32_t length = 1; length <= MAX_BITS; ++length)
+    {
+        left = (left << 1) - huffman.counts[length];
+        if (left < 0)
+            return false;
+    }
+
+    uint16_t offsets[MAX_BITS + 1];
+    offsets[1] = 0;
+    for (uint32_t length = 1; length < MAX_BITS; ++length)
+        offsets[length + 1] = offsets[length] + huffman.counts[length];
+
+    // Canonical codes: consecutive values within a length, in symbol order.
+    uint32_t next_code[MAX_BITS + 1];
+    uint32_t code = 0;
+    for (uint32_t length = 1; length <= MAX_BITS; ++length)
+    {
+        code = (code + (length > 1 ? huffman.counts[length - 1] : 0)) << 1;
+        next_code[length] = code;
+    }
+
+    for (uint32_t symbol = 0; symbol < num_symbols; ++symbol)
+    {
+        const uint32_t length = lengths[symbol];
+        if (length == 0)
+            continue;
+
+        huffman.symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+
+        const uint32_t symbol_code = next_code[length]++;
+        if (length > FAST_BITS)
+            continue;
+
+        // Codes are stored most significant bit first while the stream is read from the lowest bit.
+        uint32_t reversed = 0;
+        for (uint32_t bit = 0; bit < length; ++bit)
+            reversed |= ((symbol_code >> bit) & 1) << (length - 1 - bit);
+
+        for (uint32_t index = reversed; index < (1u << FAST_BITS); index += 1u << length)
+            huffman.fast[index] = static_cast<uint16_t>((symbol << 4) | length);
+    }
+
+    return true;
+}
+
+int32_t Inflate::DecodeSymbol(BitReader& reader, const Huffman& huffman)
+{
+    if (reader.count < MAX_BITS)
+        Refill(reader);
+
+    const uint16_t entry = huffman.fast[reader.bits & ((1u << FAST_BITS) - 1)];
+    if (entry != 0)
+    {
+        const uint32_t length = entry & 0x0f;
+        reader.bits  >>= length;
+        reader.count  -= length;
+        return entry >> 4;
+    }
+
+    // Canonical decode (see RFC 1951 3.2.2), one bit at a time.
+    int32_t code  = 0;
+    int32_t first = 0;
+    int32_t index = 0;
+    for (uint32_t length = 1; length <= MAX_BITS; ++length)
+    {
+        code |= static_cast<int32_t>(GetBits(reader, 1));
+
+        const int32_t count = huffman.counts[length];
+        if (code - count < first)
+            return huffman.symbols[index + (code - first)];
+
+        index += count;
+        first  = (first + count) << 1;
+        code <<= 1;
+    }
+
+    return -1;
+}
+
+bool Inflate::DecodeTables(BitReader& reader, Huffman& litlen, Huffman& distances)
+{
+    const uint32_t num_litlen     = GetBits(reader, 5) + 257;
+    const uint32_t num_distances  = GetBits(reader, 5) + 1;
+    const uint32_t num_code_codes = GetBits(reader, 4) + 4;
+
+    if (num_litlen > 286 || num_distances > MAX_DISTANCES)
+        return false;
+
+    uint8_t lengths[MAX_LITLEN + MAX_DISTANCES] = {};
+    for (uint32_t i = 0; i < num_code_codes; ++i)
+        lengths[s_code_length_order[i]] = static_cast<uint8_t>(GetBits(reader, 3));
+
+    Huffman code_lengths;
+    if (!Build(code_lengths, lengths, 19))
+        return false;
+
+    // Literal/length and distance code lengths are a single run-length encoded sequence.
+    memset(lengths, 0, sizeof(lengths));
+    uint32_t index = 0;
+    while (index < num_litlen + num_distances)
+    {
+        const int32_t symbol = DecodeSymbol(reader, code_lengths);
+        if (symbol < 0)
+            return false;
+
+        if (symbol < 16)
+        {
+            lengths[index++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t  value;
+        uint32_t repeat;
+        if (symbol == 16)
+        {
+            if (index == 0)
+                return false;
+            value  = lengths[index - 1];
+            repeat = 3 + GetBits(reader, 2);
+        }
+        else if (symbol == 17)
+        {
+            value  = 0;
+            repeat = 3 + GetBits(reader, 3);
+        }
+        else
+        {
+            value  = 0;
+            repeat = 11 + GetBits(reader, 7);
+        }
+
+        if (index + repeat > num_litlen + num_distances)
+            return false;
+
+        while (repeat--)
+            lengths[index++] = value;
+    }
+
+    // A block without end of block code could never finish.
+    if (lengths[END_OF_BLOCK] == 0)
+        return false;
+
+    return Build(litlen, lengths, num_litlen) && Build(distances, &lengths[num_litlen], num_distances);
+}
+
+bool Inflate::InflateBlock(BitReader& reader, const Huffman& litlen, const Huffman& distances, byte* out, size_t out_size, size_t& position)
+{
+    for (;;)
+    {
+        const int32_t symbol = DecodeSymbol(reader, litlen);
+
+        if (symbol < 0)
+            return false;
+
+        if (symbol < static_cast<int32_t>(END_OF_BLOCK))
+        {
+            if (position >= out_size)
+                return false;
+            out[position++] = static_cast<byte>(symbol);
+            continue;
+        }
+
+        if (symbol == static_cast<int32_t>(END_OF_BLOCK))
+            return true;
+
+        const uint32_t length_symbol = symbol - 257;
+        if (length_symbol >= 29)
+            return false;
+
+        const uint32_t length = s_length_base[length_symbol] + GetBits(reader, s_length_extra[length_symbol]);
+
+        const int32_t distance_symbol = DecodeSymbol(reader, distances);
+        if (distance_symbol < 0 || distance_symbol >= static_cast<int32_t>(MAX_DISTANCES))
+            return false;
+
+        const uint32_t distance = s_distance_base[distance_symbol] + GetBits(reader, s_distance_extra[distance_symbol]);
+
+        if (distance > position || length > out_size - position)
+            return false;
+
+        // Matches can overlap their own output (distance < length), so the copy goes forward byte by byte.
+        const byte* source = &out[position - distance];
+        byte*       target = &out[position];
+        if (distance >= length)
+            memcpy(target, source, length);
+        else
+            for (uint32_t i = 0; i < length; ++i)
+                target[i] = source[i];
+
+        position += length;
+
+        // Stop runaway decoding of a truncated stream once the output is full.
+        if (IsOverrun(reader))
+            return false;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+
+/*
+    Raw deflate (RFC 1951) decoder.
+
+    The whole compressed stream is read from memory (usually a mapped file) and decoded straight
+    into the caller's buffer, which must be large enough for the whole output. Both sizes are
+    checked on every access, so a corrupt stream fails instead of reading or writing out of bounds.
+
+    Huffman codes up to FAST_BITS long, which are most of them, are decoded with a single table
+    lookup. Longer codes fall back to the canonical bit by bit decode.
+*/
+class Inflate
+{
+public:
+    // Returns false if the stream is corrupt or the output doesn't fit. out_written is the size decoded so far.
+    static bool Decompress(const byte* in, size_t in_size, byte* out, size_t out_size, size_t& out_written);
+
+private:
+    static constexpr uint32_t MAX_BITS      = 15;
+    static constexpr uint32_t FAST_BITS     = 10;
+    static constexpr uint32_t MAX_LITLEN    = 288;
+    static constexpr uint32_t MAX_DISTANCES = 30;
+
+    struct Huffman
+    {
+        uint16_t fast[1 << FAST_BITS]; // (symbol << 4) | code length, 0 when the code is longer than FAST_BITS.
+        uint16_t counts[MAX_BITS + 1]; // Number of codes of each length.
+        uint16_t symbols[MAX_LITLEN];  // Symbols ordered by code.
+    };
+
+    struct BitReader
+    {
+        const byte* in;
+        const byte* end;
+        uint64_t    bits;
+        uint32_t    count;
+        uint32_t    padding; // Zero bits added past the end of the input, they are the last ones in bits.
+    };
+
+    static bool     Build        (Huffman& huffman, const uint8_t* lengths, uint32_t num_symbols);
+    static int32_t  DecodeSymbol (BitReader& reader, const Huffman& huffman);
+    static bool     DecodeTables (BitReader& reader, Huffman& litlen, Huffman& distances);
+    static bool     InflateBlock (BitReader& reader, const Huffman& litlen, const Huffman& distances, byte* out, size_t out_size, size_t& position);
+
+    static inline void Refill(BitReader& reader)
+    {
+        while (reader.count <= 56)
+        {
+            // Zeros are fed past the end of the input, IsOverrun tells if any of them was consumed.
+            const byte data = reader.in != reader.end ? *reader.in++ : (reader.padding += 8, 0);
+            reader.bits  |= static_cast<uint64_t>(data) << reader.count;
+            reader.count += 8;
+        }
+    }
+
+    static inline bool IsOverrun(const BitReader& reader) { return reader.count < reader.padding; }
+
+    static inline uint32_t GetBits(BitReader& reader, uint32_t num_bits)
+    {
+        if (reader.count < num_bits)
+            Refill(reader);
+
+        const uint32_t value = static_cast<uint32_t>(reader.bits & ((1ull << num_bits) - 1));
+        reader.bits  >>= num_bits;
+        reader.count  -= num_bits;
+        return value;
+    }
+};
@@ -0,0 +1,41 @@
+#include "MachineState.h"
+#include <assert.h>
+
+MachineStatePool::MachineStatePool(uint32_t states_per_block) :
+    m_states_per_block (states_per_block)
+{
+    assert(m_states_per_block > 0 && "A pool block must hold at least one state");
+}
+
+MachineStatePool::~MachineStatePool()
+{
+    assert(m_free_states.size() == GetNumAllocated() && "Machine states still in use");
+
+    for (MachineState* block : m_blocks)
+        delete[] block;
+}
+
+MachineState* MachineStatePool::Acquire()
+{
+    if (m_free_states.empty())
+    {
+        // The array new honours the 64 bytes alignment of MachineState. Value initialised so the
+        // padding is zero and two equal states hash the same.
+        MachineState* block = new MachineState[m_states_per_block]();
+        m_blocks.push_back(block);
+
+        // Handed out from the start of the block.
+        for (uint32_t i = m_states_per_block; i > 0; --i)
+            m_free_states.push_back(&block[i - 1]);
+    }
+
+    MachineState* state = m_free_states.back();
+    m_free_states.pop_back();
+    return state;
+}
+
+void MachineStatePool::Release(MachineState* state)
+{
+    assert(state != nullptr && "Releasing a null machine state");
+    m_free_states.push_back(state);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Types.h"
+#include "Z80.h"
+#include "VDP.h"
+#include "Memory.h"
+#include "IODevice.h"
+#include "PSG.h"
+#include "YM2413.h"
+#include <type_traits>
+#include <vector>
+
+/*
+    Every mutable part of the emulated console in one fixed layout block.
+
+    The components (Z80, VDP, Memory, IODevice, PSG, YM2413) only hold a reference to their section, so copying a
+    MachineState is a full snapshot. Pointers derived from the state (the memory page table)
+    stay out of it and are rebuilt with Memory::RefreshMapping after a copy.
+    Each section starts on its own cache line so the CPU registers don't share a line with
+    the VDP counters that are written every line.
+
+    Not included: the cartridge ROM (read only), the battery-backed cartridge RAM (mapped from
+    the save file, see GameRom::GetCartridgeRam), the frame buffer (output of the VDP) and the
+    audio samples (output of the PSG and the FM unit).
+*/
+struct alignas(64) MachineState
+{
+    alignas(64) Z80State    cpu;
+    alignas(64) VDPState    vdp;
+    alignas(64) MemoryState memory;
+    alignas(64) IOState     io;
+    alignas(64) PSGState    psg;
+    alignas(64) YM2413State fm;
+};
+
+static_assert(std::is_trivially_copyable<MachineState>::value, "The machine state is copied with memcpy");
+static_assert(std::is_standard_layout<MachineState>::value,    "The machine state must have a fixed layout");
+
+/*
+    Hands out MachineStates from contiguous blocks, for hosting many consoles without
+    a heap allocation per instance. Released states are reused before a new block is allocated.
+*/
+class MachineStatePool
+{
+public:
+    MachineStatePool(uint32_t states_per_block);
+    ~MachineStatePool();
+
+    MachineStatePool(const MachineStatePool&) = delete;
+    MachineStatePool& operator=(const MachineStatePool&) = delete;
+
+    MachineState* Acquire ();
+    void          Release (MachineState* state);
+
+    uint32_t GetNumAllocated() const { return static_cast<uint32_t>(m_blocks.size()) * m_states_per_block; }
+
+private:
+    uint32_t                   m_states_per_block;
+    std::vector<MachineState*> m_blocks;
+    std::vector<MachineState*> m_free_states;
+};
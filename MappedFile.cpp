@@ -0,0 +1,215 @@
+#include "MappedFile.h"
+#include "FileUtils.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_data           (nullptr),
+      m_size           (0),
+      m_mapped         (false),
+      m_writable       (false)
+#ifdef _WIN32
+    , m_file_handle    (INVALID_HANDLE_VALUE),
+      m_mapping_handle (nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    return Map(path, 0) || Read(path, 0);
+}
+
+bool MappedFile::OpenWritable(const std::string& path, size_t size)
+{
+    Close();
+
+    if (size == 0)
+        return false;
+
+    m_writable = true;
+    if (Map(path, size) || Read(path, size))
+        return true;
+
+    m_writable = false;
+    return false;
+}
+
+void MappedFile::FlushAsync()
+{
+    if (!m_mapped || !m_writable)
+        return;
+
+#ifdef _WIN32
+    // Queues the dirty pages, FlushFileBuffers would be the blocking part.
+    FlushViewOfFile(m_data, 0);
+#else
+    msync(const_cast<byte*>(m_data), m_size, MS_ASYNC);
+#endif
+}
+
+void MappedFile::Close()
+{
+    if (m_mapped)
+    {
+#ifdef _WIN32
+        if (m_writable)
+        {
+            FlushViewOfFile(m_data, 0);
+            FlushFileBuffers(m_file_handle);
+        }
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping_handle);
+        CloseHandle(m_file_handle);
+        m_file_handle    = INVALID_HANDLE_VALUE;
+        m_mapping_handle = nullptr;
+#else
+        if (m_writable)
+            msync(const_cast<byte*>(m_data), m_size, MS_SYNC);
+        munmap(const_cast<byte*>(m_data), m_size);
+#endif
+    }
+    else if (m_data)
+    {
+        if (m_writable)
+        {
+            FILE* file = fopen(m_path.c_str(), "wb");
+            if (file)
+            {
+                fwrite(m_data, sizeof(byte), m_size, file);
+                fclose(file);
+            }
+        }
+
+        free(const_cast<byte*>(m_data));
+    }
+
+    m_data     = nullptr;
+    m_size     = 0;
+    m_mapped   = false;
+    m_writable = false;
+    m_path.clear();
+}
+
+#ifdef _WIN32
+bool MappedFile::Map(const std::string& path, size_t writable_size)
+{
+    const DWORD access      = writable_size ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    const DWORD disposition = writable_size ? OPEN_ALWAYS : OPEN_EXISTING;
+
+    m_file_handle = CreateFileA(path.c_str(), access, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file_handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(m_file_handle, &file_size))
+    {
+        // A writable mapping grows the file to its size.
+        const size_t size = writable_size ? writable_size : static_cast<size_t>(file_size.QuadPart);
+
+        m_mapping_handle = size ? CreateFileMappingA(m_file_handle, nullptr, writable_size ? PAGE_READWRITE : PAGE_READONLY,
+                                                     static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), nullptr) : nullptr;
+        if (m_mapping_handle)
+        {
+            m_data = static_cast<const byte*>(MapViewOfFile(m_mapping_handle, writable_size ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+            if (m_data)
+            {
+                m_size   = size;
+                m_mapped = true;
+                return true;
+            }
+
+            CloseHandle(m_mapping_handle);
+            m_mapping_handle = nullptr;
+        }
+    }
+
+    CloseHandle(m_file_handle);
+    m_file_handle = INVALID_HANDLE_VALUE;
+    return false;
+}
+#else
+bool MappedFile::Map(const std::string& path, size_t writable_size)
+{
+    const int fd = writable_size ? open(path.c_str(), O_RDWR | O_CREAT, 0644) : open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat file_stat;
+    void* data = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &file_stat) == 0)
+    {
+        size = writable_size ? writable_size : static_cast<size_t>(file_stat.st_size);
+
+        // A writable mapping grows the file to its size, the new bytes read as 0.
+        const bool sized = !writable_size || static_cast<size_t>(file_stat.st_size) >= writable_size || ftruncate(fd, static_cast<off_t>(writable_size)) == 0;
+        if (sized && size > 0)
+            data = mmap(nullptr, size, writable_size ? PROT_READ | PROT_WRITE : PROT_READ, writable_size ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data   = static_cast<const byte*>(data);
+    m_size   = size;
+    m_mapped = true;
+    return true;
+}
+#endif
+
+bool MappedFile::Read(const std::string& path, size_t writable_size)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+
+    const long file_size = file ? FileUtils::GetFileSize(file) : 0;
+    if (!file && !writable_size)
+        return false;
+
+    // A writable buffer always has the requested size, whatever the file holds.
+    const size_t size   = writable_size ? writable_size : static_cast<size_t>(file_size);
+    byte*        buffer = size > 0 ? (byte*)calloc(size, sizeof(byte)) : nullptr;
+
+    if (buffer && file)
+    {
+        const size_t to_read = static_cast<size_t>(file_size) < size ? static_cast<size_t>(file_size) : size;
+        if (fread(buffer, sizeof(byte), to_read, file) != to_read)
+        {
+            free(buffer);
+            buffer = nullptr;
+        }
+    }
+
+    if (file)
+        fclose(file);
+
+    if (!buffer)
+        return false;
+
+    m_data = buffer;
+    m_size = size;
+    if (writable_size)
+        m_path = path;
+    return true;
+}
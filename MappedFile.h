@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <stddef.h>
+#include "Types.h"
+
+/*
+    View of a whole file.
+
+    The file is mapped in memory (CreateFileMapping on Windows, mmap elsewhere) so pages are only
+    loaded when they are touched and are shared with the OS file cache. If the file can't be mapped
+    it is read into a heap buffer instead, callers see the same interface either way.
+
+    Open maps the file read-only. OpenWritable creates or grows the file to the given size and maps
+    it shared, so writes to the data land in the file. FlushAsync only asks the OS to start writing
+    the dirty pages and never waits for the disk. Close waits for them. Without a mapping the buffer
+    is written back on Close only.
+*/
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open         (const std::string& path);
+    bool OpenWritable (const std::string& path, size_t size);
+    void FlushAsync   ();
+    void Close        ();
+
+    const byte* GetData         () const { return m_data; }
+    byte*       GetWritableData ()       { return m_writable ? const_cast<byte*>(m_data) : nullptr; }
+    size_t      GetSize         () const { return m_size; }
+    bool        IsMapped        () const { return m_mapped; }
+    bool        IsOpen          () const { return m_data != nullptr; }
+
+private:
+    bool Map  (const std::string& path, size_t writable_size);
+    bool Read (const std::string& path, size_t writable_size);
+
+private:
+    const byte* m_data;
+    size_t      m_size;
+    bool        m_mapped;
+    bool        m_writable;
+    std::string m_path; // Where a writable heap buffer is written back.
+#ifdef _WIN32
+    void*       m_file_handle;
+    void*       m_mapping_handle;
+#endif
+};
@@ -8,57 +8,238 @@
 #include "MemoryMappings/MemoryMapping.h"
 #include "MemoryMappings/SegaMM.h"
 #include "MemoryMappings/ROMOnlyMM.h"
+#include "MemoryMappings/CodemastersMM.h"
 #include "MemoryMappings/TestMM.h"
+#include "MemoryMappings/WatchpointMM.h"
 
-Memory::Memory() : m_memory_mapping(nullptr)
+static_assert(sizeof(MemoryState::work_ram) == Memory::WORK_RAM_SIZE, "Work RAM size mismatch");
+
+Memory::Memory(MemoryState& state) :
+    m_state          (state),
+    m_memory         (nullptr),
+    m_memory_mapping (nullptr),
+    m_watching       (false),
+    m_shared_state         (nullptr),
+    m_shared_work_ram      (0),
+    m_shared_cartridge_ram (false),
+    m_forked               (false),
+    m_forked_save_source   (nullptr),
+    m_forked_save_ram      (nullptr)
 {
-    m_memory = (byte*) calloc(0x10000 - 1, sizeof(byte));
+    memset(m_open_bus, 0xff, sizeof(m_open_bus));
+
+    // The RAM is cleared when a ROM is loaded, nothing can reach it before.
+    ClearMapping();
 }
 
 Memory::~Memory()
 {
+    SetWatchpoints(nullptr);
+    delete m_memory_mapping;
     free(m_memory);
+    delete[] m_forked_save_ram;
 }
 
-byte Memory::ReadMemory(const word& address) const
+byte Memory::ReadWatched(word address) const
 {
-    if (address < 0x0400)
-        return m_memory[address];
-
-    assert(m_memory != nullptr && "m_memory must not be null");
     return m_memory_mapping->ReadMemory(address);
 }
 
 void Memory::WriteMemory(const word& address, byte data)
 {
-    assert(m_memory != nullptr && "m_memory must not be null");
+    assert(m_memory_mapping != nullptr && "No game loaded");
     m_memory_mapping->WriteMemory(address, data);
 }
 
+byte Memory::PeekMemory(word address) const
+{
+    return m_memory_mapping ? m_memory_mapping->PeekMemory(address) : ReadMapped(address);
+}
+
+int32_t Memory::GetRomOffset(word address) const
+{
+    return m_memory_mapping ? m_memory_mapping->GetRomOffset(address) : -1;
+}
+
+void Memory::SetWatchpoints(Debugger* debugger)
+{
+    WatchpointMM* watchpoint_mapping = dynamic_cast<WatchpointMM*>(m_memory_mapping);
+
+    if (debugger && !watchpoint_mapping && m_memory_mapping)
+    {
+        m_memory_mapping = new WatchpointMM(*this, m_memory_mapping->GetCartridge(), m_memory_mapping, debugger);
+        m_watching       = true;
+    }
+    else if (!debugger && watchpoint_mapping)
+    {
+        m_memory_mapping = watchpoint_mapping->GetWrappedMapping();
+        m_watching       = false;
+        delete watchpoint_mapping;
+    }
+}
+
+void Memory::MapRead(word address, uint32_t size, const byte* source)
+{
+    assert((address & (PAGE_SIZE - 1)) == 0 && (size & (PAGE_SIZE - 1)) == 0 && "Mappings must use whole pages");
+    assert(address + size <= 0x10000 && "Mapping out of bounds");
+
+    for (uint32_t offset = 0; offset < size; offset += PAGE_SIZE)
+        m_read_pages[(address + offset) >> PAGE_SHIFT] = source ? source + offset : m_open_bus;
+}
+
 void Memory::LoadRom(GameRom& game_rom)
 {
+    SetWatchpoints(nullptr);
     Reset();
 
-    const long rom_size = game_rom.GetSize();
-    memcpy(m_memory, game_rom.GetRom(), rom_size < 0xc000 ? rom_size : 0xc000);
+    MapWorkRam();
+    CreateMapping(game_rom);
+}
+
+void Memory::LoadSharedRom(GameRom& game_rom, const MemoryState& source, const byte* cartridge_ram)
+{
+    SetWatchpoints(nullptr);
+    ClearMapping();
+
+    // Nothing is cleared or copied but the mapper registers.
+    m_shared_state         = &source;
+    m_shared_work_ram      = (1 << (WORK_RAM_SIZE >> PAGE_SHIFT)) - 1;
+    m_shared_cartridge_ram = true;
+    m_forked               = true;
+    m_forked_save_source   = cartridge_ram;
+
+    CreateMapping(game_rom);
 
+    m_state.mapper = source.mapper;
+    RefreshMapping();
+}
+
+void Memory::CreateMapping(GameRom& game_rom)
+{
+    // The mapping points the ROM pages into the cartridge image, nothing is copied.
     switch (game_rom.GetMemoryType())
     {
-    case MemoryType::Sega:        m_memory_mapping = new SegaMM(*this, game_rom);    break;
-    case MemoryType::ROMOnly:     m_memory_mapping = new ROMOnlyMM(*this, game_rom); break;
-    case MemoryType::Codemasters: m_memory_mapping = nullptr;                        break;
+    case MemoryType::Sega:        m_memory_mapping = new SegaMM(*this, game_rom);        break;
+    case MemoryType::ROMOnly:     m_memory_mapping = new ROMOnlyMM(*this, game_rom);     break;
+    case MemoryType::Codemasters: m_memory_mapping = new CodemastersMM(*this, game_rom); break;
     default: break;
     }
 }
 
 void Memory::Reset()
 {
-    free(m_memory);
-    m_memory = (byte*)calloc(0x10000 - 1, sizeof(byte));
+    ClearMapping();
+
+    if (m_memory)
+        memset(m_memory, 0, 0x10000);
+    memset(&m_state, 0, sizeof(m_state));
+}
+
+void Memory::ClearMapping()
+{
+    delete m_memory_mapping;
+    m_memory_mapping = nullptr;
+
+    m_shared_state         = nullptr;
+    m_shared_work_ram      = 0;
+    m_shared_cartridge_ram = false;
+    m_forked               = false;
+    m_forked_save_source   = nullptr;
+    delete[] m_forked_save_ram;
+    m_forked_save_ram      = nullptr;
+
+    // Until a mapping says otherwise the whole address space reads the internal memory, open bus
+    // when there is none (only the test mapping uses it, a console doesn't pay for 64KB it never reads).
+    MapRead(0x0000, 0x10000, m_memory);
+}
+
+void Memory::RefreshMapping()
+{
+    if (!m_memory_mapping)
+        return;
+
+    MapWorkRam();
+    m_memory_mapping->RefreshMapping();
+}
+
+void Memory::MapWorkRam()
+{
+    for (uint32_t page = 0; page < WORK_RAM_SIZE >> PAGE_SHIFT; ++page)
+    {
+        const bool  shared = (m_shared_work_ram & (1 << page)) != 0;
+        const byte* source = (shared ? m_shared_state->work_ram : m_state.work_ram) + (page << PAGE_SHIFT);
+
+        MapRead(0xc000 + (page << PAGE_SHIFT), PAGE_SIZE, source);
+        MapRead(0xe000 + (page << PAGE_SHIFT), PAGE_SIZE, source);
+    }
+}
+
+void Memory::UnshareWorkRamPage(uint32_t page)
+{
+    const uint32_t offset = page << PAGE_SHIFT;
+    memcpy(&m_state.work_ram[offset], &m_shared_state->work_ram[offset], PAGE_SIZE);
+    m_shared_work_ram &= ~(1 << page);
+
+    MapRead(0xc000 + offset, PAGE_SIZE, &m_state.work_ram[offset]);
+    MapRead(0xe000 + offset, PAGE_SIZE, &m_state.work_ram[offset]);
+}
+
+void Memory::UnshareState()
+{
+    for (uint32_t page = 0; page < WORK_RAM_SIZE >> PAGE_SHIFT; ++page)
+    {
+        if (m_shared_work_ram & (1 << page))
+            UnshareWorkRamPage(page);
+    }
+
+    GetOwnCartridgeRam();
+}
+
+byte* Memory::GetOwnCartridgeRam()
+{
+    if (m_shared_cartridge_ram)
+    {
+        memcpy(m_state.cartridge_ram, m_shared_state->cartridge_ram, sizeof(m_state.cartridge_ram));
+        m_shared_cartridge_ram = false;
+    }
+
+    return m_state.cartridge_ram;
+}
+
+byte* Memory::GetCartridgeRam()
+{
+    if (!m_forked)
+        return m_memory_mapping ? m_memory_mapping->GetCartridge().GetCartridgeRam() : nullptr;
+
+    if (!m_forked_save_ram)
+    {
+        // The source hadn't opened its save file when it was forked, so the file still held what it would have read.
+        const byte* source = m_forked_save_source ? m_forked_save_source : m_memory_mapping->GetCartridge().GetCartridgeRam();
+
+        m_forked_save_ram = new byte[GameRom::CARTRIDGE_RAM_SIZE];
+        if (source)
+            memcpy(m_forked_save_ram, source, GameRom::CARTRIDGE_RAM_SIZE);
+        else
+            memset(m_forked_save_ram, 0, GameRom::CARTRIDGE_RAM_SIZE);
+    }
+
+    return m_forked_save_ram;
+}
+
+bool Memory::HasCartridgeRam() const
+{
+    if (m_forked)
+        return m_forked_save_ram || m_forked_save_source || m_memory_mapping->GetCartridge().HasCartridgeRam();
+
+    return m_memory_mapping && m_memory_mapping->GetCartridge().HasCartridgeRam();
 }
 
 void Memory::LoadTest()
 {
+    SetWatchpoints(nullptr);
+
+    if (!m_memory)
+        m_memory = (byte*)calloc(0x10000, sizeof(byte));
     Reset();
 
     GameRom Rom ("Test");
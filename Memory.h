@@ -39,28 +39,135 @@ Memory mapping:
     0xffff
             Page 2 ROM
     0x10000
+
+    Reads go through a table of 1KB pages pointing straight into the cartridge ROM (mapped from the
+    file), the cartridge RAM or the console RAM, so bank switching just repoints a few pages.
+    The mappings keep the table up to date with MapRead.
+
+    The 8KB work RAM is a single buffer: both 0xc000 and 0xe000 read pages point to it and writes
+    mask the address with WORK_RAM_MASK, so the mirror never has to be kept in sync.
+
+    The RAM and the mapper registers live in a MemoryState inside the MachineState arena. The page
+    table only caches pointers derived from it, RefreshMapping rebuilds it after the state is copied in.
+
+    A forked console (see SMS::Fork, LoadSharedRom) starts with its RAM shared: the work RAM pages read straight
+    from the state it was forked from and a page is only copied into its own state on the first
+    write. The Codemasters cartridge RAM is copied whole the first time it is mapped, and the save
+    file RAM gets a private copy on first use so forks never write the parent's .sav.
 */
 
+// Bank registers of the cartridge mapper, the mappings keep them here so they are part of the machine state.
+struct MapperState
+{
+    uint8_t rom_banks[3]; // ROM bank mapped in each 16KB slot.
+    bool    cartridge_ram_mapped;
+    uint8_t cartridge_ram_page; // Sega: 0xfffc bit 2.
+};
+
+struct MemoryState
+{
+    byte        work_ram[0x2000]; // 0xc000 - 0xdfff, mirrored at 0xe000 - 0xffff.
+    byte        cartridge_ram[0x2000]; // On-cartridge RAM of mappers without a save file (Codemasters).
+    MapperState mapper;
+};
+
 class GameRom;
 class MemoryMapping;
+class Debugger;
 class Memory
 {
 public:
-    Memory();
+    static constexpr uint32_t PAGE_SHIFT = 10;
+    static constexpr uint32_t PAGE_SIZE  = 1 << PAGE_SHIFT;
+    static constexpr uint32_t NUM_PAGES  = 0x10000 >> PAGE_SHIFT;
+
+    static constexpr uint32_t WORK_RAM_SIZE = 0x2000;
+    static constexpr uint32_t WORK_RAM_MASK = WORK_RAM_SIZE - 1;
+
+public:
+    Memory(MemoryState& state);
     ~Memory();
 
-    byte ReadMemory  (const word& address) const;
+    inline byte ReadMemory (const word& address) const
+    {
+        if (m_watching)
+            return ReadWatched(address);
+
+        return ReadMapped(address);
+    }
+
+    // Value currently mapped at address, without going through the mapping.
+    inline byte ReadMapped (word address) const { return m_read_pages[address >> PAGE_SHIFT][address & (PAGE_SIZE - 1)]; }
+
     void WriteMemory (const word& address, byte value);
+    byte PeekMemory  (word address) const; // Read for the debugger views, never triggers watchpoints.
     void LoadRom	 (GameRom& game_rom);
     void Reset       ();
+
+    // Work RAM goes through here so pages still shared with a fork source are copied first.
+    inline void WriteWorkRam(word address, byte data)
+    {
+        const word offset = address & WORK_RAM_MASK;
+        if (m_shared_work_ram & (1 << (offset >> PAGE_SHIFT)))
+            UnshareWorkRamPage(offset >> PAGE_SHIFT);
+
+        m_state.work_ram[offset] = data;
+    }
+
+    // LoadRom for a fork: the mapper registers are copied from source and the RAM is read from it
+    // until written. cartridge_ram is the save file RAM of the source, nullptr if it wasn't opened.
+    void LoadSharedRom (GameRom& game_rom, const MemoryState& source, const byte* cartridge_ram);
+    // Copies everything still shared, the MemoryState is then complete on its own.
+    void UnshareState  ();
+    // Codemasters cartridge RAM, copied from the fork source if needed before it is mapped or written.
+    byte* GetOwnCartridgeRam();
+
+    // Battery-backed cartridge RAM: the save file, or the private copy of a forked console.
+    byte* GetCartridgeRam ();
+    bool  HasCartridgeRam () const;
+
+    // Rebuilds the page table from the state, needed after the state has been overwritten.
+    void RefreshMapping();
+
+    // Offset in the cartridge ROM mapped at address, -1 if it is RAM or nothing is mapped.
+    int32_t GetRomOffset(word address) const;
+
+    // Routes every access through the debugger while it has watchpoints. nullptr restores the normal path.
+    void SetWatchpoints(Debugger* debugger);
+
+    // Used by the mappings: reads in [address, address + size) come from source, nullptr maps open bus (0xFF).
+    // address and size must be multiples of PAGE_SIZE.
+    void MapRead(word address, uint32_t size, const byte* source);
     
     const byte* GetMemory() const { return m_memory; }
     byte*		GetMemory()       { return m_memory; }
 
+    const MemoryState& GetState() const { return m_state; }
+    MemoryState&       GetState()       { return m_state; }
+
 public:
     void LoadTest();
 
 private:
-    byte* m_memory; // Map of the whole memory.
+    byte ReadWatched        (word address) const;
+    void ClearMapping       ();
+    void CreateMapping      (GameRom& game_rom);
+    void MapWorkRam         ();
+    void UnshareWorkRamPage (uint32_t page);
+
+private:
+    MemoryState& m_state;
+    byte* m_memory; // Map of the whole memory, only allocated for the test mapping.
     MemoryMapping* m_memory_mapping;
+    const byte* m_read_pages[NUM_PAGES];
+    byte  m_open_bus[PAGE_SIZE];
+    bool  m_watching; // Reads go through the watchpoint mapping instead of the page table.
+
+    // Fork sharing, see LoadSharedRom.
+    const MemoryState* m_shared_state;
+    uint8_t            m_shared_work_ram;      // Bit per 1KB page of work RAM still read from m_shared_state.
+    bool               m_shared_cartridge_ram;
+    bool               m_forked;               // The save file belongs to the console forked from.
+    const byte*        m_forked_save_source;   // Its save RAM when forked, nullptr if it had none.
+    byte*              m_forked_save_ram;      // Private copy, allocated on first use.
 };
@@ -0,0 +1,83 @@
+#include "CodemastersMM.h"
+#include <assert.h>
+#include "Types.h"
+
+CodemastersMM::CodemastersMM(Memory& owner, GameRom& game_rom)
+    : MemoryMapping(owner, game_rom)
+{
+    // The cartridge starts with banks 0, 1 and 0.
+    m_mapper = { { 0, 1, 0 }, false, 0 };
+    RefreshMapping();
+}
+
+CodemastersMM::~CodemastersMM()
+{
+}
+
+byte CodemastersMM::ReadMemory(word address)
+{
+    assert(address >= 0x0000 && address < 0x10000 && "Trying to write memory out of bounds");
+
+    return m_owner.ReadMapped(address);
+}
+
+void CodemastersMM::WriteMemory(word address, byte data)
+{
+    assert(address >= 0x0000 && address < 0x10000 && "Trying to write memory out of bounds");
+
+    if (address < 0xc000)
+    {
+        // Bank registers sit at the start of each slot, the rest of the ROM ignores writes.
+        if (address == 0x0000)
+            MapRomBank(0, data);
+        else if (address == 0x4000)
+        {
+            m_mapper.cartridge_ram_mapped = (data & (1 << 7)) != 0;
+            MapRomBank(1, data & 0x7f);
+            MapSlot2();
+        }
+        else if (address == 0x8000)
+            MapRomBank(2, data);
+        else if (address >= 0xa000 && m_mapper.cartridge_ram_mapped)
+            m_owner.GetOwnCartridgeRam()[address & 0x1fff] = data;
+
+        return;
+    }
+
+    // 0xe000 mirrors the work RAM.
+    m_owner.WriteWorkRam(address, data);
+}
+
+int32_t CodemastersMM::GetRomOffset(word address) const
+{
+    const uint8_t slot = address >> 14;
+    if (slot > 2 || (address >= 0xa000 && address < 0xc000 && m_mapper.cartridge_ram_mapped))
+        return -1;
+
+    return m_mapper.rom_banks[slot] * 0x4000 + (address & 0x3fff);
+}
+
+void CodemastersMM::RefreshMapping()
+{
+    for (uint8_t slot = 0; slot < 3; ++slot)
+        MapRomBank(slot, m_mapper.rom_banks[slot]);
+}
+
+void CodemastersMM::MapRomBank(uint8_t slot, byte data)
+{
+    m_mapper.rom_banks[slot] = data % m_cartridge->GetNumRomBanks();
+
+    if (slot == 2)
+        MapSlot2();
+    else
+        m_owner.MapRead(slot * 0x4000, 0x4000, &m_cartridge->GetRom()[m_mapper.rom_banks[slot] * 0x4000]);
+}
+
+void CodemastersMM::MapSlot2()
+{
+    const byte* bank = &m_cartridge->GetRom()[m_mapper.rom_banks[2] * 0x4000];
+
+    // The cartridge RAM only covers the upper 8KB of the slot.
+    m_owner.MapRead(0x8000, 0x2000, bank);
+    m_owner.MapRead(0xa000, 0x2000, m_mapper.cartridge_ram_mapped ? m_owner.GetOwnCartridgeRam() : bank + 0x2000);
+}
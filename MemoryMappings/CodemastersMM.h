@@ -0,0 +1,27 @@
+#pragma once
+
+#include "MemoryMapping.h"
+
+/*
+    Codemasters mapper.
+
+    Each 16KB slot has its bank register in its first address (0x0000, 0x4000 and 0x8000), there
+    is no fixed first KB and the console RAM has no registers at its end. Setting bit 7 of the
+    0x4000 register maps 8KB of on-cartridge RAM at 0xA000 (Ernie Els Golf), kept in the memory state.
+*/
+class CodemastersMM : public MemoryMapping
+{
+public:
+    CodemastersMM(Memory& owner, GameRom& game_rom);
+    ~CodemastersMM();
+
+    byte  ReadMemory  (word address)            override;
+    void  WriteMemory (word address, byte data) override;
+
+    void    RefreshMapping()                   override;
+    int32_t GetRomOffset(word address) const override;
+
+private:
+    void MapRomBank (uint8_t slot, byte data);
+    void MapSlot2   ();
+};
@@ -8,13 +8,30 @@ class MemoryMapping
 {
 public:
     MemoryMapping(Memory& owner, GameRom& game_rom)
-        : m_internal_memory (owner.GetMemory())
+        : m_owner           (owner)
+        , m_internal_memory (owner.GetMemory())
+        , m_mapper          (owner.GetState().mapper)
         , m_cartridge       (&game_rom)
     {}
+    virtual ~MemoryMapping() {}
+
     virtual byte  ReadMemory  (word address) = 0;
     virtual void  WriteMemory (word address, byte data) = 0;
 
+    // Points the pages back to what the registers in the mapper state select.
+    virtual void  RefreshMapping() {}
+
+    // Reads without side effects (debugger views).
+    virtual byte  PeekMemory  (word address) const { return m_owner.ReadMapped(address); }
+
+    // Offset in the cartridge ROM currently mapped at address, or -1 if it isn't ROM.
+    virtual int32_t GetRomOffset(word address) const { return address < 0xc000 ? address : -1; }
+
+    GameRom& GetCartridge() const { return *m_cartridge; }
+
 protected:
+    Memory& m_owner;
     byte* m_internal_memory;
+    MapperState& m_mapper;
     GameRom* m_cartridge;
 };
@@ -3,6 +3,12 @@
 
 ROMOnlyMM::ROMOnlyMM(Memory& owner, GameRom& game_rom) : MemoryMapping(owner, game_rom)
 {
+    // Up to 48KB of ROM in place from 0x0000, nothing answers past the end of the cartridge.
+    for (uint8_t bank = 0; bank < 3; ++bank)
+    {
+        const byte* source = bank < game_rom.GetNumRomBanks() ? &game_rom.GetRom()[bank * 0x4000] : nullptr;
+        m_owner.MapRead(bank * 0x4000, 0x4000, source);
+    }
 }
 
 ROMOnlyMM::~ROMOnlyMM()
@@ -13,7 +19,7 @@ byte ROMOnlyMM::ReadMemory(word address)
 {
     assert(address >= 0x0000 && address < 0x10000 && "Trying to write memory out of bounds");
 
-    return m_internal_memory[address];
+    return m_owner.ReadMapped(address);
 }
 
 void ROMOnlyMM::WriteMemory(word address, byte data)
@@ -24,12 +30,6 @@ void ROMOnlyMM::WriteMemory(word address, byte data)
     if (address < 0xc000)
         return;
 
-    // Mirror RAM data
-    if (address < 0xe000)
-        m_internal_memory[address + 0x2000] = data;
-    else if (address < 0xfffc)
-        m_internal_memory[address - 0x2000] = data;
-
-    // Finally write in memory.
-    m_internal_memory[address] = data;
+    // 0xe000 mirrors the work RAM.
+    m_owner.WriteWorkRam(address, data);
 }
@@ -2,28 +2,27 @@
 #include <assert.h>
 #include "Types.h"
 
-SegaMM::SegaMM(Memory& owner, GameRom& game_rom) : MemoryMapping(owner, game_rom)
+SegaMM::SegaMM(Memory& owner, GameRom& game_rom)
+    : MemoryMapping   (owner, game_rom),
+      m_cartridge_ram (nullptr)
 {
-
+    m_mapper = { { 0, 1, 2 }, false, 0 };
+    RefreshMapping();
 }
 
 SegaMM::~SegaMM()
 {
-
 }
 
 /*
-    When reading and writing, maybe pagination is needed.
-    Now it can be solved by reading the cartridge memory instead of
-    copying memory into the processor one, but back in the day I assume
-    it was copied.
-    If it outperforms badly, change the copies for just accessing the memory instead.
+    Pages are read in place from the cartridge image (see Memory::MapRead),
+    a bank switch only repoints the pages of its slot.
 */
 byte SegaMM::ReadMemory(word address)
 {
     assert(address >= 0x0000 && address < 0x10000 && "Trying to write memory out of bounds");
 
-    return m_internal_memory[address];
+    return m_owner.ReadMapped(address);
 }
 
 void SegaMM::WriteMemory(word address, byte data)
@@ -36,52 +35,80 @@ void SegaMM::WriteMemory(word address, byte data)
     else if (address < 0xc000)
     {
         // Trying to write into the ROM/RAM slot.
-        // We need to check if it is used by RAM or ROM,
-        // so it is ROM we can't write on it
-
-        byte rom_ram_select = m_internal_memory[0xfffc];
-        const bool used_by_rom = (rom_ram_select & (1 << 3)) == 0;
-        if (used_by_rom)
-            return;
-
-        m_internal_memory[address] = data;
+        // It is only writable while it holds the cartridge RAM.
+        if (m_mapper.cartridge_ram_mapped)
+            m_cartridge_ram[m_mapper.cartridge_ram_page * 0x4000 + (address & 0x3fff)] = data;
     }
     else
     {
-        // Mirror RAM data
-        if (address < 0xe000)
-            m_internal_memory[address + 0x2000] = data;
-        else if (address < 0xfffc)
-            m_internal_memory[address - 0x2000] = data;
+        // 0xe000 mirrors the work RAM, the mapper registers at its end write through to it.
+        m_owner.WriteWorkRam(address, data);
 
         if (address == 0xfffc)
         {
-            if((data & (1 << 3)) != 0)
-            {
-                const word ram_page = (data & (1 << 2)) == 0 ? 0xc000 : 0xe000;
-                memcpy(&m_internal_memory[0x8000], &m_cartridge->GetRom()[ram_page], 0x2000);
-            }
+            // The cartridge RAM lives in the save file, which is only opened once a game uses it (see Memory::GetCartridgeRam).
+            if ((data & (1 << 3)) != 0 && !m_cartridge_ram)
+                m_cartridge_ram = m_owner.GetCartridgeRam();
+
+            m_mapper.cartridge_ram_mapped = (data & (1 << 3)) != 0 && m_cartridge_ram;
+            m_mapper.cartridge_ram_page   = (data >> 2) & 1;
+            MapSlot2();
         }
         else if (address == 0xfffd)
-        {
-            const uint8_t page = data & (m_cartridge->GetNumRomBanks() - 1);
-            memcpy(&m_internal_memory[0x0400], &m_cartridge->GetRom()[page*0x4000], 0x4000 - 0x0400);
-        }
+            MapRomBank(0, data);
         else if (address == 0xfffe)
-        {
-            const uint8_t page = data & (m_cartridge->GetNumRomBanks() - 1);
-            memcpy(&m_internal_memory[0x4000], &m_cartridge->GetRom()[page*0x4000], 0x4000);
-        }
+            MapRomBank(1, data);
         else if (address == 0xffff)
-        {
-            const bool used_by_rom = (data & (1 << 3)) == 0;
-            if (used_by_rom)
-            {
-                const uint8_t page = data & (m_cartridge->GetNumRomBanks() - 1);
-                memcpy(&m_internal_memory[0x8000], &m_cartridge->GetRom()[page*0x4000], 0x4000);
-            }
-        }
+            MapRomBank(2, data);
+    }
+}
+
+void SegaMM::MapRomBank(uint8_t slot, byte data)
+{
+    // Modulo instead of a mask so cartridges with a bank count that isn't a power of 2 wrap correctly.
+    m_mapper.rom_banks[slot] = data % m_cartridge->GetNumRomBanks();
 
-        m_internal_memory[address] = data;
+    if (slot == 2)
+        MapSlot2();
+    else
+    {
+        // Slot 0 keeps its first KB.
+        const word start = slot == 0 ? 0x0400 : slot * 0x4000;
+        m_owner.MapRead(start, (slot + 1) * 0x4000 - start, &m_cartridge->GetRom()[m_mapper.rom_banks[slot] * 0x4000 + (start & 0x3fff)]);
     }
 }
+
+void SegaMM::MapSlot2()
+{
+    // The ROM bank selected while the cartridge RAM is mapped is kept for when it is unmapped.
+    const byte* source = m_mapper.cartridge_ram_mapped ? &m_cartridge_ram[m_mapper.cartridge_ram_page * 0x4000] : &m_cartridge->GetRom()[m_mapper.rom_banks[2] * 0x4000];
+    m_owner.MapRead(0x8000, 0x4000, source);
+}
+
+void SegaMM::RefreshMapping()
+{
+    // A restored state may have the cartridge RAM mapped before this instance opened the save file.
+    if (m_mapper.cartridge_ram_mapped && !m_cartridge_ram)
+        m_cartridge_ram = m_owner.GetCartridgeRam();
+
+    m_mapper.cartridge_ram_mapped = m_mapper.cartridge_ram_mapped && m_cartridge_ram;
+
+    // First KB is never paged out.
+    m_owner.MapRead(0x0000, 0x0400, m_cartridge->GetRom());
+
+    for (uint8_t slot = 0; slot < 3; ++slot)
+        MapRomBank(slot, m_mapper.rom_banks[slot]);
+}
+
+int32_t SegaMM::GetRomOffset(word address) const
+{
+    // First KB is always the beginning of the ROM.
+    if (address < 0x0400)
+        return address;
+
+    const uint8_t slot = address >> 14;
+    if (slot > 2 || (slot == 2 && m_mapper.cartridge_ram_mapped))
+        return -1;
+
+    return m_mapper.rom_banks[slot] * 0x4000 + (address & 0x3fff);
+}
@@ -10,5 +10,14 @@ public:
 
     byte  ReadMemory  (word address)            override;
     void  WriteMemory (word address, byte data) override;
-};
 
+    void    RefreshMapping()                   override;
+    int32_t GetRomOffset(word address) const override;
+
+private:
+    void MapRomBank (uint8_t slot, byte data);
+    void MapSlot2   ();
+
+private:
+    byte*   m_cartridge_ram; // 2 pages of 16KB, battery-backed save file or the private copy of a fork.
+};
@@ -13,7 +13,7 @@ byte TestMM::ReadMemory(word address)
 {
     assert(address >= 0x0000 && address < 0x10000 && "Trying to write memory out of bounds");
 
-    return m_internal_memory[address];
+    return m_owner.ReadMapped(address);
 }
 
 void TestMM::WriteMemory(word address, byte data)
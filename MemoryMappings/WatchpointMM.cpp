@@ -0,0 +1,38 @@
+#include "WatchpointMM.h"
+#include "Debug/Debugger.h"
+#include <assert.h>
+
+WatchpointMM::WatchpointMM(Memory& owner, GameRom& game_rom, MemoryMapping* mapping, Debugger* debugger)
+    : MemoryMapping (owner, game_rom),
+      m_mapping     (mapping),
+      m_debugger    (debugger)
+{
+    assert(m_mapping != nullptr);
+    assert(m_debugger != nullptr);
+}
+
+WatchpointMM::~WatchpointMM()
+{
+}
+
+byte WatchpointMM::ReadMemory(word address)
+{
+    m_debugger->OnRead(address);
+    return m_mapping->ReadMemory(address);
+}
+
+void WatchpointMM::WriteMemory(word address, byte data)
+{
+    m_debugger->OnWrite(address);
+    m_mapping->WriteMemory(address, data);
+}
+
+byte WatchpointMM::PeekMemory(word address) const
+{
+    return m_mapping->PeekMemory(address);
+}
+
+int32_t WatchpointMM::GetRomOffset(word address) const
+{
+    return m_mapping->GetRomOffset(address);
+}
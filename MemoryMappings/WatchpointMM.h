@@ -0,0 +1,29 @@
+#pragma once
+
+#include "MemoryMapping.h"
+
+class Debugger;
+
+/*
+    Debug memory path. Wraps the cartridge mapping and reports accesses to watched
+    addresses to the debugger. Memory only installs it while watchpoints exist.
+*/
+class WatchpointMM : public MemoryMapping
+{
+public:
+    WatchpointMM(Memory& owner, GameRom& game_rom, MemoryMapping* mapping, Debugger* debugger);
+    ~WatchpointMM();
+
+    byte  ReadMemory  (word address)            override;
+    void  WriteMemory (word address, byte data) override;
+    byte  PeekMemory  (word address) const      override;
+    void  RefreshMapping()                      override { m_mapping->RefreshMapping(); }
+
+    int32_t GetRomOffset(word address) const override;
+
+    MemoryMapping* GetWrappedMapping() const { return m_mapping; }
+
+private:
+    MemoryMapping* m_mapping;
+    Debugger*      m_debugger;
+};
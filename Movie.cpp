@@ -0,0 +1,145 @@
+#include "Movie.h"
+#include "FileUtils.h"
+#include <stdio.h>
+#include <string.h>
+
+static constexpr char MOVIE_MAGIC[4] = { 'S', 'M', 'S', 'M' };
+
+namespace
+{
+    void WriteLE(std::vector<byte>& out, uint64_t value, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i)
+            out.push_back(static_cast<byte>(value >> (i * 8)));
+    }
+
+    void WriteVarint(std::vector<byte>& out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<byte>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<byte>(value));
+    }
+
+    bool ReadLE(const std::vector<byte>& data, size_t& offset, uint32_t& value, uint32_t size)
+    {
+        if (size > data.size() - offset)
+            return false;
+
+        value = 0;
+        for (uint32_t i = 0; i < size; ++i)
+            value |= static_cast<uint32_t>(data[offset++]) << (i * 8);
+        return true;
+    }
+
+    bool ReadVarint(const std::vector<byte>& data, size_t& offset, uint32_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 32; shift += 7)
+        {
+            if (offset >= data.size())
+                return false;
+
+            const byte b = data[offset++];
+            value |= static_cast<uint32_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+};
+
+void Movie::AddFrame(uint16_t buttons, uint32_t state_hash)
+{
+    m_buttons.push_back(buttons);
+    m_state_hashes.push_back(state_hash);
+}
+
+bool Movie::Save(const std::string& path) const
+{
+    std::vector<byte> data;
+    data.reserve(20 + m_buttons.size() * 4);
+
+    data.insert(data.end(), MOVIE_MAGIC, MOVIE_MAGIC + sizeof(MOVIE_MAGIC));
+    WriteLE(data, VERSION, 4);
+    WriteLE(data, m_rom_crc32, 4);
+    WriteLE(data, m_flags, 4);
+    WriteLE(data, m_buttons.size(), 4);
+
+    for (size_t frame = 0; frame < m_buttons.size(); )
+    {
+        size_t run_end = frame + 1;
+        while (run_end < m_buttons.size() && m_buttons[run_end] == m_buttons[frame])
+            ++run_end;
+
+        WriteVarint(data, static_cast<uint32_t>(run_end - frame));
+        WriteLE(data, m_buttons[frame], 2);
+        frame = run_end;
+    }
+
+    for (uint32_t hash : m_state_hashes)
+        WriteLE(data, hash, 4);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    const bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool Movie::Load(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::vector<byte> data(static_cast<size_t>(FileUtils::GetFileSize(file)));
+    const bool read = fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+
+    size_t   offset     = sizeof(MOVIE_MAGIC);
+    uint32_t version    = 0;
+    uint32_t num_frames = 0;
+
+    if (!read || data.size() < sizeof(MOVIE_MAGIC) || memcmp(data.data(), MOVIE_MAGIC, sizeof(MOVIE_MAGIC)) != 0 ||
+        !ReadLE(data, offset, version, 4) || version != VERSION ||
+        !ReadLE(data, offset, m_rom_crc32, 4) || !ReadLE(data, offset, m_flags, 4) || !ReadLE(data, offset, num_frames, 4))
+        return false;
+
+    // Flags of a later build, the replay couldn't match.
+    if (m_flags & ~MOVIE_FLAG_FM)
+        return false;
+
+    // Every frame needs at least its hash, checked before reserving anything.
+    if (num_frames > (data.size() - offset) / 4)
+        return false;
+
+    m_buttons.clear();
+    m_state_hashes.clear();
+    m_buttons.reserve(num_frames);
+    m_state_hashes.reserve(num_frames);
+
+    while (m_buttons.size() < num_frames)
+    {
+        uint32_t run_length = 0;
+        uint32_t buttons    = 0;
+        if (!ReadVarint(data, offset, run_length) || !ReadLE(data, offset, buttons, 2) ||
+            run_length == 0 || run_length > num_frames - m_buttons.size())
+            return false;
+
+        m_buttons.insert(m_buttons.end(), run_length, static_cast<uint16_t>(buttons));
+    }
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        uint32_t hash = 0;
+        if (!ReadLE(data, offset, hash, 4))
+            return false;
+        m_state_hashes.push_back(hash);
+    }
+
+    return offset == data.size();
+}
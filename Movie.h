@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Types.h"
+#include <string>
+#include <vector>
+
+/*
+    Input movie: the buttons held on every frame since the game was loaded, and the hash of the
+    machine state at the end of each frame (see SMS::GetStateHash) to check a replay against.
+
+    The file is little-endian:
+        "SMSM" | version (u32) | ROM crc32 (u32) | flags (u32) | frame count (u32)
+        input runs until frame count is reached: frames (varint) | buttons (u16)
+        one state hash (u32) per frame
+
+    Buttons rarely change from one frame to the next, so a run per change keeps the input to a few
+    bytes per second; the hashes are what take most of the file.
+    The battery-backed save file isn't recorded: a replay only matches with the same .sav.
+    The flags record the hardware the game was played on (MOVIE_FLAG_FM: the FM unit was plugged
+    in), since games look for it and take other paths.
+*/
+class Movie
+{
+public:
+    static constexpr uint32_t VERSION       = 2;
+    static constexpr uint32_t MOVIE_FLAG_FM = 1 << 0;
+
+public:
+    Movie(uint32_t rom_crc32 = 0, uint32_t flags = 0) : m_rom_crc32(rom_crc32), m_flags(flags) {}
+
+    bool Load (const std::string& path);
+    bool Save (const std::string& path) const;
+
+    void AddFrame (uint16_t buttons, uint32_t state_hash);
+
+    uint32_t GetRomCrc32  () const                { return m_rom_crc32; }
+    uint32_t GetFlags     () const                { return m_flags; }
+    uint32_t GetNumFrames () const                { return static_cast<uint32_t>(m_buttons.size()); }
+    uint16_t GetButtons   (uint32_t frame) const { return m_buttons[frame]; }
+    uint32_t GetStateHash (uint32_t frame) const { return m_state_hashes[frame]; }
+
+private:
+    uint32_t              m_rom_crc32;
+    uint32_t              m_flags;        // MOVIE_FLAG_ bits.
+    std::vector<uint16_t> m_buttons;      // JoypadButton bits, one entry per frame.
+    std::vector<uint32_t> m_state_hashes;
+};
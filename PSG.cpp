@@ -0,0 +1,195 @@
+#include "PSG.h"
+#include "Z80.h"
+#include <assert.h>
+#include <string.h>
+
+// The chip clock is the CPU clock divided by 16.
+constexpr uint32_t CYCLES_PER_TICK = 16;
+
+// About 93ms at 44.1kHz, more than enough between two reads of a frame.
+constexpr uint32_t MAX_BUFFERED_SAMPLES = 4096;
+
+constexpr uint32_t NOISE_CHANNEL = 3;
+// outputs bit of the flip-flop clocking the noise shift register, it shifts on every other edge.
+constexpr uint8_t  NOISE_CLOCK   = 1 << 4;
+
+// 2dB per step. Four channels at full volume stay within 16 bits.
+const int32_t PSG::VOLUME_TABLE[16] = { 8191, 6506, 5168, 4105, 3261, 2590, 2057, 1634, 1298, 1031, 819, 651, 517, 411, 326, 0 };
+
+PSG::PSG(PSGState& state) :
+    m_state          (state),
+    m_output         (MAX_BUFFERED_SAMPLES),
+    m_frame_start    (0),
+    m_output_enabled (true)
+{
+    ResetState(m_state, 0);
+}
+
+void PSG::ResetState(PSGState& state, uint64_t cycle)
+{
+    memset(&state, 0, sizeof(state));
+    memset(state.volume, 0xf, sizeof(state.volume));
+
+    state.lfsr  = 0x8000;
+    state.cycle = cycle;
+}
+
+void PSG::Reset(uint64_t cycle)
+{
+    ResetState(m_state, cycle);
+    m_output.Clear();
+    m_frame_start = cycle;
+}
+
+void PSG::SetOutputRate(uint32_t cpu_clock, uint32_t sample_rate)
+{
+    m_output.SetRates(cpu_clock, sample_rate);
+    m_frame_start = m_state.cycle;
+}
+
+void PSG::Resync()
+{
+    m_frame_start = m_state.cycle;
+}
+
+void PSG::Write(byte data)
+{
+    assert(m_context.cpu != nullptr && "The PSG needs the CPU clock");
+
+    // Everything before the write plays with the old registers.
+    Run(m_context.cpu->GetTotalCycles());
+
+    // A latch byte selects the register and carries its low bits, data bytes carry the high bits.
+    const bool is_latch = (data & 0x80) != 0;
+    if (is_latch)
+        m_state.latched = (data >> 4) & 0x7;
+
+    const uint32_t channel = m_state.latched >> 1;
+
+    if (m_state.latched & 1)
+        SetVolume(channel, data & 0xf);
+    else if (channel != NOISE_CHANNEL)
+    {
+        uint16_t& tone = m_state.tone[channel];
+        tone = is_latch ? (tone & 0x3f0) | (data & 0xf) : (tone & 0xf) | ((data & 0x3f) << 4);
+    }
+    else
+    {
+        // Any write to the noise register restarts the shift register.
+        m_state.noise = data & 0x7;
+        m_state.lfsr  = 0x8000;
+    }
+}
+
+void PSG::EndFrame(uint64_t cycle)
+{
+    Run(cycle);
+
+    if (m_output_enabled)
+        m_output.EndFrame(static_cast<uint32_t>(cycle - m_frame_start));
+
+    m_frame_start = cycle;
+}
+
+void PSG::Run(uint64_t cycle)
+{
+    if (cycle <= m_state.cycle)
+        return;
+
+    for (uint32_t channel = 0; channel < NOISE_CHANNEL; ++channel)
+        RunTone(channel, cycle);
+
+    RunNoise(cycle);
+
+    m_state.cycle = cycle;
+}
+
+void PSG::RunTone(uint32_t channel, uint64_t cycle)
+{
+    const uint32_t period = m_state.tone[channel] * CYCLES_PER_TICK;
+    uint64_t       time   = m_state.cycle;
+
+    // Periods of 0 and 1 are far above what can be heard, the output stays high.
+    // Games play samples that way, through the volume register.
+    if (m_state.tone[channel] <= 1)
+    {
+        SetLevel(channel, true, time);
+        m_state.counters[channel] = period;
+        return;
+    }
+
+    // Jumps from edge to edge, the counter reloads with the period at each one.
+    uint32_t counter = m_state.counters[channel];
+    while (cycle - time >= counter)
+    {
+        time += counter;
+        SetLevel(channel, ((m_state.outputs >> channel) & 1) == 0, time);
+        counter = period;
+    }
+
+    m_state.counters[channel] = counter - static_cast<uint32_t>(cycle - time);
+}
+
+void PSG::RunNoise(uint64_t cycle)
+{
+    const uint32_t period = GetNoisePeriod() * CYCLES_PER_TICK;
+    uint64_t       time   = m_state.cycle;
+
+    uint32_t counter = m_state.counters[NOISE_CHANNEL];
+    while (cycle - time >= counter)
+    {
+        time   += counter;
+        counter = period;
+
+        m_state.outputs ^= NOISE_CLOCK;
+        if (m_state.outputs & NOISE_CLOCK)
+        {
+            // Sega's variant: 16 bits, white noise taps bits 0 and 3.
+            const uint16_t lfsr     = m_state.lfsr;
+            const uint16_t feedback = (m_state.noise & 0x4) ? (lfsr ^ (lfsr >> 3)) & 1 : lfsr & 1;
+
+            m_state.lfsr = static_cast<uint16_t>((lfsr >> 1) | (feedback << 15));
+            SetLevel(NOISE_CHANNEL, (m_state.lfsr & 1) != 0, time);
+        }
+    }
+
+    m_state.counters[NOISE_CHANNEL] = counter - static_cast<uint32_t>(cycle - time);
+}
+
+uint32_t PSG::GetNoisePeriod() const
+{
+    // Fixed rates, or the period of the third tone channel.
+    switch (m_state.noise & 0x3)
+    {
+    case 0:  return 0x10;
+    case 1:  return 0x20;
+    case 2:  return 0x40;
+    default: return m_state.tone[2] > 0 ? m_state.tone[2] : 1;
+    }
+}
+
+void PSG::SetLevel(uint32_t channel, bool high, uint64_t cycle)
+{
+    const int32_t previous = GetLevel(channel);
+
+    if (high)
+        m_state.outputs |= 1 << channel;
+    else
+        m_state.outputs &= ~(1 << channel);
+
+    AddDelta(cycle, GetLevel(channel) - previous);
+}
+
+void PSG::SetVolume(uint32_t channel, uint8_t volume)
+{
+    const int32_t previous = GetLevel(channel);
+
+    m_state.volume[channel] = volume;
+    AddDelta(m_state.cycle, GetLevel(channel) - previous);
+}
+
+void PSG::AddDelta(uint64_t cycle, int32_t delta)
+{
+    if (delta != 0 && m_output_enabled && cycle >= m_frame_start)
+        m_output.AddDelta(static_cast<uint32_t>(cycle - m_frame_start), delta);
+}
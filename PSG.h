@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Types.h"
+#include "BandLimitedBuffer.h"
+
+/*
+    SN76489 registers and counters. Part of the MachineState arena, the PSG only keeps a reference to it.
+    Counters are in CPU cycles until the next edge of the channel (the chip divides the CPU clock by 16).
+*/
+struct PSGState
+{
+    uint16_t tone[3];       // 10 bits periods, in steps of 16 CPU cycles.
+    uint8_t  volume[4];     // 4 bits attenuation, 2dB per step, 0xf is off. Channel 3 is the noise.
+    uint8_t  noise;         // Bits 0-1: shift rate, bit 2: white noise (periodic otherwise).
+    uint8_t  latched;       // Register the data bytes go to: channel << 1 | is volume.
+    uint8_t  outputs;       // Bit per channel, high or low. Bit 4 clocks the noise shift register.
+    uint16_t lfsr;          // Noise shift register.
+    uint32_t counters[4];
+    uint64_t cycle;         // CPU cycle the channels have been run to.
+};
+
+class Z80;
+struct PSGContext
+{
+    PSGContext() {}
+    PSGContext(Z80* _cpu) : cpu(_cpu) {}
+
+    Z80* cpu = nullptr;
+};
+
+/*
+    Programmable sound generator: three square wave channels and a noise channel.
+
+    Writes are timestamped with the CPU cycle counter. A write first runs the channels up to its
+    cycle, then changes the register, so the level changes land where the game made them. Running
+    the channels jumps from one edge to the next and only reports the level changes to a
+    BandLimitedBuffer, nothing is done per CPU instruction or per sample. EndFrame runs up to the
+    end of the frame and hands the frame to the buffer.
+*/
+class PSG
+{
+public:
+    PSG(PSGState& state);
+
+    inline void SetContext(const PSGContext& context) { m_context = context; }
+
+    // Power on state, the channels run from cycle.
+    void Reset            (uint64_t cycle);
+    static void ResetState(PSGState& state, uint64_t cycle);
+
+    void SetOutputRate    (uint32_t cpu_clock, uint32_t sample_rate);
+    // Frames emulated only for their state (run-ahead) don't produce sound.
+    inline void SetOutputEnabled(bool enabled) { m_output_enabled = enabled; }
+    // The state was replaced (loaded, rewound), the output goes on from its cycle.
+    void Resync           ();
+
+    void Write    (byte data);
+    void EndFrame (uint64_t cycle);
+
+    BandLimitedBuffer& GetOutput() { return m_output; }
+
+private:
+    void Run        (uint64_t cycle);
+    void RunTone    (uint32_t channel, uint64_t cycle);
+    void RunNoise   (uint64_t cycle);
+    void SetLevel   (uint32_t channel, bool high, uint64_t cycle);
+    void SetVolume  (uint32_t channel, uint8_t volume);
+    void AddDelta   (uint64_t cycle, int32_t delta);
+    uint32_t GetNoisePeriod() const;
+
+    inline int32_t GetLevel(uint32_t channel) const { return (m_state.outputs >> channel) & 1 ? VOLUME_TABLE[m_state.volume[channel]] : 0; }
+
+private:
+    static const int32_t VOLUME_TABLE[16];
+
+    PSGState&         m_state;
+    PSGContext        m_context;
+    BandLimitedBuffer m_output;
+    uint64_t          m_frame_start;    // CPU cycle of time 0 in m_output.
+    bool              m_output_enabled;
+};
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3 
+# -*- coding: utf-8 -*- 
+
+# Builds the disassembler mnemonic tables (Z80Instructions/Z80Mnemonics.h) from the same
+# op_codes tables used by generate_opcodes.py.
+#
+# The tables name the emulator helper called for each opcode, so the helper names are
+# translated back into Z80 syntax. Operands read from the instruction stream use
+# placeholders resolved by the disassembler at runtime:
+#     {n}  - immediate byte
+#     {nn} - immediate word
+#     {e}  - relative jump (printed as the target address)
+
+init_comment = '/*\n\tAutogenerated File (generate_mnemonics.py).\n*/\n\n'
+
+registers_16 = ['bc', 'de', 'hl', 'sp']
+
+# Operand spelling used by the helpers -> Z80 syntax
+operand_replacements = {
+    'hl*'   : 'hl',
+    'h*'    : 'h',
+    'l*'    : 'l',
+    '(hl*)' : '(hl)',
+    'C'     : 'c',
+    'n'     : '{n}',
+    '(n)'   : '({n})',
+}
+
+# Helper names that map to a mnemonic with an implicit (hl) operand
+hl_helpers = {
+    'ADD_HL' : 'ADD', 'ADC_HL' : 'ADC', 'SUB_HL' : 'SUB', 'SBC_HL' : 'SBC',
+    'AND_HL' : 'AND', 'OR_HL'  : 'OR',  'XOR_HL' : 'XOR', 'CP_HL'  : 'CP',
+    'INC_HL' : 'INC', 'DEC_HL' : 'DEC',
+    'RLC_HL' : 'RLC', 'RRC_HL' : 'RRC', 'RL_HL'  : 'RL',  'RR_HL'  : 'RR',
+    'SLA_HL' : 'SLA', 'SRA_HL' : 'SRA', 'SRL_HL' : 'SRL',
+    'BIT_HL' : 'BIT', 'RES_HL' : 'RES', 'SET_HL' : 'SET',
+}
+
+registers_8  = ['b', 'c', 'd', 'e', 'h', 'l', '(hl)', 'a']
+
+
+def translate(table, opcode, name, args):
+    args = [operand_replacements.get(arg, arg) for arg in args]
+
+    # The 16 bit arithmetic and load helpers don't spell their operands, take them from the encoding
+    reg_pair = registers_16[(opcode >> 4) & 3]
+
+    if table == 'main':
+        if name == 'ADD' and (opcode & 0x0f) == 0x09:
+            return 'ADD hl,%s' % reg_pair
+        if name == 'LD_DDNN':
+            if (opcode & 0x0f) == 0x01:
+                return 'LD %s,{nn}' % reg_pair
+            return 'LD %s,({nn})' % ('a' if opcode == 0x3a else 'hl')
+        if name == 'LD_NNDD':
+            return 'LD ({nn}),%s' % ('a' if opcode == 0x32 else 'hl')
+        if name in ('INC', 'DEC') and (opcode & 0x07) == 0x03:
+            return '%s %s' % (name, reg_pair)
+        if name == 'LD_HL_N':
+            return 'LD (hl),{n}'
+        if name == 'LD_SP_HL':
+            return 'LD sp,hl'
+        if name == 'EX_SPHL':
+            return 'EX (sp),hl'
+        if name == 'EX' and opcode == 0x08:
+            return "EX af,af'"
+        if name == 'DJNZ':
+            return 'DJNZ {e}'
+        if name == 'JR':
+            return 'JR %s{e}' % ('%s,' % args[0] if args else '')
+        if name in ('JP', 'CALL') and opcode != 0xe9:
+            return '%s %s{nn}' % (name, '%s,' % args[0] if args else '')
+        if name == 'JP':
+            return 'JP (hl)'
+        if name == 'OUT_N':
+            return 'OUT ({n}),a'
+        if name == 'IN_N':
+            return 'IN a,({n})'
+        if name == 'RST':
+            return 'RST $%02X' % int(args[0], 16)
+        if name in ('SUB', 'AND', 'XOR', 'OR', 'CP') and args[-1:] != ['{n}']:
+            # Register forms write the source only
+            return '%s %s' % (name, args[-1] if name != 'SUB' or opcode != 0x96 else '(hl)')
+        if name == 'SBC' and opcode == 0x9f:
+            return 'SBC a,a'
+        if name in ('SUB', 'AND', 'XOR', 'OR', 'CP'):
+            return '%s {n}' % name
+        if name == 'LD' and len(args) == 2 and args[1] == 'a' and args[0] in ('(bc)', '(de)'):
+            return 'LD %s,a' % args[0]
+        if name == 'LD' and len(args) == 2 and args[0] == 'a' and args[1] in ('(bc)', '(de)'):
+            return 'LD a,%s' % args[1]
+
+    if table == 'cb' and args and args[-1] in registers_8:
+        args[-1] = registers_8[opcode & 7]
+
+    if table == 'ed':
+        if name in ('SBC', 'ADC', 'ADD', 'SBC_HL', 'ADC_HL'):
+            return '%s hl,%s' % ('SBC' if (opcode & 0x0f) == 0x02 else 'ADC', reg_pair)
+        if name == 'LD_DDNN':
+            return 'LD %s,({nn})' % reg_pair
+        if name == 'LD_NNDD':
+            return 'LD ({nn}),%s' % reg_pair
+        if name == 'IN_C':
+            return 'IN %s,(c)' % args[0]
+        if name == 'OUT_C':
+            return 'OUT (c),%s' % args[-1]
+        if name in ('IM0', 'IM1', 'IM2'):
+            return 'IM %s' % name[2]
+        if name == 'LD_AI':
+            return 'LD a,i'
+        if name == 'LD_AR':
+            return 'LD a,r'
+
+    if name in hl_helpers:
+        mnemonic = hl_helpers[name]
+        if args and args[0].isdigit():
+            return '%s %s,(hl)' % (mnemonic, args[0])
+        if mnemonic in ('ADD', 'ADC', 'SBC'):
+            return '%s a,(hl)' % mnemonic
+        return '%s (hl)' % mnemonic
+
+    if name == 'RET' and args:
+        return 'RET %s' % args[0]
+
+    if args:
+        return '%s %s' % (name, ','.join(args))
+    return name
+
+
+def read_table(src, table):
+    mnemonics = [None] * 256
+    with open(src, 'r') as file:
+        for line in file:
+            line_split = line.split()
+            if len(line_split) < 2 or 'UNUSED' in line_split[1]:
+                continue
+            opcode = int(line_split[0], 16)
+            if line_split[1] in ('CB', 'DD', 'ED', 'FD'):
+                continue
+            mnemonics[opcode] = translate(table, opcode, line_split[1], line_split[2:])
+    return mnemonics
+
+
+def write_table(name, mnemonics):
+    text = '\tconst char* const %s [256] = \n\t{\n' % name
+    for i, mnemonic in enumerate(mnemonics):
+        value = '"%s"' % mnemonic if mnemonic else 'nullptr'
+        text += '\t\t%s%s // 0x%02x\n' % (value, ',' if i < 255 else ' ', i)
+    text += '\t};\n'
+    return text
+
+
+def create_header():
+    with open('../Z80Instructions/Z80Mnemonics.h', 'w+') as file:
+        text = init_comment
+        text += '#pragma once\n\nnamespace Z80Instructions\n{\n'
+        text += write_table('s_opcode_mnemonics',    read_table('op_codes.txt',    'main'))
+        text += '\n'
+        text += write_table('s_opcode_cb_mnemonics', read_table('op_codes_cb.txt', 'cb'))
+        text += '\n'
+        text += write_table('s_opcode_ed_mnemonics', read_table('op_codes_ed.txt', 'ed'))
+        text += '}\n'
+        file.write(text)
+
+
+def main(): 
+    create_header()
+
+if __name__ == "__main__": 
+	main()
@@ -103,34 +103,34 @@ opcode_timings_ed_branched = [
                  ]
 
 replacements = {
-    'af'    : 'cpu.m_reg_AF',
-    'bc'    : 'cpu.m_reg_BC',
-    'de'    : 'cpu.m_reg_DE',
+    'af'    : 'cpu.m_state.reg_AF',
+    'bc'    : 'cpu.m_state.reg_BC',
+    'de'    : 'cpu.m_state.reg_DE',
     'hl'    : 'cpu.GetPrefixedHL()',
-    "af'"   : 'cpu.m_reg_AF_shadow',
-    "bc'"   : 'cpu.m_reg_BC_shadow',
-    "de'"   : 'cpu.m_reg_DE_shadow',
-    "hl'"   : 'cpu.m_reg_HL_shadow',
-    'hl*'   : 'cpu.m_reg_HL',
-    'a'     : 'cpu.m_reg_AF.hi',
-    'b'     : 'cpu.m_reg_BC.hi',
-    'c'     : 'cpu.m_reg_BC.lo',
-    'd'     : 'cpu.m_reg_DE.hi',
-    'e'     : 'cpu.m_reg_DE.lo',
+    "af'"   : 'cpu.m_state.reg_AF_shadow',
+    "bc'"   : 'cpu.m_state.reg_BC_shadow',
+    "de'"   : 'cpu.m_state.reg_DE_shadow',
+    "hl'"   : 'cpu.m_state.reg_HL_shadow',
+    'hl*'   : 'cpu.m_state.reg_HL',
+    'a'     : 'cpu.m_state.reg_AF.hi',
+    'b'     : 'cpu.m_state.reg_BC.hi',
+    'c'     : 'cpu.m_state.reg_BC.lo',
+    'd'     : 'cpu.m_state.reg_DE.hi',
+    'e'     : 'cpu.m_state.reg_DE.lo',
     'h'     : 'cpu.GetPrefixedHL().hi',
     'l'     : 'cpu.GetPrefixedHL().lo',
-    'h*'    : 'cpu.m_reg_HL.hi',
-    'l*'    : 'cpu.m_reg_HL.lo', 
-    'r'     : 'cpu.m_reg_refresh',
-    'i'     : 'cpu.m_reg_interrupt',
-    '(af)'  : 'cpu.m_reg_AF.value',
-    '(bc)'  : 'cpu.m_reg_BC.value',
-    '(de)'  : 'cpu.m_reg_DE.value',
+    'h*'    : 'cpu.m_state.reg_HL.hi',
+    'l*'    : 'cpu.m_state.reg_HL.lo', 
+    'r'     : 'cpu.m_state.reg_refresh',
+    'i'     : 'cpu.m_state.reg_interrupt',
+    '(af)'  : 'cpu.m_state.reg_AF.value',
+    '(bc)'  : 'cpu.m_state.reg_BC.value',
+    '(de)'  : 'cpu.m_state.reg_DE.value',
     '(hl)'  : 'cpu.GetPrefixedHLAddress()',
-    '(hl*)' : 'cpu.m_reg_HL.value',
+    '(hl*)' : 'cpu.m_state.reg_HL.value',
     'n'     : 'cpu.ReadByte()',
     '(n)'   : '',
-    'sp'    : 'cpu.m_stack_pointer',
+    'sp'    : 'cpu.m_state.stack_pointer',
     'nz'    : '!cpu.ReadFlag(FLAG::ZERO)',
     'z'     : 'cpu.ReadFlag(FLAG::ZERO)',
     'm'     : 'cpu.ReadFlag(FLAG::SIGN)',
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3 
+# -*- coding: utf-8 -*- 
+
+# Builds the ROM database (RomDatabaseEntries.h) from rom_database.txt.
+#
+# The entries are sorted by CRC32 so RomDatabase::Find can binary search them,
+# and packed in 8 bytes each. Names are only kept as comments.
+
+init_comment = '/*\n\tAutogenerated File (generate_rom_database.py).\n*/\n\n'
+
+mappers = { '-' : 'MemoryType::None', 'sega' : 'MemoryType::Sega', 'romonly' : 'MemoryType::ROMOnly', 'codemasters' : 'MemoryType::Codemasters' }
+regions = { '-' : 'VideoSystem::Unknown', 'ntsc' : 'VideoSystem::NTSC', 'pal' : 'VideoSystem::PAL' }
+quirks  = { 'fm' : 'ROM_QUIRK_FM_SOUND', 'sms1_vdp' : 'ROM_QUIRK_SMS1_VDP', 'light_phaser' : 'ROM_QUIRK_LIGHT_PHASER', 'paddle' : 'ROM_QUIRK_PADDLE' }
+
+def read_database(src):
+    entries = {}
+    with open(src, 'r') as file:
+        for line_number, line in enumerate(file, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+
+            crc, mapper, region, quirk_list, name = line.split(None, 4)
+            crc = int(crc, 16)
+
+            if crc in entries:
+                raise ValueError('%s:%d: duplicated CRC32 %08X (%s)' % (src, line_number, crc, name))
+
+            flags = '0' if quirk_list == '-' else ' | '.join(quirks[quirk] for quirk in quirk_list.split('|'))
+            entries[crc] = (mappers[mapper], regions[region], flags, name)
+
+    return entries
+
+if __name__ == '__main__':
+    entries = read_database('rom_database.txt')
+
+    with open('../RomDatabaseEntries.h', 'w+') as file:
+        text  = init_comment
+        text += '#pragma once\n\n'
+        text += '#include "RomDatabase.h"\n\n'
+        text += 'static const RomDatabaseEntry s_rom_database[] =\n{\n'
+        for crc in sorted(entries):
+            mapper, region, flags, name = entries[crc]
+            text += '\t{ 0x%08X, %s, %s, %s }, // %s\n' % (crc, mapper, region, flags, name)
+        text += '};\n'
+        file.write(text)
@@ -0,0 +1,225 @@
+#include "RewindBuffer.h"
+#include <assert.h>
+#include <string.h>
+
+static_assert(sizeof(MachineState) % sizeof(uint64_t) == 0, "Deltas are encoded per 64-bit word");
+
+namespace
+{
+    constexpr size_t NUM_WORDS = sizeof(MachineState) / sizeof(uint64_t);
+
+    // Two varints per run and a run per changed word at worst.
+    constexpr size_t MAX_DELTA_SIZE = sizeof(MachineState) + 2 * 10 * (NUM_WORDS / 2 + 1);
+
+    inline uint64_t LoadWord(const byte* data, size_t index)
+    {
+        uint64_t value;
+        memcpy(&value, data + index * sizeof(uint64_t), sizeof(value));
+        return value;
+    }
+
+    inline size_t WriteVarint(byte* out, size_t value)
+    {
+        size_t size = 0;
+        while (value >= 0x80)
+        {
+            out[size++] = static_cast<byte>(value | 0x80);
+            value >>= 7;
+        }
+        out[size++] = static_cast<byte>(value);
+        return size;
+    }
+
+    inline size_t ReadVarint(const byte* data, size_t& offset)
+    {
+        size_t value = 0;
+        for (uint32_t shift = 0; ; shift += 7)
+        {
+            const byte b = data[offset++];
+            value |= static_cast<size_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return value;
+        }
+    }
+};
+
+RewindBuffer::RewindBuffer(size_t memory_cap, uint32_t keyframe_interval) :
+    m_buffer                (memory_cap),
+    m_keyframe_interval     (keyframe_interval),
+    m_frames_since_keyframe (0),
+    m_scratch               (MAX_DELTA_SIZE)
+{
+    assert(m_keyframe_interval > 0 && "Keyframe interval can't be 0");
+}
+
+size_t RewindBuffer::GetMemoryUsed() const
+{
+    size_t used = 0;
+    for (const Entry& entry : m_entries)
+        used += entry.size;
+    return used;
+}
+
+void RewindBuffer::Clear()
+{
+    m_entries.clear();
+    m_frames_since_keyframe = 0;
+}
+
+void RewindBuffer::Push(const MachineState& state)
+{
+    bool keyframe = m_entries.empty() || m_frames_since_keyframe + 1 >= m_keyframe_interval;
+
+    // Making room for the delta can drop the keyframe it depends on (a cap smaller than a group),
+    // the frame is then stored whole.
+    if (!keyframe)
+    {
+        const size_t size = EncodeDelta(state, m_newest, m_scratch.data());
+        keyframe = !Store(m_scratch.data(), size, false);
+    }
+
+    if (keyframe)
+        Store(reinterpret_cast<const byte*>(&state), sizeof(MachineState), true);
+
+    assert((m_entries.empty() || m_entries.front().keyframe) && "The history must start with a keyframe");
+    memcpy(&m_newest, &state, sizeof(MachineState));
+}
+
+bool RewindBuffer::Pop(MachineState& state)
+{
+    if (m_entries.empty())
+        return false;
+
+    memcpy(&state, &m_newest, sizeof(MachineState));
+
+    const Entry newest = m_entries.back();
+    m_entries.pop_back();
+
+    if (m_entries.empty())
+        m_frames_since_keyframe = 0;
+    else if (!newest.keyframe)
+    {
+        // The delta is the XOR with the frame before it.
+        ApplyDelta(&m_buffer[newest.offset], newest.size, m_newest);
+        --m_frames_since_keyframe;
+    }
+    else
+        RebuildNewest();
+
+    return true;
+}
+
+void RewindBuffer::RebuildNewest()
+{
+    size_t keyframe = m_entries.size() - 1;
+    while (keyframe > 0 && !m_entries[keyframe].keyframe)
+        --keyframe;
+
+    assert(m_entries[keyframe].keyframe && "Deltas without their keyframe");
+
+    memcpy(&m_newest, &m_buffer[m_entries[keyframe].offset], sizeof(MachineState));
+    for (size_t i = keyframe + 1; i < m_entries.size(); ++i)
+        ApplyDelta(&m_buffer[m_entries[i].offset], m_entries[i].size, m_newest);
+
+    m_frames_since_keyframe = static_cast<uint32_t>(m_entries.size() - 1 - keyframe);
+}
+
+bool RewindBuffer::Store(const byte* data, size_t size, bool keyframe)
+{
+    size_t offset;
+    if (!Reserve(size, offset))
+        return false;
+
+    // The frame before a delta went with its group.
+    if (!keyframe && m_entries.empty())
+        return false;
+
+    memcpy(&m_buffer[offset], data, size);
+    m_entries.push_back({ offset, static_cast<uint32_t>(size), keyframe });
+    m_frames_since_keyframe = keyframe ? 0 : m_frames_since_keyframe + 1;
+    return true;
+}
+
+bool RewindBuffer::Reserve(size_t size, size_t& out_offset)
+{
+    if (size > m_buffer.size())
+    {
+        Clear();
+        return false;
+    }
+
+    // Entries are written one after the other and wrap to the start when the end is reached.
+    size_t offset = m_entries.empty() ? 0 : m_entries.back().offset + m_entries.back().size;
+    if (offset + size > m_buffer.size())
+        offset = 0;
+
+    // The oldest entries are the ones right after the write position.
+    while (!m_entries.empty() && m_entries.front().offset < offset + size && offset < m_entries.front().offset + m_entries.front().size)
+        DropOldest();
+
+    out_offset = offset;
+    return true;
+}
+
+void RewindBuffer::DropOldest()
+{
+    // Deltas can't be decoded without their keyframe, they go with it.
+    m_entries.pop_front();
+    while (!m_entries.empty() && !m_entries.front().keyframe)
+        m_entries.pop_front();
+}
+
+size_t RewindBuffer::EncodeDelta(const MachineState& current, const MachineState& previous, byte* out)
+{
+    const byte* current_bytes  = reinterpret_cast<const byte*>(&current);
+    const byte* previous_bytes = reinterpret_cast<const byte*>(&previous);
+
+    size_t size = 0;
+    size_t i    = 0;
+    while (i < NUM_WORDS)
+    {
+        const size_t zeros_start = i;
+        while (i < NUM_WORDS && LoadWord(current_bytes, i) == LoadWord(previous_bytes, i))
+            ++i;
+
+        const size_t changed_start = i;
+        while (i < NUM_WORDS && LoadWord(current_bytes, i) != LoadWord(previous_bytes, i))
+            ++i;
+
+        size += WriteVarint(&out[size], changed_start - zeros_start);
+        size += WriteVarint(&out[size], i - changed_start);
+
+        for (size_t word = changed_start; word < i; ++word)
+        {
+            const uint64_t delta = LoadWord(current_bytes, word) ^ LoadWord(previous_bytes, word);
+            memcpy(&out[size], &delta, sizeof(delta));
+            size += sizeof(delta);
+        }
+    }
+
+    assert(size <= MAX_DELTA_SIZE && "Delta bigger than its worst case");
+    return size;
+}
+
+void RewindBuffer::ApplyDelta(const byte* delta, size_t size, MachineState& state)
+{
+    byte*  state_bytes = reinterpret_cast<byte*>(&state);
+    size_t offset      = 0;
+    size_t word        = 0;
+
+    while (offset < size)
+    {
+        word += ReadVarint(delta, offset);
+
+        const size_t num_changed = ReadVarint(delta, offset);
+        for (size_t i = 0; i < num_changed; ++i, ++word, offset += sizeof(uint64_t))
+        {
+            uint64_t value = LoadWord(state_bytes, word);
+            uint64_t xor_value;
+            memcpy(&xor_value, &delta[offset], sizeof(xor_value));
+
+            value ^= xor_value;
+            memcpy(&state_bytes[word * sizeof(uint64_t)], &value, sizeof(value));
+        }
+    }
+}
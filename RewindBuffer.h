@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Types.h"
+#include "MachineState.h"
+#include <deque>
+#include <vector>
+
+/*
+    Rewind history.
+
+    Push captures the machine once per frame into a ring of fixed size (the memory cap). Every
+    keyframe_interval frames the whole MachineState is stored; the frames in between only store
+    the XOR with the previous frame, run-length encoded per 64-bit word:
+        zero words (varint) | changed words (varint) | XORed words ...
+    XOR works in both directions, so stepping back over a delta frame is a single decode of it.
+    Stepping back over a keyframe rebuilds the previous frame from the keyframe before it.
+
+    When the ring is full the oldest keyframe and its deltas are dropped together, so the history
+    always starts with a keyframe. A delta that would outlive its keyframe that way is stored as a
+    keyframe instead. The battery-backed cartridge RAM isn't part of the machine state, so
+    rewinding doesn't undo saves.
+*/
+class RewindBuffer
+{
+public:
+    RewindBuffer(size_t memory_cap, uint32_t keyframe_interval);
+
+    // Records state as the newest frame.
+    void Push (const MachineState& state);
+    // Copies the newest frame into state and forgets it. false when there is no history left.
+    bool Pop  (MachineState& state);
+    void Clear();
+
+    uint32_t GetNumFrames () const { return static_cast<uint32_t>(m_entries.size()); }
+    size_t   GetMemoryUsed() const;
+
+private:
+    struct Entry
+    {
+        size_t   offset; // In m_buffer.
+        uint32_t size;
+        bool     keyframe;
+    };
+
+private:
+    bool   Reserve       (size_t size, size_t& out_offset);
+    void   DropOldest    ();
+    // false when nothing was stored: no room at all, or a delta whose keyframe was dropped to make room.
+    bool   Store         (const byte* data, size_t size, bool keyframe);
+    void   RebuildNewest ();
+
+    static size_t EncodeDelta (const MachineState& current, const MachineState& previous, byte* out);
+    static void   ApplyDelta  (const byte* delta, size_t size, MachineState& state);
+
+private:
+    std::vector<byte>    m_buffer;
+    std::deque<Entry>    m_entries;          // Oldest first.
+    uint32_t             m_keyframe_interval;
+    uint32_t             m_frames_since_keyframe;
+    MachineState         m_newest;           // Decoded state of the newest entry.
+    std::vector<byte>    m_scratch;          // Delta being encoded.
+};
@@ -0,0 +1,13 @@
+#include "RomDatabase.h"
+#include "RomDatabaseEntries.h"
+#include <algorithm>
+
+const RomDatabaseEntry* RomDatabase::Find(uint32_t crc32)
+{
+    const RomDatabaseEntry* begin = std::begin(s_rom_database);
+    const RomDatabaseEntry* end   = std::end(s_rom_database);
+
+    const RomDatabaseEntry* entry = std::lower_bound(begin, end, crc32, [](const RomDatabaseEntry& entry, uint32_t crc32) { return entry.crc32 < crc32; });
+
+    return (entry != end && entry->crc32 == crc32) ? entry : nullptr;
+}
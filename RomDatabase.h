@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Types.h"
+#include "GameRom.h"
+
+enum RomQuirk : uint8_t
+{
+    ROM_QUIRK_NONE         = 0,
+    ROM_QUIRK_FM_SOUND     = 1 << 0, // Uses the YM2413 when present.
+    ROM_QUIRK_SMS1_VDP     = 1 << 1, // Relies on the 315-5124 (SMS 1) VDP behaviour.
+    ROM_QUIRK_LIGHT_PHASER = 1 << 2,
+    ROM_QUIRK_PADDLE       = 1 << 3,
+};
+
+struct RomDatabaseEntry
+{
+    uint32_t    crc32;
+    MemoryType  mapper; // MemoryType::None keeps the one guessed from the header.
+    VideoSystem region; // VideoSystem::Unknown keeps the one guessed from the header.
+    uint8_t     quirks; // RomQuirk flags.
+};
+
+/*
+    Known cartridges indexed by the CRC32 of their image.
+
+    The entries are generated from Resources/rom_database.txt (generate_rom_database.py) into a
+    sorted array compiled in the executable, so a lookup is a binary search without any loading.
+*/
+namespace RomDatabase
+{
+    // nullptr if the image isn't in the database.
+    const RomDatabaseEntry* Find(uint32_t crc32);
+};
@@ -0,0 +1,16 @@
+/*
+	Autogenerated File (generate_rom_database.py).
+*/
+
+#pragma once
+
+#include "RomDatabase.h"
+
+static const RomDatabaseEntry s_rom_database[] =
+{
+	{ 0x29822980, MemoryType::Codemasters, VideoSystem::PAL, 0 }, // Cosmic Spacehead
+	{ 0x8813514B, MemoryType::Codemasters, VideoSystem::PAL, 0 }, // Excellent Dizzy Collection, The (Prototype)
+	{ 0xA577CE46, MemoryType::Codemasters, VideoSystem::PAL, 0 }, // Micro Machines
+	{ 0xB9664AE1, MemoryType::Codemasters, VideoSystem::PAL, 0 }, // Fantastic Dizzy
+	{ 0xEA5C3A6F, MemoryType::Codemasters, VideoSystem::NTSC, 0 }, // Dinobasher Starring Bignose the Caveman (Prototype)
+};
@@ -0,0 +1,211 @@
+#include "RomLibrary.h"
+#include <algorithm>
+#include <ctype.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdio.h>
+#include <thread>
+#include <unordered_map>
+
+static constexpr char INDEX_MAGIC[4] = { 'S', 'M', 'S', 'L' };
+
+namespace
+{
+    // The index is always little endian whatever the host is.
+    void WriteLE(FILE* file, uint64_t value, uint32_t size)
+    {
+        byte bytes[8];
+        for (uint32_t i = 0; i < size; ++i)
+            bytes[i] = static_cast<byte>(value >> (i * 8));
+        fwrite(bytes, 1, size, file);
+    }
+
+    bool ReadLE(FILE* file, uint64_t& value, uint32_t size)
+    {
+        byte bytes[8];
+        if (fread(bytes, 1, size, file) != size)
+            return false;
+
+        value = 0;
+        for (uint32_t i = 0; i < size; ++i)
+            value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+        return true;
+    }
+}
+
+bool RomLibrary::LoadIndex(const std::string& index_path)
+{
+    m_entries.clear();
+
+    FILE* file = fopen(index_path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char     magic[4];
+    uint64_t version     = 0;
+    uint64_t num_entries = 0;
+
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, INDEX_MAGIC, sizeof(magic)) == 0 &&
+              ReadLE(file, version, 4) && version == INDEX_VERSION &&
+              ReadLE(file, num_entries, 4);
+
+    m_entries.reserve(ok ? static_cast<size_t>(num_entries) : 0);
+
+    for (uint64_t i = 0; ok && i < num_entries; ++i)
+    {
+        uint64_t file_size, modification_time, crc32, mapper, video_system, valid, path_length;
+
+        ok = ReadLE(file, file_size, 8) && ReadLE(file, modification_time, 8) && ReadLE(file, crc32, 4) &&
+             ReadLE(file, mapper, 1) && ReadLE(file, video_system, 1) && ReadLE(file, valid, 1) &&
+             ReadLE(file, path_length, 2);
+        if (!ok)
+            break;
+
+        RomLibraryEntry entry;
+        entry.path.resize(static_cast<size_t>(path_length));
+        ok = fread(&entry.path[0], 1, entry.path.size(), file) == entry.path.size();
+
+        entry.file_size         = file_size;
+        entry.modification_time = static_cast<int64_t>(modification_time);
+        entry.crc32             = static_cast<uint32_t>(crc32);
+        entry.mapper            = static_cast<MemoryType>(mapper);
+        entry.video_system      = static_cast<VideoSystem>(video_system);
+        entry.valid             = valid != 0;
+
+        m_entries.push_back(std::move(entry));
+    }
+
+    fclose(file);
+
+    // A damaged or outdated index is simply rebuilt by the next scan.
+    if (!ok)
+        m_entries.clear();
+
+    std::sort(m_entries.begin(), m_entries.end(), [](const RomLibraryEntry& a, const RomLibraryEntry& b) { return a.path < b.path; });
+    return ok;
+}
+
+bool RomLibrary::SaveIndex(const std::string& index_path) const
+{
+    FILE* file = fopen(index_path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    fwrite(INDEX_MAGIC, 1, sizeof(INDEX_MAGIC), file);
+    WriteLE(file, INDEX_VERSION, 4);
+    WriteLE(file, m_entries.size(), 4);
+
+    for (const RomLibraryEntry& entry : m_entries)
+    {
+        WriteLE(file, entry.file_size, 8);
+        WriteLE(file, static_cast<uint64_t>(entry.modification_time), 8);
+        WriteLE(file, entry.crc32, 4);
+        WriteLE(file, static_cast<byte>(entry.mapper), 1);
+        WriteLE(file, static_cast<byte>(entry.video_system), 1);
+        WriteLE(file, entry.valid ? 1 : 0, 1);
+        WriteLE(file, entry.path.size(), 2);
+        fwrite(entry.path.data(), 1, entry.path.size(), file);
+    }
+
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+RomLibraryScanStats RomLibrary::Scan(const std::string& root_path, uint32_t num_threads)
+{
+    namespace fs = std::filesystem;
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    RomLibraryScanStats stats = {};
+
+    std::unordered_map<std::string, const RomLibraryEntry*> indexed;
+    for (const RomLibraryEntry& entry : m_entries)
+        indexed[entry.path] = &entry;
+
+    // Walking the tree is cheap compared to opening the files, it stays on this thread.
+    std::vector<RomLibraryEntry> entries;
+    std::vector<uint32_t>        to_scan;
+    uint32_t                     num_indexed_found = 0;
+
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(root_path, fs::directory_options::skip_permission_denied, error), end; !error && it != end; it.increment(error))
+    {
+        if (!it->is_regular_file(error) || !IsRomFile(it->path().string()))
+            continue;
+
+        RomLibraryEntry entry = {};
+        entry.path              = it->path().generic_string();
+        entry.file_size         = it->file_size(error);
+        entry.modification_time = static_cast<int64_t>(it->last_write_time(error).time_since_epoch().count());
+
+        const auto previous = indexed.find(entry.path);
+        num_indexed_found += previous != indexed.end() ? 1 : 0;
+
+        if (previous != indexed.end() && previous->second->file_size == entry.file_size && previous->second->modification_time == entry.modification_time)
+        {
+            entries.push_back(*previous->second);
+        }
+        else
+        {
+            to_scan.push_back(static_cast<uint32_t>(entries.size()));
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    stats.num_files   = static_cast<uint32_t>(entries.size());
+    stats.num_scanned = static_cast<uint32_t>(to_scan.size());
+    stats.num_removed = static_cast<uint32_t>(m_entries.size()) - num_indexed_found;
+
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min<uint32_t>(num_threads, std::max<uint32_t>(1, stats.num_scanned));
+
+    // Workers pull files from a shared counter, so slow files don't hold a whole batch back.
+    std::atomic<uint32_t> next_file(0);
+    auto worker = [&]()
+    {
+        for (uint32_t i = next_file.fetch_add(1, std::memory_order_relaxed); i < to_scan.size(); i = next_file.fetch_add(1, std::memory_order_relaxed))
+            ScanFile(entries[to_scan[i]]);
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::sort(entries.begin(), entries.end(), [](const RomLibraryEntry& a, const RomLibraryEntry& b) { return a.path < b.path; });
+    m_entries = std::move(entries);
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return stats;
+}
+
+bool RomLibrary::IsRomFile(const std::string& path)
+{
+    const size_t extension = path.find_last_of('.');
+    if (extension == std::string::npos)
+        return false;
+
+    std::string lower = path.substr(extension);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+
+    return lower == ".sms" || lower == ".zip" || lower == ".gz";
+}
+
+void RomLibrary::ScanFile(RomLibraryEntry& entry)
+{
+    // GameRom maps the file, finds the header (GameRom::FindHeaderAddress), hashes the image and
+    // resolves it in the ROM database, exactly what loading the game would do.
+    const GameRom game_rom(entry.path);
+
+    entry.crc32        = game_rom.GetCrc32();
+    entry.mapper       = game_rom.GetMemoryType();
+    entry.video_system = game_rom.GetVideoSystem();
+    entry.valid        = game_rom.IsValid();
+}
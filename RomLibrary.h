@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Types.h"
+#include "GameRom.h"
+#include <string>
+#include <vector>
+
+struct RomLibraryEntry
+{
+    std::string path;
+    uint64_t    file_size;
+    int64_t     modification_time; // Only compared for equality, in the file system clock units.
+    uint32_t    crc32;
+    MemoryType  mapper;
+    VideoSystem video_system;
+    bool        valid;
+};
+
+struct RomLibraryScanStats
+{
+    uint32_t num_files;     // ROMs found in the tree.
+    uint32_t num_scanned;   // New or modified ROMs that had to be opened.
+    uint32_t num_removed;   // Index entries whose file doesn't exist anymore.
+    double   seconds;
+};
+
+/*
+    ROM library.
+
+    Scan walks a directory tree (.sms files and gzip/zip archives) and loads every new or modified
+    ROM (size or modification time changed) on a pool of worker threads; each one maps the file,
+    finds the header and hashes it through GameRom. Unchanged files keep their entry from the index.
+
+    The index is a little-endian binary file:
+        "SMSL" | version (u32) | entry count (u32)
+        per entry: file size (u64) | modification time (i64) | crc32 (u32) | mapper (u8) | video system (u8) | valid (u8) | path length (u16) | path
+*/
+class RomLibrary
+{
+public:
+    static constexpr uint32_t INDEX_VERSION = 1;
+
+public:
+    bool LoadIndex (const std::string& index_path);
+    bool SaveIndex (const std::string& index_path) const;
+
+    // num_threads = 0 uses one thread per hardware thread.
+    RomLibraryScanStats Scan(const std::string& root_path, uint32_t num_threads = 0);
+
+    const std::vector<RomLibraryEntry>& GetEntries() const { return m_entries; }
+
+private:
+    static bool IsRomFile (const std::string& path);
+    static void ScanFile  (RomLibraryEntry& entry);
+
+private:
+    std::vector<RomLibraryEntry> m_entries; // Sorted by path.
+};
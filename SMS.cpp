@@ -5,10 +5,25 @@
 #include "ExternalInterface/ImGUIWrapper.h"
 #include "ExternalInterface/SDLInterface.h"
 #include "IODevice.h"
+#include "PSG.h"
+#include "YM2413.h"
+#include "Memory.h"
+#include "MachineState.h"
+#include "SaveState.h"
+#include "RewindBuffer.h"
+#include "AudioRing.h"
+#include "Movie.h"
+#include "Crc32.h"
+#include "Debug/Profiler.h"
+#include "Debug/Debugger.h"
+#include "Debug/Z80DisassemblyCache.h"
 
 #include "SDL.h"
 
 #include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -18,35 +33,109 @@
 const SystemInfo NTSCSystemInfo = SystemInfo(53693175, 262, 59.922743f, 896040);
 const SystemInfo PALSystemInfo  = SystemInfo(53203424, 313, 49.701459f, 1070460);
 
+// Z80 runs at 1/15 of the master clock (VDP pixel clock is 1/10).
+constexpr uint32_t MASTER_CYCLES_PER_CPU_CYCLE = 15;
+
+// How often the dirty cartridge RAM pages are handed to the OS to be written to the save file.
+constexpr std::chrono::seconds SAVE_FLUSH_INTERVAL(1);
+
+// Rewind history: a full snapshot every second, deltas in between. 64MB holds several minutes.
+constexpr size_t   REWIND_MEMORY_CAP        = 64 * 1024 * 1024;
+constexpr uint32_t REWIND_KEYFRAME_INTERVAL = 60;
+
+// Samples between the emulation and the audio device, about 186ms at 44.1kHz. The device only starts
+// once a few frames are queued, so the first callbacks don't underrun.
+constexpr uint32_t AUDIO_RING_CAPACITY = 8192;
+constexpr uint32_t AUDIO_START_LATENCY = SMS::AUDIO_SAMPLE_RATE / 20;
+
+// Audio pacing keeps that much queued and corrects the sample rate by up to 0.5% to stay there,
+// a pitch change too small to hear.
+constexpr uint32_t AUDIO_TARGET_LATENCY  = AUDIO_START_LATENCY;
+constexpr double   MAX_RATE_ADJUSTMENT   = 0.005;
+
+// Video pacing sleeps until that long before the frame is due and spins the rest, sleeps overshoot.
+constexpr std::chrono::microseconds SPIN_MARGIN(1500);
+
+// Beyond a few frames the shown frame drifts too far from what the input actually changed.
+constexpr uint32_t MAX_RUN_AHEAD_FRAMES = 4;
+
+// What the forks of one state read their pages from. Never modified once taken.
+struct SMS::ForkSnapshot
+{
+    MachineState      state;
+    std::vector<byte> cartridge_ram; // Save file RAM, empty if it wasn't open.
+};
+
 SystemInfo::SystemInfo(uint32_t _master_clock_cycles, uint32_t _lines_per_frame, float _fps, uint32_t _max_cycles_per_frame) :
     master_clock_cycles(_master_clock_cycles), lines_per_frame(_lines_per_frame), fps(_fps), max_machine_cycles_per_frame(_max_cycles_per_frame)
 {
     assert(fps > 0 && "Invalid FPS provided");
     assert(lines_per_frame && "Invalid number of line per frame provided");
-    cycles_per_line = static_cast<uint32_t>(floor(clock_speed / lines_per_frame / fps));
+    cycles_per_line = max_machine_cycles_per_frame / lines_per_frame;
     frame_target_time = 1000.0 / fps; // 1 second / fps
     max_clock_cycles_per_frame = max_machine_cycles_per_frame / fps;
 }
 
-SMS::SMS()
+SMS::SMS(MachineStatePool* pool)
 {
-    m_cpu			= new Z80();
-    m_vdp			= new VDP();
-    m_io_device     = new IODevice();
+    m_state_pool    = pool;
+    m_state         = pool ? pool->Acquire() : new MachineState();
+    m_memory        = new Memory(m_state->memory);
+    m_cpu			= new Z80(m_state->cpu, m_memory);
+    m_vdp			= new VDP(m_state->vdp);
+    m_io_device     = new IODevice(m_state->io);
+    m_psg           = new PSG(m_state->psg);
+    m_fm            = new YM2413(m_state->fm);
+    m_fm_enabled    = false;
     m_sdl_interface = new SDLInterface();
-    m_game_rom		= nullptr;
+    m_profiler      = new Profiler();
+    m_debugger      = new Debugger();
+    m_disassembly   = new Z80DisassemblyCache();
+    m_rewind        = nullptr;
+    m_rewind_memory = REWIND_MEMORY_CAP;
+    m_render_enabled          = true;
+    m_skip_frame              = false;
+    m_frame_skip              = 0;
+    m_frames_skipped          = 0;
+    m_run_ahead_frames        = 0;
+    m_run_ahead_state         = nullptr;
+    m_run_ahead_cartridge_ram = nullptr;
+    m_movie                   = nullptr;
+    m_audio_ring              = nullptr;
+    m_frame_pacing            = FramePacing::Audio;
+    m_audio_rate_adjustment   = 1.0;
 
     // Init
     m_cpu->SetContext(Z80Context(m_io_device));
     m_vdp->SetContext(VDPContext(m_cpu));
-    m_io_device->SetContext(IODeviceContext(m_vdp));
+    m_io_device->SetContext(IODeviceContext(m_vdp, m_psg));
+    m_psg->SetContext(PSGContext(m_cpu));
+    m_fm->SetContext(YM2413Context(m_cpu));
 }
 
 SMS::~SMS()
 {
     delete m_cpu;
     delete m_vdp;
-    delete m_game_rom;
+    delete m_psg;
+    delete m_fm;
+    delete m_io_device;
+    delete m_memory;
+    delete m_profiler;
+    delete m_debugger;
+    delete m_disassembly;
+    StopRecording();
+
+    delete m_rewind;
+    delete m_sdl_interface;
+    delete m_audio_ring;
+    delete m_run_ahead_state;
+    delete[] m_run_ahead_cartridge_ram;
+
+    if (m_state_pool)
+        m_state_pool->Release(m_state);
+    else
+        delete m_state;
 }
 
 void SMS::Launch(const char* path)
@@ -63,68 +152,480 @@ void SMS::Launch(const char* path)
 
     ImGUIWrapper::Init(m_sdl_interface);
 
-    std::chrono::time_point<std::chrono::steady_clock> last_frame_time;
+    if (!m_rewind)
+        m_rewind = new RewindBuffer(m_rewind_memory, REWIND_KEYFRAME_INTERVAL);
+
+    if (!m_audio_ring)
+        m_audio_ring = new AudioRing(AUDIO_RING_CAPACITY);
+
+    bool audio_started = false;
+    const bool audio_open = m_sdl_interface->InitAudio(AUDIO_SAMPLE_RATE, m_audio_ring);
+    if (!audio_open)
+        std::cout << "Couldn't open the audio device: " << SDL_GetError() << std::endl;
+
+    std::chrono::time_point<std::chrono::steady_clock> last_save_flush = std::chrono::steady_clock::now();
+    m_next_frame_time = std::chrono::steady_clock::now();
+
+    // Achieved speed, over the frames emulated in the last half second.
+    std::chrono::time_point<std::chrono::steady_clock> speed_start = std::chrono::steady_clock::now();
+    uint32_t speed_frames = 0;
+    double   speed        = 1.0;
 
     bool exit = false;
     while (!exit)
     {
         const std::chrono::time_point<std::chrono::steady_clock> current_frame = std::chrono::steady_clock::now();
-
-        const auto delta_time = std::chrono::duration<double, std::milli>(current_frame - last_frame_time);
-        last_frame_time = current_frame;
-
-        const double time_diff = m_system_info.frame_target_time - delta_time.count();
+        const bool fast_forward = m_sdl_interface->IsFastForwardHeld();
+        bool emulated = false;
 
         SDL_Event event;
         while (SDL_PollEvent(&event))
         {
             ImGUIWrapper::ProcessEvent(&event);
             exit = m_sdl_interface->ExitRequested(event);
+
+            if (m_sdl_interface->SaveStateRequested(event) && !SaveStateToFile(m_game_rom->GetSiblingPath(".state").c_str()))
+                std::cout << "Couldn't write the save state" << std::endl;
+
+            if (m_sdl_interface->LoadStateRequested(event) && !LoadStateFromFile(m_game_rom->GetSiblingPath(".state").c_str()))
+                std::cout << "Couldn't load the save state" << std::endl;
         }
 
         if (m_game_rom && m_game_rom->IsValid())
         {
-            Tick();
-            
+            m_skip_frame = ShouldSkipFrame(current_frame, fast_forward);
+            m_vdp->SetRenderEnabled(m_render_enabled && !m_skip_frame);
+
+            if (m_debugger->IsPaused())
+            {
+                if (m_debugger->ConsumeStep())
+                    StepInstruction();
+            }
+            else if (m_sdl_interface->IsRewindHeld())
+            {
+                Rewind();
+                emulated = true;
+            }
+            else
+            {
+                Unshare();
+                m_rewind->Push(*m_state);
+                EmulateFrame(m_sdl_interface->ReadButtons());
+                emulated = true;
+            }
+
+            QueueAudio(fast_forward);
+            if (!audio_started && m_audio_ring->GetNumQueued() >= AUDIO_START_LATENCY)
+            {
+                m_sdl_interface->SetAudioPaused(false);
+                audio_started = true;
+            }
+
             // Render results
             // m_sdl_interface->RenderFrame(m_vdp->GetFrameBuffer());
+
+            // Only schedules the write of the dirty save pages, the file is synced when the game is unloaded.
+            if (current_frame - last_save_flush >= SAVE_FLUSH_INTERVAL)
+            {
+                m_game_rom->FlushCartridgeRam();
+                last_save_flush = current_frame;
+            }
+        }
+
+        speed_frames += emulated ? 1 : 0;
+        const double speed_seconds = std::chrono::duration<double>(current_frame - speed_start).count();
+        if (speed_seconds >= 0.5)
+        {
+            speed        = speed_frames / speed_seconds / m_system_info.fps;
+            speed_frames = 0;
+            speed_start  = current_frame;
         }
 
         ImGUIWrapper::NewFrame();
         ImGUIWrapper::DrawRegisters(m_cpu);
+        ImGUIWrapper::DrawProfiler(m_profiler, m_cpu->GetMemory(), m_game_rom.get());
+        ImGUIWrapper::DrawDebugger(m_debugger, m_cpu);
+        ImGUIWrapper::DrawDisassembly(m_disassembly, m_debugger, m_cpu);
+        ImGUIWrapper::DrawAudio(m_audio_ring, AUDIO_SAMPLE_RATE, m_audio_rate_adjustment);
+        ImGUIWrapper::DrawSpeed(speed, fast_forward, &m_frame_skip, MAX_FRAME_SKIP);
         ImGUIWrapper::Render(m_sdl_interface);
 
-        if (time_diff > 0)
-        {
-           // std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(time_diff));
-        }
+        // Fast-forward runs uncapped. Paused in the debugger there is no sound to wait on, the UI still
+        // runs at the frame rate.
+        if (fast_forward)
+            m_next_frame_time = std::chrono::steady_clock::now();
+        else
+            WaitForNextFrame(m_frame_pacing == FramePacing::Audio && audio_open && audio_started && emulated);
     }
 
+    StopRecording();
+
     ImGUIWrapper::Shutdown();
     m_sdl_interface->Quit();
 }
 
+bool SMS::RunHeadless(const char* path, uint32_t num_frames, const char* profile_report_path, const char* load_state_path, const char* save_state_path)
+{
+    assert(m_cpu != nullptr);
+    assert(m_vdp != nullptr);
+
+    if (!LoadGame(path))
+        return false;
+
+    if (load_state_path && !LoadStateFromFile(load_state_path))
+        return false;
+
+    m_profiler->SetEnabled(profile_report_path != nullptr);
+
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        EmulateFrame(0);
+    }
+
+    if (profile_report_path)
+    {
+        FILE* file = fopen(profile_report_path, "w");
+        if (!file)
+            return false;
+
+        m_profiler->WriteReport(file, *m_cpu->GetMemory(), *m_game_rom, 100);
+        fclose(file);
+    }
+
+    return !save_state_path || SaveStateToFile(save_state_path);
+}
+
+bool SMS::PlayMovie(const char* path, const char* movie_path)
+{
+    Movie movie;
+    if (!movie.Load(movie_path))
+    {
+        std::cout << "Couldn't read the movie " << movie_path << std::endl;
+        return false;
+    }
+
+    // The movie is replayed on the hardware it was recorded on.
+    SetFMEnabled((movie.GetFlags() & Movie::MOVIE_FLAG_FM) != 0);
+
+    if (!LoadGame(path) || movie.GetRomCrc32() != m_game_rom->GetCrc32())
+    {
+        std::cout << "The movie wasn't recorded with " << path << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t frame = 0; frame < movie.GetNumFrames(); ++frame)
+    {
+        SetInput(movie.GetButtons(frame));
+        Tick();
+
+        const uint32_t hash = GetStateHash();
+        if (hash != movie.GetStateHash(frame))
+        {
+            std::cout << "Desync at frame " << frame << ": state hash " << std::hex << hash << " instead of " << movie.GetStateHash(frame) << std::dec << std::endl;
+            return false;
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << movie.GetNumFrames() << " frames replayed in " << seconds << "s (" << movie.GetNumFrames() / seconds << " fps)" << std::endl;
+    return true;
+}
+
+void SMS::SetMovieRecording(const char* movie_path)
+{
+    StopRecording();
+    m_movie_path = movie_path ? movie_path : "";
+}
+
+void SMS::EmulateFrame(uint16_t buttons)
+{
+    SetInput(buttons);
+    m_run_ahead_frames > 0 ? RunAheadFrame() : Tick();
+
+    if (m_movie)
+        m_movie->AddFrame(buttons, GetStateHash());
+}
+
+void SMS::SetInput(uint16_t buttons)
+{
+    m_fork_snapshot.reset();
+
+    // The pause button is wired to the NMI, which is edge triggered.
+    if ((buttons & BUTTON_PAUSE) && !(m_io_device->GetButtons() & BUTTON_PAUSE))
+        m_cpu->RequestNMI();
+
+    m_io_device->SetButtons(buttons);
+}
+
+uint32_t SMS::GetStateHash() const
+{
+    Unshare();
+    return Crc32::Compute(reinterpret_cast<const byte*>(m_state), sizeof(MachineState));
+}
+
+void SMS::StopRecording()
+{
+    if (!m_movie)
+        return;
+
+    if (!m_movie->Save(m_movie_path))
+        std::cout << "Couldn't write the movie " << m_movie_path << std::endl;
+
+    delete m_movie;
+    m_movie = nullptr;
+    m_movie_path.clear();
+}
+
+bool SMS::SaveState(std::vector<byte>& data) const
+{
+    if (!m_game_rom || !m_game_rom->IsValid())
+        return false;
+
+    Unshare();
+    SaveState::Write(*m_state, m_game_rom->GetCrc32(), m_memory->HasCartridgeRam() ? m_memory->GetCartridgeRam() : nullptr, data);
+    return true;
+}
+
+bool SMS::LoadState(const std::vector<byte>& data)
+{
+    if (!m_game_rom || !m_game_rom->IsValid())
+        return false;
+
+    // The whole state is overwritten, nothing can stay shared.
+    Unshare();
+
+    const byte* cartridge_ram = nullptr;
+    if (!SaveState::Read(data.data(), data.size(), m_game_rom->GetCrc32(), *m_state, cartridge_ram))
+        return false;
+
+    byte* destination = cartridge_ram ? m_memory->GetCartridgeRam() : nullptr;
+    if (destination)
+        memcpy(destination, cartridge_ram, GameRom::CARTRIDGE_RAM_SIZE);
+
+    // The page table points into the previous bank selection.
+    m_memory->RefreshMapping();
+    m_psg->Resync();
+    m_fm->Resync();
+    m_fork_snapshot.reset();
+    if (m_rewind)
+        m_rewind->Clear();
+
+    // A movie is a single run from power on, it can't jump to another state.
+    StopRecording();
+    return true;
+}
+
+bool SMS::SaveStateToFile(const char* path) const
+{
+    std::vector<byte> data;
+    return SaveState(data) && SaveState::WriteFile(path, data);
+}
+
+bool SMS::LoadStateFromFile(const char* path)
+{
+    std::vector<byte> data;
+    return SaveState::ReadFile(path, data) && LoadState(data);
+}
+
+void SMS::SetRewindMemory(size_t memory_cap)
+{
+    m_rewind_memory = memory_cap;
+
+    if (m_rewind)
+    {
+        delete m_rewind;
+        m_rewind = new RewindBuffer(m_rewind_memory, REWIND_KEYFRAME_INTERVAL);
+    }
+}
+
+void SMS::Rewind()
+{
+    // The frame is run again from its snapshot so the frame buffer shows it. It isn't recorded,
+    // the next step back continues from the frame before.
+    Unshare();
+
+    if (m_rewind->Pop(*m_state))
+    {
+        StopRecording();
+        m_memory->RefreshMapping();
+        m_psg->Resync();
+        m_fm->Resync();
+        Tick();
+    }
+}
+
+void SMS::SetRunAhead(uint32_t num_frames)
+{
+    m_run_ahead_frames = num_frames < MAX_RUN_AHEAD_FRAMES ? num_frames : MAX_RUN_AHEAD_FRAMES;
+
+    if (m_run_ahead_frames > 0 && !m_run_ahead_state)
+    {
+        m_run_ahead_state         = new MachineState();
+        m_run_ahead_cartridge_ram = new byte[GameRom::CARTRIDGE_RAM_SIZE];
+    }
+}
+
+void SMS::RunAheadFrame()
+{
+    // The profiler and the debugger would see the speculative frames, they get the plain loop.
+    if (m_profiler->IsEnabled() || m_debugger->IsActive())
+    {
+        Tick();
+        return;
+    }
+
+    // The real frame, nobody sees it. It is the one heard though, the speculative ones are silent.
+    m_vdp->SetRenderEnabled(false);
+    Tick();
+    m_psg->SetOutputEnabled(false);
+    m_fm->SetOutputEnabled(false);
+
+    byte* cartridge_ram = m_memory->HasCartridgeRam() ? m_memory->GetCartridgeRam() : nullptr;
+
+    Unshare();
+    memcpy(m_run_ahead_state, m_state, sizeof(MachineState));
+    if (cartridge_ram)
+        memcpy(m_run_ahead_cartridge_ram, cartridge_ram, GameRom::CARTRIDGE_RAM_SIZE);
+
+    // Frames ahead with the same input, only the last one is drawn and shown.
+    const bool draw = m_render_enabled && !m_skip_frame;
+    for (uint32_t frame = 0; frame < m_run_ahead_frames; ++frame)
+    {
+        m_vdp->SetRenderEnabled(draw && frame + 1 == m_run_ahead_frames);
+        Tick();
+    }
+
+    memcpy(m_state, m_run_ahead_state, sizeof(MachineState));
+    if (cartridge_ram)
+        memcpy(cartridge_ram, m_run_ahead_cartridge_ram, GameRom::CARTRIDGE_RAM_SIZE);
+
+    m_memory->RefreshMapping();
+    m_vdp->SetRenderEnabled(draw);
+    m_psg->SetOutputEnabled(true);
+    m_psg->Resync();
+    m_fm->SetOutputEnabled(true);
+    m_fm->Resync();
+}
+
+void SMS::SetRenderEnabled(bool enabled)
+{
+    m_render_enabled = enabled;
+    m_vdp->SetRenderEnabled(enabled);
+}
+
+void SMS::SetFrameSkip(uint32_t frame_skip)
+{
+    m_frame_skip     = frame_skip < MAX_FRAME_SKIP ? frame_skip : MAX_FRAME_SKIP;
+    m_frames_skipped = 0;
+}
+
+bool SMS::ShouldSkipFrame(std::chrono::steady_clock::time_point now, bool fast_forward)
+{
+    // Fast-forward draws at the normal frame rate whatever the speed, everything in between is skipped.
+    if (fast_forward)
+    {
+        const std::chrono::duration<double, std::milli> since_drawn = now - m_last_drawn_time;
+        if (since_drawn.count() < m_system_info.frame_target_time)
+            return true;
+
+        m_last_drawn_time = now;
+        return false;
+    }
+
+    if (m_frames_skipped < m_frame_skip)
+    {
+        ++m_frames_skipped;
+        return true;
+    }
+
+    m_frames_skipped  = 0;
+    m_last_drawn_time = now;
+    return false;
+}
+
 void SMS::Tick()
+{
+    m_fork_snapshot.reset();
+
+    // Watchpoints replace the memory path only while there is something to watch.
+    m_cpu->GetMemory()->SetWatchpoints(m_debugger->HasWatchpoints() ? m_debugger : nullptr);
+
+    // The instrumented loops are separate instantiations, so normal play doesn't pay for them.
+    const bool profile = m_profiler->IsEnabled();
+    const bool debug   = m_debugger->IsActive();
+
+    if (profile)
+        debug ? RunFrame<true, true>()  : RunFrame<true, false>();
+    else
+        debug ? RunFrame<false, true>() : RunFrame<false, false>();
+
+    m_psg->EndFrame(m_cpu->GetTotalCycles());
+    if (m_fm_enabled)
+        m_fm->EndFrame(m_cpu->GetTotalCycles());
+}
+
+void SMS::StepInstruction()
+{
+    m_fork_snapshot.reset();
+
+    m_cpu->GetMemory()->SetWatchpoints(m_debugger->HasWatchpoints() ? m_debugger : nullptr);
+
+    m_debugger->Continue();
+
+    const uint32_t cycles = m_cpu->Tick();
+    m_vdp->Tick(cycles * MASTER_CYCLES_PER_CPU_CYCLE);
+
+    // Stay paused on the next instruction unless a watchpoint already stopped us.
+    m_debugger->RequestBreak(Debugger::BreakReason::Step, m_cpu->m_state.program_counter);
+}
+
+template<bool PROFILE, bool DEBUG>
+void SMS::RunFrame()
 {
     uint32_t total_cycles = 0;
     bool vblank = false;
+    bool paused = false;
 
-    while (!vblank)
+    while (!vblank && !paused)
     {
-        const uint32_t cycles = m_cpu->Tick();
+        // The VDP only changes its state (counters, interrupts, rendering) at the end of a line,
+        // so the CPU runs a whole block up to that event before the VDP is ticked once.
+        const uint32_t next_event = m_vdp->GetCyclesToNextEvent();
+
+        uint32_t block_cycles = 0;
+        while (block_cycles < next_event)
+        {
+            const word pc = m_cpu->m_state.program_counter;
+
+            if (DEBUG && m_debugger->ShouldBreakAt(pc))
+            {
+                paused = true;
+                break;
+            }
+
+            const uint32_t cycles = m_cpu->Tick();
 
-        // Z80 runs at 1/3 the speed of the machine clock
-        const uint32_t machine_cycles = cycles * 3;
-        
-        // VDP runs at half the speed of the machine clock
-        const uint32_t vpd_cycles = machine_cycles / 2;
-        
-        vblank = m_vdp->Tick(vpd_cycles);
+            if (PROFILE)
+                m_profiler->Record(*m_cpu->GetMemory(), pc, cycles);
 
-        total_cycles += machine_cycles;
+            block_cycles += cycles * MASTER_CYCLES_PER_CPU_CYCLE;
+
+            // Watchpoints stop right after the instruction that accessed the address.
+            if (DEBUG && m_debugger->IsPaused())
+            {
+                paused = true;
+                break;
+            }
+        }
+
+        vblank = m_vdp->Tick(block_cycles);
+
+        total_cycles += block_cycles;
 
         // if we are above the maximum master cycles per frame, force the vblank (just in case).
-        if (total_cycles >= m_system_info.max_clock_cycles_per_frame)
+        if (total_cycles >= m_system_info.max_machine_cycles_per_frame)
         {
             vblank = true;
         }
@@ -135,26 +636,210 @@ bool SMS::LoadGame(const char* path)
 {
     // TODO: Reuse m_game_rom.
 
-    delete m_game_rom;
-    m_game_rom = new GameRom(path);
+    // A previous fork keeps reading the snapshot until everything is copied.
+    Unshare();
+    m_fork_snapshot.reset();
+    m_shared_snapshot.reset();
+
+    m_game_rom = std::make_shared<GameRom>(path);
 
     if (m_game_rom->IsValid())
     {
         m_system_info = IsNTSC(*m_game_rom) ? NTSCSystemInfo : PALSystemInfo; 
 
         m_vdp->SetVideoSystemInfo(m_system_info.lines_per_frame, m_system_info.cycles_per_line);
+        m_vdp->SetPal(!IsNTSC(*m_game_rom));
 
         m_cpu->LoadGame(*m_game_rom);
+        m_io_device->SetButtons(0);
+
+        m_psg->SetOutputRate(m_system_info.master_clock_cycles / MASTER_CYCLES_PER_CPU_CYCLE, AUDIO_SAMPLE_RATE);
+        m_psg->Reset(m_cpu->GetTotalCycles());
+        m_fm->SetOutputRate(m_system_info.master_clock_cycles / MASTER_CYCLES_PER_CPU_CYCLE, AUDIO_SAMPLE_RATE);
+        m_fm->Reset(m_cpu->GetTotalCycles());
+
+        m_profiler->Reset(static_cast<uint32_t>(m_game_rom->GetSize()));
+        m_disassembly->Reset(static_cast<uint32_t>(m_game_rom->GetSize()));
+        if (m_rewind)
+            m_rewind->Clear();
+
+        // Movies start from power on.
+        if (!m_movie_path.empty())
+        {
+            delete m_movie;
+            m_movie = new Movie(m_game_rom->GetCrc32(), m_fm_enabled ? Movie::MOVIE_FLAG_FM : 0);
+        }
 
         return true;
     }
     return false;
 }
 
+SMS* SMS::Fork(MachineStatePool* pool)
+{
+    if (!m_game_rom || !m_game_rom->IsValid())
+        return nullptr;
+
+    // Every fork of the same state shares one snapshot, only the first one copies the whole machine.
+    if (!m_fork_snapshot)
+    {
+        Unshare();
+
+        std::shared_ptr<ForkSnapshot> snapshot = std::make_shared<ForkSnapshot>();
+        memcpy(&snapshot->state, m_state, sizeof(MachineState));
+
+        if (m_memory->HasCartridgeRam())
+        {
+            const byte* cartridge_ram = m_memory->GetCartridgeRam();
+            snapshot->cartridge_ram.assign(cartridge_ram, cartridge_ram + GameRom::CARTRIDGE_RAM_SIZE);
+        }
+
+        m_fork_snapshot = snapshot;
+    }
+
+    const ForkSnapshot& snapshot = *m_fork_snapshot;
+    const MachineState& source   = snapshot.state;
+
+    SMS* child = new SMS(pool);
+    child->m_game_rom        = m_game_rom;
+    child->m_shared_snapshot = m_fork_snapshot;
+    child->m_system_info     = m_system_info;
+    child->SetRenderEnabled(m_render_enabled);
+    child->SetFMEnabled(m_fm_enabled);
+
+    // Everything but the RAM and the VRAM is copied, those are read from the snapshot until written.
+    static_assert(offsetof(VDPState, vram) == 0, "VRAM is expected first in the VDP state");
+
+    MachineState& state = *child->m_state;
+    state.cpu = source.cpu;
+    state.io  = source.io;
+    state.psg = source.psg;
+    state.fm  = source.fm;
+    memcpy(reinterpret_cast<byte*>(&state.vdp) + sizeof(VDPState::vram), reinterpret_cast<const byte*>(&source.vdp) + sizeof(VDPState::vram), sizeof(VDPState) - sizeof(VDPState::vram));
+
+    child->m_vdp->ShareVRam(source.vdp.vram);
+    child->m_memory->LoadSharedRom(*m_game_rom, source.memory, snapshot.cartridge_ram.empty() ? nullptr : snapshot.cartridge_ram.data());
+    child->m_psg->Resync();
+    child->m_fm->Resync();
+
+    return child;
+}
+
+void SMS::SetFMEnabled(bool enabled)
+{
+    // The unit starts from power on whenever it appears, from the current cycle.
+    // A movie records the hardware from power on, it can't follow a change in the middle.
+    if (enabled != m_fm_enabled)
+        StopRecording();
+
+    if (enabled && !m_fm_enabled)
+    {
+        m_fork_snapshot.reset();
+        m_fm->Reset(m_cpu->GetTotalCycles());
+    }
+
+    m_fm_enabled = enabled;
+    m_io_device->SetContext(IODeviceContext(m_vdp, m_psg, enabled ? m_fm : nullptr));
+}
+
+uint32_t SMS::ReadAudio(int16_t* out, uint32_t max_samples)
+{
+    const uint32_t count = m_psg->GetOutput().ReadSamples(out, max_samples);
+    if (!m_fm_enabled)
+        return count;
+
+    if (!m_fm->IsPSGAudible())
+        memset(out, 0, count * sizeof(int16_t));
+
+    // Both chips end their frames on the same cycle, so the FM has the same number of samples ready.
+    int16_t fm[256];
+    for (uint32_t mixed = 0; mixed < count;)
+    {
+        const uint32_t chunk = m_fm->GetOutput().ReadSamples(fm, std::min<uint32_t>(count - mixed, sizeof(fm) / sizeof(fm[0])));
+        if (chunk == 0)
+            break;
+
+        for (uint32_t i = 0; i < chunk; ++i)
+        {
+            const int32_t sample = out[mixed + i] + fm[i];
+            out[mixed + i] = static_cast<int16_t>(sample < -32768 ? -32768 : (sample > 32767 ? 32767 : sample));
+        }
+        mixed += chunk;
+    }
+    return count;
+}
+
+void SMS::QueueAudio(bool fast_forward)
+{
+    // Through a small stack buffer: a frame is under 1000 samples, this is one or two passes.
+    int16_t samples[512];
+    while (const uint32_t count = ReadAudio(samples, sizeof(samples) / sizeof(samples[0])))
+    {
+        if (!fast_forward || m_audio_ring->GetNumQueued() < AUDIO_TARGET_LATENCY)
+            m_audio_ring->Write(samples, count);
+    }
+}
+
+void SMS::WaitForNextFrame(bool audio_paced)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (audio_paced)
+    {
+        // The frame just queued is played in real time by the device: waiting for the queue to get back
+        // to the target runs the game exactly at the device clock.
+        const uint32_t queued = m_audio_ring->GetNumQueued();
+        if (queued > AUDIO_TARGET_LATENCY)
+            std::this_thread::sleep_for(std::chrono::duration<double>(static_cast<double>(queued - AUDIO_TARGET_LATENCY) / AUDIO_SAMPLE_RATE));
+
+        // Sleeps overshoot and the device reads in blocks, so the queue wanders around the target.
+        // A proportional rate correction brings it back without skipping or repeating samples.
+        const double error = (static_cast<double>(AUDIO_TARGET_LATENCY) - m_audio_ring->GetNumQueued()) / AUDIO_TARGET_LATENCY;
+        m_audio_rate_adjustment = 1.0 + std::max(-1.0, std::min(1.0, error)) * MAX_RATE_ADJUSTMENT;
+        m_psg->GetOutput().SetRateAdjustment(m_audio_rate_adjustment);
+        m_fm->GetOutput().SetRateAdjustment(m_audio_rate_adjustment);
+
+        m_next_frame_time = Clock::now();
+        return;
+    }
+
+    if (m_audio_rate_adjustment != 1.0)
+    {
+        m_audio_rate_adjustment = 1.0;
+        m_psg->GetOutput().SetRateAdjustment(m_audio_rate_adjustment);
+        m_fm->GetOutput().SetRateAdjustment(m_audio_rate_adjustment);
+    }
+
+    const Clock::duration frame_time = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(m_system_info.frame_target_time));
+    m_next_frame_time += frame_time;
+
+    // More than a frame late (a slow frame, the window was dragged): start over rather than rush to catch up.
+    const Clock::time_point now = Clock::now();
+    if (now > m_next_frame_time + frame_time)
+    {
+        m_next_frame_time = now;
+        return;
+    }
+
+    if (m_next_frame_time - now > SPIN_MARGIN)
+        std::this_thread::sleep_for(m_next_frame_time - now - SPIN_MARGIN);
+
+    while (Clock::now() < m_next_frame_time)
+        std::this_thread::yield();
+}
+
+void SMS::Unshare() const
+{
+    if (!m_shared_snapshot)
+        return;
+
+    m_memory->UnshareState();
+    m_vdp->UnshareVRam();
+}
+
 bool SMS::IsNTSC(const GameRom& game_rom)
 {
-    // @TODO: Implement me. Not sure how to detect this.
-    //        Maybe compare to a database?
-    return false;
+    // Resolved at load from the ROM database, NTSC when the cartridge isn't known.
+    return game_rom.GetVideoSystem() != VideoSystem::PAL;
 }
 
@@ -2,6 +2,10 @@
 
 #include "Types.h"
 #include <math.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
 
 struct SystemInfo
 {
@@ -14,38 +18,163 @@ struct SystemInfo
     uint32_t max_machine_cycles_per_frame = 0;       // master clock cycles per frame. (master_clock_cycles / fps)
     uint32_t lines_per_frame              = 0;       // Number of scanlines in a frame.
     // https://www.smspower.org/forums/13530-VDPClockSpeed
-    uint32_t cycles_per_line              = 0;       // Number of cycles needed to process a scanline.
+    uint32_t cycles_per_line              = 0;       // Number of master cycles needed to process a scanline (228 CPU cycles).
     double   frame_target_time            = 0;       // Time a frame is expected to take
     double   max_clock_cycles_per_frame   = 0;       // max_machine_cycles_per_frame / fps
 };
 
+// How Launch keeps the game at its frame rate.
+enum class FramePacing : uint8_t
+{
+    Audio, // Waits for the audio device to play the queued samples, the frames follow its clock.
+    Video  // Waits for the frame time, sleeping then spinning the last moment. Audio may drift.
+};
+
 class Z80;
 class GameRom;
 class VDP;
 class SDLInterface;
 class IODevice;
+class PSG;
+class YM2413;
+class Profiler;
+class Debugger;
+class Z80DisassemblyCache;
+class Memory;
+struct MachineState;
+class MachineStatePool;
+class RewindBuffer;
+class AudioRing;
+class Movie;
 class SMS
 {
 public:
-    SMS();
+    // The machine state comes from pool when one is given, to host many consoles.
+    SMS(MachineStatePool* pool = nullptr);
     ~SMS();
 
 public:
     /* @TODO: decouple launch from loading a game */ 
     void Launch(const char* path);
+    // Audio by default. Launch falls back to video pacing while there is no sound to wait on.
+    void SetFramePacing(FramePacing pacing) { m_frame_pacing = pacing; }
     bool LoadGame(const char* path);
+    // Runs num_frames as fast as possible without a window. Writes the hot-spot report if a path is given.
+    // The run can start from a save state and leave one at the end, to reproduce a crash.
+    bool RunHeadless(const char* path, uint32_t num_frames, const char* profile_report_path, const char* load_state_path = nullptr, const char* save_state_path = nullptr);
+
+    // Records the input of every frame from the next game loaded into movie_path (see Movie.h).
+    // Written when the game stops, or earlier if a state is loaded or rewound.
+    void SetMovieRecording(const char* movie_path);
+
+    // Replays a movie as fast as possible, checking the state hash after every frame. false on the first mismatch.
+    bool PlayMovie(const char* path, const char* movie_path);
+
+    // Buttons held for the next frame (JoypadButton bits). Pressing pause raises the NMI.
+    void     SetInput     (uint16_t buttons);
+    uint32_t GetStateHash () const;
+
+    // Snapshot of the running game (see SaveState.h). LoadState leaves the machine untouched if data isn't valid for this game.
+    bool SaveState(std::vector<byte>& data) const;
+    bool LoadState(const std::vector<byte>& data);
+    bool SaveStateToFile   (const char* path) const;
+    bool LoadStateFromFile (const char* path);
+
+    // Memory kept for the rewind history (see RewindBuffer.h), the history is lost.
+    void SetRewindMemory(size_t memory_cap);
+
+    // Shows the frame that is num_frames ahead of the emulated one to hide the game's own input lag. 0 disables it.
+    void SetRunAhead(uint32_t num_frames);
+
+    // Frames are still emulated but not drawn. Forks that are only searched don't need pictures, and
+    // they keep sharing the VRAM as long as they don't draw (see Fork).
+    void SetRenderEnabled(bool enabled);
+
+    // Launch only draws one frame out of frame_skip + 1, the others are emulated without drawing.
+    // The VDP still runs its counters, interrupts and status flags on them.
+    static constexpr uint32_t MAX_FRAME_SKIP = 9;
+    void SetFrameSkip(uint32_t frame_skip);
+
+    // Mono 16 bits samples of the frames emulated so far, up to max_samples. Returns how many.
+    // About 4096 samples are kept when nobody reads them, the oldest are dropped. Forks are silent.
+    static constexpr uint32_t AUDIO_SAMPLE_RATE = 44100;
+    uint32_t ReadAudio(int16_t* out, uint32_t max_samples);
+
+    // Plugs the FM sound unit of the Japanese consoles on ports 0xF0-0xF2 (see YM2413.h). Off by default:
+    // games that find it play FM music, some of them instead of the PSG. Best set before the game starts,
+    // they only look for it at boot. Movies record it, PlayMovie sets it from the movie.
+    void SetFMEnabled(bool enabled);
+
+    /*
+        New console in the exact state of this one, its state from pool if one is given. nullptr without a game.
+
+        The child shares the cartridge ROM and reads the work RAM, the VRAM and the cartridge RAM from a
+        snapshot of this console until it writes to them, one 1KB page at a time. Every fork taken without
+        emulating in between shares the same snapshot, so only the first one pays for a full copy and the
+        others only copy the registers. The snapshot is read only: both sides keep running independently.
+        Forks inherit SetRenderEnabled and SetFMEnabled, but not the rewind history, run-ahead, movie recording or debug tools. They write
+        their own copy of the save file RAM instead of the .sav.
+    */
+    SMS* Fork(MachineStatePool* pool = nullptr);
+
+private:
+    struct ForkSnapshot;
 
 private:
     void Tick();
+    void StepInstruction();
+    void Rewind();
+    void EmulateFrame(uint16_t buttons);
+    void StopRecording();
+    void RunAheadFrame();
+    // Moves the samples of the emulated frames to the audio device. Fast-forward produces them faster than
+    // they are played, what goes beyond the pacing target is dropped rather than delaying the sound.
+    void QueueAudio(bool fast_forward);
+    // Blocks until the next frame is due.
+    void WaitForNextFrame(bool audio_paced);
+    // Whether Launch emulates the next frame without drawing it.
+    bool ShouldSkipFrame(std::chrono::steady_clock::time_point now, bool fast_forward);
+    // Copies the pages still shared with the fork snapshot, m_state is then complete on its own.
+    // The machine doesn't change, only where its pages are read from.
+    void Unshare() const;
+    template<bool PROFILE, bool DEBUG>
+    void RunFrame();
     static bool IsNTSC(const GameRom& game_rom);
 
 private:
+    MachineStatePool* m_state_pool;
+    MachineState* m_state;
+    Memory*       m_memory;
     Z80*		  m_cpu;
-    GameRom*	  m_game_rom;
+    std::shared_ptr<GameRom> m_game_rom;     // Shared with the forks.
     VDP*		  m_vdp;
     SystemInfo	  m_system_info;
     SDLInterface* m_sdl_interface;
     IODevice*     m_io_device;
+    PSG*          m_psg;
+    YM2413*       m_fm;                      // Always there, only on the ports and heard when m_fm_enabled.
+    bool          m_fm_enabled;
+    Profiler*     m_profiler;
+    Debugger*     m_debugger;
+    Z80DisassemblyCache* m_disassembly;
+    RewindBuffer* m_rewind;                  // Created by Launch, the only loop that records history.
+    size_t        m_rewind_memory;
+    bool          m_render_enabled;
+    bool          m_skip_frame;              // The frame being emulated isn't drawn, see ShouldSkipFrame.
+    uint32_t      m_frame_skip;
+    uint32_t      m_frames_skipped;          // Since the last one drawn.
+    uint32_t      m_run_ahead_frames;
+    MachineState* m_run_ahead_state;         // Snapshot restored after the frames run ahead.
+    byte*         m_run_ahead_cartridge_ram; // Same for the save file RAM, which isn't in the machine state.
+    Movie*        m_movie;                   // Being recorded, nullptr otherwise.
+    std::string   m_movie_path;
+    AudioRing*    m_audio_ring;              // Created by Launch, read by the SDL audio thread.
+    FramePacing   m_frame_pacing;
+    double        m_audio_rate_adjustment;   // Sample rate correction of the audio pacing, 1.0 is none.
+    std::chrono::steady_clock::time_point m_next_frame_time; // Of the video pacing.
+    std::chrono::steady_clock::time_point m_last_drawn_time; // Of the fast-forward.
+    std::shared_ptr<const ForkSnapshot> m_fork_snapshot;   // Handed to the forks of the current state, dropped once it changes.
+    std::shared_ptr<const ForkSnapshot> m_shared_snapshot; // Forked from, read by the pages not written yet.
 
     double LastFrameTimestamp = 0.0;
 };
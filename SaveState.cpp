@@ -0,0 +1,483 @@
+#include "SaveState.h"
+#include "MachineState.h"
+#include "GameRom.h"
+#include "FileUtils.h"
+#include <stdio.h>
+#include <string.h>
+
+static constexpr char STATE_MAGIC[4] = { 'S', 'M', 'S', 'S' };
+
+namespace
+{
+    constexpr uint32_t MakeSectionId(const char (&id)[5])
+    {
+        return static_cast<uint32_t>(static_cast<byte>(id[0]))       | static_cast<uint32_t>(static_cast<byte>(id[1])) << 8 |
+               static_cast<uint32_t>(static_cast<byte>(id[2])) << 16 | static_cast<uint32_t>(static_cast<byte>(id[3])) << 24;
+    }
+
+    constexpr uint32_t SECTION_Z80  = MakeSectionId("Z80 ");
+    constexpr uint32_t SECTION_VDP  = MakeSectionId("VDP ");
+    constexpr uint32_t SECTION_MEM  = MakeSectionId("MEM ");
+    constexpr uint32_t SECTION_IO   = MakeSectionId("IO  ");
+    constexpr uint32_t SECTION_PSG  = MakeSectionId("PSG ");
+    constexpr uint32_t SECTION_FM   = MakeSectionId("FM  ");
+    constexpr uint32_t SECTION_SRAM = MakeSectionId("SRAM");
+
+    constexpr uint32_t Z80_SECTION_VERSION  = 1;
+    constexpr uint32_t VDP_SECTION_VERSION  = 1;
+    constexpr uint32_t MEM_SECTION_VERSION  = 1;
+    constexpr uint32_t IO_SECTION_VERSION   = 1;
+    constexpr uint32_t PSG_SECTION_VERSION  = 1;
+    constexpr uint32_t FM_SECTION_VERSION   = 1;
+    constexpr uint32_t SRAM_SECTION_VERSION = 1;
+
+    constexpr bool IsKnownSection(uint32_t id)
+    {
+        return id == SECTION_Z80 || id == SECTION_VDP || id == SECTION_MEM || id == SECTION_IO || id == SECTION_PSG || id == SECTION_FM || id == SECTION_SRAM;
+    }
+
+    constexpr size_t HEADER_SIZE         = sizeof(STATE_MAGIC) + 4 * 3;
+    constexpr size_t SECTION_HEADER_SIZE = 4 * 3;
+
+    class StateWriter
+    {
+    public:
+        StateWriter(std::vector<byte>& out) : m_out(out), m_section_start(0) {}
+
+        void Write(uint64_t value, uint32_t size)
+        {
+            for (uint32_t i = 0; i < size; ++i)
+                m_out.push_back(static_cast<byte>(value >> (i * 8)));
+        }
+
+        void WriteBytes(const byte* data, size_t size) { m_out.insert(m_out.end(), data, data + size); }
+
+        void BeginSection(uint32_t id, uint32_t version)
+        {
+            Write(id, 4);
+            Write(version, 4);
+            Write(0, 4); // Size, patched by EndSection.
+            m_section_start = m_out.size();
+        }
+
+        void EndSection()
+        {
+            const size_t size = m_out.size() - m_section_start;
+            for (uint32_t i = 0; i < 4; ++i)
+                m_out[m_section_start - 4 + i] = static_cast<byte>(size >> (i * 8));
+        }
+
+    private:
+        std::vector<byte>& m_out;
+        size_t             m_section_start;
+    };
+
+    // Reads past the end return 0 and make IsOk() false, so a section can be read without checking every field.
+    class StateReader
+    {
+    public:
+        StateReader(const byte* data, size_t size) : m_data(data), m_size(size), m_offset(0), m_ok(true) {}
+
+        uint64_t Read(uint32_t size)
+        {
+            if (!Consume(size))
+                return 0;
+
+            uint64_t value = 0;
+            for (uint32_t i = 0; i < size; ++i)
+                value |= static_cast<uint64_t>(m_data[m_offset - size + i]) << (i * 8);
+            return value;
+        }
+
+        void ReadBytes(byte* out, size_t size)
+        {
+            if (Consume(size))
+                memcpy(out, &m_data[m_offset - size], size);
+        }
+
+        const byte* Skip(size_t size) { return Consume(size) ? &m_data[m_offset - size] : nullptr; }
+
+        bool IsOk    () const { return m_ok; }
+        bool IsAtEnd () const { return m_offset == m_size; }
+
+    private:
+        bool Consume(size_t size)
+        {
+            m_ok = m_ok && size <= m_size - m_offset;
+            if (m_ok)
+                m_offset += size;
+            return m_ok;
+        }
+
+    private:
+        const byte* m_data;
+        size_t      m_size;
+        size_t      m_offset;
+        bool        m_ok;
+    };
+
+    void WriteZ80(StateWriter& writer, const Z80State& cpu)
+    {
+        const Register* registers[] = { &cpu.reg_AF, &cpu.reg_BC, &cpu.reg_DE, &cpu.reg_HL,
+                                        &cpu.reg_AF_shadow, &cpu.reg_BC_shadow, &cpu.reg_DE_shadow, &cpu.reg_HL_shadow,
+                                        &cpu.reg_IX, &cpu.reg_IY };
+        for (const Register* reg : registers)
+            writer.Write(reg->value, 2);
+
+        writer.Write(cpu.program_counter, 2);
+        writer.Write(cpu.stack_pointer, 2);
+        writer.Write(cpu.reg_refresh, 1);
+        writer.Write(cpu.reg_interrupt, 1);
+        writer.Write(cpu.current_prefix, 1);
+        writer.Write(cpu.halt, 1);
+        writer.Write(cpu.IFF1, 1);
+        writer.Write(cpu.IFF2, 1);
+        writer.Write(cpu.after_EI, 1);
+        writer.Write(static_cast<byte>(cpu.interrupt_mode), 1);
+        writer.Write(cpu.pending_events, 4);
+        writer.Write(cpu.cycle_count, 4);
+        writer.Write(cpu.total_cycles, 8);
+    }
+
+    bool ReadZ80(StateReader& reader, Z80State& cpu)
+    {
+        Register* registers[] = { &cpu.reg_AF, &cpu.reg_BC, &cpu.reg_DE, &cpu.reg_HL,
+                                  &cpu.reg_AF_shadow, &cpu.reg_BC_shadow, &cpu.reg_DE_shadow, &cpu.reg_HL_shadow,
+                                  &cpu.reg_IX, &cpu.reg_IY };
+        for (Register* reg : registers)
+            reg->value = static_cast<word>(reader.Read(2));
+
+        cpu.program_counter = static_cast<word>(reader.Read(2));
+        cpu.stack_pointer   = static_cast<word>(reader.Read(2));
+        cpu.reg_refresh     = static_cast<byte>(reader.Read(1));
+        cpu.reg_interrupt   = static_cast<byte>(reader.Read(1));
+        cpu.current_prefix  = static_cast<byte>(reader.Read(1));
+        cpu.halt            = reader.Read(1) != 0;
+        cpu.IFF1            = reader.Read(1) != 0;
+        cpu.IFF2            = reader.Read(1) != 0;
+        cpu.after_EI        = reader.Read(1) != 0;
+        cpu.interrupt_mode  = static_cast<Z80InterruptMode>(reader.Read(1) % 3);
+        cpu.pending_events  = static_cast<uint32_t>(reader.Read(4));
+        cpu.cycle_count     = static_cast<uint32_t>(reader.Read(4));
+        cpu.total_cycles    = reader.Read(8);
+        return reader.IsOk();
+    }
+
+    void WriteVDP(StateWriter& writer, const VDPState& vdp)
+    {
+        writer.WriteBytes(vdp.vram, sizeof(vdp.vram));
+        writer.WriteBytes(vdp.cram, sizeof(vdp.cram));
+        writer.WriteBytes(vdp.registers, sizeof(vdp.registers));
+        writer.Write(vdp.command_word, 2);
+        writer.Write(vdp.is_first_byte, 1);
+        writer.Write(vdp.status_flags, 1);
+        writer.Write(vdp.read_buffer, 1);
+        writer.Write(static_cast<byte>(vdp.line_mode), 1);
+        writer.Write(vdp.pal, 1);
+        writer.Write(vdp.h_counter, 2);
+        writer.Write(vdp.v_counter, 2);
+        writer.Write(vdp.cycle_count, 4);
+        writer.Write(vdp.current_line, 2);
+        writer.Write(vdp.line_interrupt_pending, 1);
+        writer.Write(vdp.line_counter, 1);
+        writer.Write(vdp.scroll_y, 1);
+        writer.Write(vdp.lines_per_frame, 4);
+        writer.Write(vdp.cycles_per_line, 4);
+    }
+
+    bool ReadVDP(StateReader& reader, VDPState& vdp)
+    {
+        reader.ReadBytes(vdp.vram, sizeof(vdp.vram));
+        reader.ReadBytes(vdp.cram, sizeof(vdp.cram));
+        reader.ReadBytes(vdp.registers, sizeof(vdp.registers));
+        vdp.command_word           = static_cast<word>(reader.Read(2));
+        vdp.is_first_byte          = reader.Read(1) != 0;
+        vdp.status_flags           = static_cast<byte>(reader.Read(1));
+        vdp.read_buffer            = static_cast<byte>(reader.Read(1));
+        vdp.line_mode              = static_cast<LINE_MODE>(reader.Read(1));
+        vdp.pal                    = reader.Read(1) != 0;
+        vdp.h_counter              = static_cast<uint16_t>(reader.Read(2));
+        vdp.v_counter              = static_cast<uint16_t>(reader.Read(2));
+        vdp.cycle_count            = static_cast<uint32_t>(reader.Read(4));
+        vdp.current_line           = static_cast<uint16_t>(reader.Read(2));
+        vdp.line_interrupt_pending = reader.Read(1) != 0;
+        vdp.line_counter           = static_cast<byte>(reader.Read(1));
+        vdp.scroll_y               = static_cast<uint8_t>(reader.Read(1));
+        vdp.lines_per_frame        = static_cast<uint32_t>(reader.Read(4));
+        vdp.cycles_per_line        = static_cast<uint32_t>(reader.Read(4));
+
+        // The line format is a cache of the line mode, recomputed on the next line.
+        vdp.line_format = VLineFormat();
+        vdp.format_dirt = true;
+
+        const bool valid_line_mode = vdp.line_mode == LINE_MODE::DEFAULT || vdp.line_mode == LINE_MODE::MODE_224 || vdp.line_mode == LINE_MODE::MODE_240;
+        return reader.IsOk() && valid_line_mode && vdp.lines_per_frame > 0 && vdp.cycle_count < vdp.cycles_per_line;
+    }
+
+    void WriteMemory(StateWriter& writer, const MemoryState& memory)
+    {
+        writer.WriteBytes(memory.work_ram, sizeof(memory.work_ram));
+        writer.WriteBytes(memory.cartridge_ram, sizeof(memory.cartridge_ram));
+        writer.WriteBytes(memory.mapper.rom_banks, sizeof(memory.mapper.rom_banks));
+        writer.Write(memory.mapper.cartridge_ram_mapped, 1);
+        writer.Write(memory.mapper.cartridge_ram_page, 1);
+    }
+
+    bool ReadMemory(StateReader& reader, MemoryState& memory)
+    {
+        reader.ReadBytes(memory.work_ram, sizeof(memory.work_ram));
+        reader.ReadBytes(memory.cartridge_ram, sizeof(memory.cartridge_ram));
+        reader.ReadBytes(memory.mapper.rom_banks, sizeof(memory.mapper.rom_banks));
+        memory.mapper.cartridge_ram_mapped = reader.Read(1) != 0;
+        memory.mapper.cartridge_ram_page   = static_cast<uint8_t>(reader.Read(1) & 1);
+        return reader.IsOk();
+    }
+
+    void WriteIO(StateWriter& writer, const IOState& io)
+    {
+        writer.Write(io.buttons, 2);
+    }
+
+    bool ReadIO(StateReader& reader, IOState& io)
+    {
+        io.buttons = static_cast<uint16_t>(reader.Read(2));
+        return reader.IsOk();
+    }
+
+    void WritePSG(StateWriter& writer, const PSGState& psg)
+    {
+        for (uint16_t tone : psg.tone)
+            writer.Write(tone, 2);
+        writer.WriteBytes(psg.volume, sizeof(psg.volume));
+        writer.Write(psg.noise, 1);
+        writer.Write(psg.latched, 1);
+        writer.Write(psg.outputs, 1);
+        writer.Write(psg.lfsr, 2);
+        for (uint32_t counter : psg.counters)
+            writer.Write(counter, 4);
+        writer.Write(psg.cycle, 8);
+    }
+
+    bool ReadPSG(StateReader& reader, PSGState& psg)
+    {
+        for (uint16_t& tone : psg.tone)
+            tone = static_cast<uint16_t>(reader.Read(2) & 0x3ff);
+        reader.ReadBytes(psg.volume, sizeof(psg.volume));
+        psg.noise   = static_cast<uint8_t>(reader.Read(1) & 0x7);
+        psg.latched = static_cast<uint8_t>(reader.Read(1) & 0x7);
+        psg.outputs = static_cast<uint8_t>(reader.Read(1) & 0x1f);
+        psg.lfsr    = static_cast<uint16_t>(reader.Read(2));
+        for (uint32_t& counter : psg.counters)
+            counter = static_cast<uint32_t>(reader.Read(4));
+        psg.cycle   = reader.Read(8);
+
+        for (uint8_t& volume : psg.volume)
+            volume &= 0xf;
+        return reader.IsOk();
+    }
+
+    void WriteFM(StateWriter& writer, const YM2413State& fm)
+    {
+        writer.WriteBytes(fm.registers, sizeof(fm.registers));
+        writer.Write(fm.address, 1);
+        writer.Write(fm.audio_control, 1);
+        for (const YM2413Slot& slot : fm.slots)
+        {
+            writer.Write(slot.phase, 4);
+            writer.Write(slot.envelope, 4);
+            writer.Write(slot.eg_state, 1);
+            writer.Write(slot.key_on, 1);
+            writer.Write(static_cast<uint16_t>(slot.output[0]), 2);
+            writer.Write(static_cast<uint16_t>(slot.output[1]), 2);
+        }
+        writer.Write(fm.am_phase, 4);
+        writer.Write(fm.vibrato_phase, 4);
+        writer.Write(fm.noise, 4);
+        writer.Write(static_cast<uint32_t>(fm.last_output), 4);
+        writer.Write(fm.cycle, 8);
+    }
+
+    bool ReadFM(StateReader& reader, YM2413State& fm)
+    {
+        reader.ReadBytes(fm.registers, sizeof(fm.registers));
+        fm.address       = static_cast<byte>(reader.Read(1) & 0x3f);
+        fm.audio_control = static_cast<byte>(reader.Read(1) & 0x7);
+        for (YM2413Slot& slot : fm.slots)
+        {
+            slot.phase     = static_cast<uint32_t>(reader.Read(4) & 0x7ffff);
+            slot.envelope  = static_cast<uint32_t>(reader.Read(4));
+            slot.eg_state  = static_cast<uint8_t>(reader.Read(1));
+            slot.key_on    = static_cast<uint8_t>(reader.Read(1) & 1);
+            slot.output[0] = static_cast<int16_t>(reader.Read(2));
+            slot.output[1] = static_cast<int16_t>(reader.Read(2));
+
+            if (slot.envelope > (127u << 16) || slot.eg_state > YM2413::EG_OFF)
+                return false;
+        }
+        fm.am_phase      = static_cast<uint32_t>(reader.Read(4));
+        fm.vibrato_phase = static_cast<uint32_t>(reader.Read(4) & 0x1fff);
+        fm.noise         = static_cast<uint32_t>(reader.Read(4) & 0x7fffff);
+        fm.last_output   = static_cast<int32_t>(reader.Read(4));
+        fm.cycle         = reader.Read(8);
+
+        // The noise register never runs empty.
+        return reader.IsOk() && fm.am_phase < (210u << 6) && fm.noise != 0;
+    }
+};
+
+void SaveState::Write(const MachineState& state, uint32_t rom_crc32, const byte* cartridge_ram, std::vector<byte>& out)
+{
+    const bool has_cartridge_ram = cartridge_ram != nullptr;
+
+    out.clear();
+    out.reserve(HEADER_SIZE + 7 * SECTION_HEADER_SIZE + sizeof(MachineState) + (has_cartridge_ram ? GameRom::CARTRIDGE_RAM_SIZE : 0));
+
+    StateWriter writer(out);
+    writer.WriteBytes(reinterpret_cast<const byte*>(STATE_MAGIC), sizeof(STATE_MAGIC));
+    writer.Write(FORMAT_VERSION, 4);
+    writer.Write(rom_crc32, 4);
+    writer.Write(has_cartridge_ram ? 7 : 6, 4);
+
+    writer.BeginSection(SECTION_Z80, Z80_SECTION_VERSION);
+    WriteZ80(writer, state.cpu);
+    writer.EndSection();
+
+    writer.BeginSection(SECTION_VDP, VDP_SECTION_VERSION);
+    WriteVDP(writer, state.vdp);
+    writer.EndSection();
+
+    writer.BeginSection(SECTION_MEM, MEM_SECTION_VERSION);
+    WriteMemory(writer, state.memory);
+    writer.EndSection();
+
+    writer.BeginSection(SECTION_IO, IO_SECTION_VERSION);
+    WriteIO(writer, state.io);
+    writer.EndSection();
+
+    writer.BeginSection(SECTION_PSG, PSG_SECTION_VERSION);
+    WritePSG(writer, state.psg);
+    writer.EndSection();
+
+    writer.BeginSection(SECTION_FM, FM_SECTION_VERSION);
+    WriteFM(writer, state.fm);
+    writer.EndSection();
+
+    if (has_cartridge_ram)
+    {
+        writer.BeginSection(SECTION_SRAM, SRAM_SECTION_VERSION);
+        writer.WriteBytes(cartridge_ram, GameRom::CARTRIDGE_RAM_SIZE);
+        writer.EndSection();
+    }
+}
+
+bool SaveState::Read(const byte* data, size_t size, uint32_t rom_crc32, MachineState& state, const byte*& out_cartridge_ram)
+{
+    StateReader reader(data, size);
+
+    char magic[sizeof(STATE_MAGIC)];
+    reader.ReadBytes(reinterpret_cast<byte*>(magic), sizeof(magic));
+
+    const uint32_t version      = static_cast<uint32_t>(reader.Read(4));
+    const uint32_t state_crc32  = static_cast<uint32_t>(reader.Read(4));
+    const uint32_t num_sections = static_cast<uint32_t>(reader.Read(4));
+
+    if (!reader.IsOk() || memcmp(magic, STATE_MAGIC, sizeof(magic)) != 0 || version != FORMAT_VERSION)
+        return false;
+
+    // A state only makes sense with the cartridge it was saved from.
+    if (state_crc32 != rom_crc32)
+        return false;
+
+    // Decoded into a copy so a damaged state leaves the machine as it was.
+    MachineState* loaded = new MachineState(state);
+    const byte* cartridge_ram = nullptr;
+    uint32_t found = 0;
+
+    bool valid = true;
+
+    for (uint32_t i = 0; i < num_sections && valid; ++i)
+    {
+        const uint32_t id              = static_cast<uint32_t>(reader.Read(4));
+        const uint32_t section_version = static_cast<uint32_t>(reader.Read(4));
+        const uint32_t section_size    = static_cast<uint32_t>(reader.Read(4));
+        const byte*    section         = reader.Skip(section_size);
+
+        StateReader section_reader(section, section ? section_size : 0);
+
+        switch (id)
+        {
+        case SECTION_Z80:
+            valid = section_version <= Z80_SECTION_VERSION && ReadZ80(section_reader, loaded->cpu);
+            found |= 1 << 0;
+            break;
+        case SECTION_VDP:
+            valid = section_version <= VDP_SECTION_VERSION && ReadVDP(section_reader, loaded->vdp);
+            found |= 1 << 1;
+            break;
+        case SECTION_MEM:
+            valid = section_version <= MEM_SECTION_VERSION && ReadMemory(section_reader, loaded->memory);
+            found |= 1 << 2;
+            break;
+        case SECTION_IO:
+            valid = section_version <= IO_SECTION_VERSION && ReadIO(section_reader, loaded->io);
+            break;
+        case SECTION_PSG:
+            valid = section_version <= PSG_SECTION_VERSION && ReadPSG(section_reader, loaded->psg);
+            found |= 1 << 3;
+            break;
+        case SECTION_FM:
+            valid = section_version <= FM_SECTION_VERSION && ReadFM(section_reader, loaded->fm);
+            found |= 1 << 4;
+            break;
+        case SECTION_SRAM:
+            cartridge_ram = section_reader.Skip(GameRom::CARTRIDGE_RAM_SIZE);
+            valid = section_version <= SRAM_SECTION_VERSION && cartridge_ram;
+            break;
+        default:
+            break; // Unknown section, skipped.
+        }
+
+        // Sections must be read entirely, a size mismatch means the layout isn't the expected one.
+        valid = valid && section && (section_reader.IsAtEnd() || !IsKnownSection(id));
+    }
+
+    // Older states have no sound, the PSG starts silent from where the CPU is.
+    if ((found & (1 << 3)) == 0)
+        PSG::ResetState(loaded->psg, loaded->cpu.total_cycles);
+    if ((found & (1 << 4)) == 0)
+        YM2413::ResetState(loaded->fm, loaded->cpu.total_cycles);
+
+    const bool ok = valid && reader.IsOk() && reader.IsAtEnd() && (found & 0b111) == 0b111;
+    if (ok)
+    {
+        memcpy(&state, loaded, sizeof(MachineState));
+        out_cartridge_ram = cartridge_ram;
+    }
+
+    delete loaded;
+    return ok;
+}
+
+bool SaveState::WriteFile(const std::string& path, const std::vector<byte>& data)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    const bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool SaveState::ReadFile(const std::string& path, std::vector<byte>& data)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    const long size = FileUtils::GetFileSize(file);
+    data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+
+    const bool ok = size > 0 && fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Types.h"
+#include <string>
+#include <vector>
+
+struct MachineState;
+
+/*
+    Save states.
+
+    A save state is a little-endian binary blob:
+        "SMSS" | format version (u32) | ROM crc32 (u32) | section count (u32)
+        per section: id (4 chars) | section version (u32) | data size (u32) | data
+
+    Sections:
+        "Z80 " registers, interrupt state and cycle counters.
+        "VDP " VRAM, CRAM, registers, latches and line counters.
+        "MEM " work RAM, Codemasters cartridge RAM and mapper registers.
+        "IO  " buttons held on the controllers and the console (optional, older states don't have it).
+        "PSG " sound chip registers, counters and noise shift register (optional, older states start silent).
+        "FM  " FM unit registers, operators and LFOs (optional, older states start silent).
+        "SRAM" battery-backed cartridge RAM, only when the game has opened it.
+
+    Every field is written one by one, so the layout doesn't depend on the padding of the
+    MachineState structs. Sections can grow their own version independently; unknown sections
+    are skipped and a section newer than this build fails the load. Loading is all or nothing:
+    the state is only touched once the whole blob has been validated.
+*/
+namespace SaveState
+{
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // cartridge_ram is the battery-backed RAM of the game (GameRom::CARTRIDGE_RAM_SIZE), nullptr if it isn't open.
+    void Write (const MachineState& state, uint32_t rom_crc32, const byte* cartridge_ram, std::vector<byte>& out);
+    // out_cartridge_ram points into data at the saved cartridge RAM, nullptr if the state has none. It is up to
+    // the caller to copy it, the state is the only thing written.
+    bool Read  (const byte* data, size_t size, uint32_t rom_crc32, MachineState& state, const byte*& out_cartridge_ram);
+
+    bool WriteFile (const std::string& path, const std::vector<byte>& data);
+    bool ReadFile  (const std::string& path, std::vector<byte>& data);
+};
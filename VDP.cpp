@@ -1,5 +1,7 @@
 #include "VDP.h"
+#include "Z80.h"
 #include <assert.h>
+#include <string.h>
 #include <iostream>
 
 constexpr VLineFormat NTSC_256x192   = VLineFormat(192, 24, 3, 3, 13, 27);
@@ -17,112 +19,117 @@ constexpr uint32_t NUM_COLOR_COMPONENTS = 3;
 // Width * height * 3 color components
 constexpr uint32_t FRAME_BUFFER_SIZE = VDP::MAX_WIDTH * VDP::MAX_HEIGHT * NUM_COLOR_COMPONENTS;
 
-VDP::VDP() :
-    m_command_word      (0x0000),
-    m_is_first_byte     (false),
-    m_status_flags      (0x00),
-    m_read_buffer       (0x00),
-    m_line_mode         (LINE_MODE::DEFAULT),
-    m_pal               (true),
-    m_h_counter         (0),
-    m_v_counter         (0),
-    m_cycle_count	    (0),
-    m_line_format	    (VLineFormat()),
-    m_format_dirt       (true),
-    m_current_line      (0),
-    m_request_interrupt (false)
-{
-    m_VRam          = (byte*)calloc(0x4000,            sizeof(byte));
-    m_CRam          = (byte*)calloc(32,                sizeof(byte));
-    m_registers     = (byte*)calloc(16,                sizeof(byte));
-    m_frame_buffer  = (byte*)calloc(FRAME_BUFFER_SIZE, sizeof(byte));
+VDP::VDP(VDPState& state) :
+    m_state          (state),
+    m_frame_buffer   (nullptr),
+    m_render_enabled (true),
+    m_shared_vram       (nullptr),
+    m_shared_vram_pages (0)
+{
+    m_state = VDPState();
+
+    m_state.is_first_byte   = true;
+    m_state.line_mode       = LINE_MODE::DEFAULT;
+    m_state.pal             = true;
+    m_state.line_format     = VLineFormat();
+    m_state.format_dirt     = true;
+    m_state.line_counter    = 0xFF;
+    m_state.lines_per_frame = 313;
+    m_state.cycles_per_line = 3420;
 
     /* https://segaretro.org/Sega_Master_System_VDP_documentation_(2002-11-12) */
-    m_registers[0]  = 0b00110110; // Mode Control No. 1
-    m_registers[1]  = 0b10000000; // Mode Control No. 2
-    m_registers[2]  = 0b11111111; // Name Table Base Address
-    m_registers[3]  = 0b00000111; // Color Table Base Address
-    m_registers[4]  = 0b00000111; // Background Pattern Generator Base Address
-    m_registers[5]  = 0b11111111; // Sprite Attribute Table Base Address
-    m_registers[6]  = 0b11111111; // Sprite Pattern Generator Base Address
-    m_registers[7]  = 0b11111111; // Overscan/Backdrop Color
-    m_registers[8]  = 0b11111111; // Background X Scroll
-    m_registers[9]  = 0b11111111; // Background Y Scroll
-    m_registers[10] = 0b11111111; // Line counter
+    m_state.registers[0]  = 0b00110110; // Mode Control No. 1
+    m_state.registers[1]  = 0b10000000; // Mode Control No. 2
+    m_state.registers[2]  = 0b11111111; // Name Table Base Address
+    m_state.registers[3]  = 0b00000111; // Color Table Base Address
+    m_state.registers[4]  = 0b00000111; // Background Pattern Generator Base Address
+    m_state.registers[5]  = 0b11111111; // Sprite Attribute Table Base Address
+    m_state.registers[6]  = 0b11111111; // Sprite Pattern Generator Base Address
+    m_state.registers[7]  = 0b11111111; // Overscan/Backdrop Color
+    m_state.registers[8]  = 0b11111111; // Background X Scroll
+    m_state.registers[9]  = 0b11111111; // Background Y Scroll
+    m_state.registers[10] = 0b11111111; // Line counter
 }
 
 VDP::~VDP()
 {
-    free(m_VRam);
-    free(m_CRam);
-    free(m_registers);
+    free(m_frame_buffer);
 }
 
 bool VDP::Tick(uint32_t cycles)
 {
-    m_request_interrupt = IsInterruptRequested();
+    assert(m_state.cycles_per_line > 0 && "Video system info must be set before ticking the VDP");
 
-    const uint8_t      height_lines = static_cast<uint8_t>(m_line_mode);
-    const VLineFormat& line_format  = GetCurrentLineFormat();
-    
     bool vblank = false;
-    
-    // Max cycles reached
-    m_cycle_count += cycles;
-   
-    // @TODO: is this right?
-    // Using 342 cycles as indicated in documentation for h counter
-    // As it runs as X2 the Z80, use 342*2 = 684 instead
-   
-    // const bool ReadNextLine = ((m_h_counter + m_cycle_count) > m_cycles_per_line);
-    const bool read_next_line = ((m_h_counter + m_cycle_count) > 684);
 
-    m_h_counter = (m_h_counter + cycles) % (684 + 1);
+    // Cycles are given in master clock cycles. Nothing observable changes until a line is
+    // completed, so the caller can batch the CPU up to GetCyclesToNextEvent().
+    m_state.cycle_count += cycles;
 
-    // vertical
-
-    if (read_next_line)
+    while (m_state.cycle_count >= m_state.cycles_per_line)
     {
+        m_state.cycle_count -= m_state.cycles_per_line;
+        vblank |= EndLine();
+    }
 
-        ScanLine(m_current_line);
+    // The H counter runs at the pixel clock, 342 pixels per line.
+    m_state.h_counter = static_cast<uint16_t>(m_state.cycle_count * 342 / m_state.cycles_per_line);
 
-        // Update line
-        m_current_line = (m_current_line + 1) % m_lines_per_frame;
+    return vblank;
+}
 
-        vblank = m_current_line == GetCurrentLineFormat().active_display;
-    }
+bool VDP::EndLine()
+{
+    const VLineFormat& line_format = GetCurrentLineFormat();
+    const uint16_t     line        = m_state.current_line;
 
-    /*
+    // Drawing only writes the frame buffer. Anything it finds that the game can observe
+    // (sprite collision and overflow) has to be evaluated even when it is disabled.
+    if (m_render_enabled)
+    {
+        if (m_shared_vram_pages != 0)
+            UnshareVRam();
 
-    // Scan line and that stuff.
-    const uint16_t display_begin = line_format.top_blanking + line_format.vertical_blanking + line_format.top_border;
-    const uint16_t display_end   = display_begin + line_format.active_display;
-    const uint16_t line          = m_current_line - display_begin;
+        // Consoles that never draw (forks, headless searches) don't pay for it.
+        if (!m_frame_buffer)
+            m_frame_buffer = (byte*)calloc(FRAME_BUFFER_SIZE, sizeof(byte));
 
-    if (line < display_end)
+        ScanLine(line);
+    }
+
+    /*
+        The line counter is decremented on every line of the active display plus the first
+        line after it. When it underflows it is reloaded with register 10 and the line
+        interrupt is flagged. It is reloaded on every other line.
+    */
+    if (line <= line_format.active_display)
     {
-        if (line == 0)
+        if (m_state.line_counter == 0)
         {
-            if (m_registers[0] & (1<<3))
-            {
-                // Request Interrupt (on CPU)
-            
-            }
+            m_state.line_counter           = m_state.registers[10];
+            m_state.line_interrupt_pending = true;
         }
         else
         {
-
+            --m_state.line_counter;
         }
     }
-    else if (line - line_format.active_display == 1 && m_registers[1] & (1<<4))
+    else
     {
-        // Request Interrupt 2
-        
+        m_state.line_counter = m_state.registers[10];
     }
 
-    // m_cycle_count -= m_system_info.cycles_per_line;
-    */
+    const bool vblank = line + 1 == line_format.active_display;
+    if (line == line_format.active_display)
+    {
+        // Frame interrupt pending
+        m_state.status_flags |= (1 << 7);
+    }
+
+    UpdateInterruptLines();
 
+    m_state.current_line = (line + 1) % m_state.lines_per_frame;
+    m_state.v_counter    = m_state.current_line;
 
     return vblank;
 }
@@ -177,10 +184,10 @@ void VDP::RenderBackground(uint32_t line)
     // If bit #6 of VDP register $00 is set, horizontal scrolling will be fixed at zero for scanlines zero through 15
     const bool is_horizontal_scrolling = line <= 15 && !IsHorizontalScrollActive();
     // Whole shorizontal scroll
-    const byte scroll_x = is_horizontal_scrolling ? m_registers[8] : 0;
+    const byte scroll_x = is_horizontal_scrolling ? m_state.registers[8] : 0;
 
     // Vertical scroll
-    const byte scroll_y = m_registers[9];
+    const byte scroll_y = m_state.registers[9];
     
     const byte mod = IsBckgTableNameExtended() ? 255 : 224;
     uint32_t tile_y = line + scroll_y % mod;
@@ -225,8 +232,8 @@ void VDP::RenderBackground(uint32_t line)
             tile_address += starting_row * 64;   //each scanline has 32 tiles (1 tile per column) but 1 tile is 2 bytes in memory
             tile_address += starting_column * 2; // each tile is two bytes in memory
 
-            uint16_t tile_data = m_VRam[tile_address + 1] << 8;
-            tile_data += m_VRam[tile_address];
+            uint16_t tile_data = m_state.vram[tile_address + 1] << 8;
+            tile_data += m_state.vram[tile_address];
 
             // ---pcvhnnnnnnnnn
             const bool has_priority = tile_data & (1 << 12);
@@ -240,10 +247,10 @@ void VDP::RenderBackground(uint32_t line)
             pattern_index += offset * 4;
 
             // each pattern is composed by 4 bitplanes
-            byte data_1 = m_VRam[pattern_index];
-            byte data_2 = m_VRam[pattern_index + 1];
-            byte data_3 = m_VRam[pattern_index + 2];
-            byte data_4 = m_VRam[pattern_index + 3];
+            byte data_1 = m_state.vram[pattern_index];
+            byte data_2 = m_state.vram[pattern_index + 1];
+            byte data_3 = m_state.vram[pattern_index + 2];
+            byte data_4 = m_state.vram[pattern_index + 3];
 
             const byte bit_index = horizontal_flip ? 7 - fine_scroll_x : fine_scroll_x;
 
@@ -262,7 +269,7 @@ void VDP::RenderBackground(uint32_t line)
 
         }
 
-        const byte color = m_CRam[pixel_color];
+        const byte color = m_state.cram[pixel_color];
         const RGBColor rgb_color = RGBColor::GetFromSMSColor(color);
 
         WriteToFramBuffer(line, position_x, rgb_color);
@@ -281,23 +288,68 @@ void VDP::WriteToFramBuffer(uint32_t line, uint32_t pixel_in_line, RGBColor colo
 
 void VDP::SetPal(bool is_pal)
 {
-    m_pal         = is_pal;
-    m_format_dirt = true;
+    m_state.pal         = is_pal;
+    m_state.format_dirt = true;
+}
+
+void VDP::ShareVRam(const byte* source)
+{
+    static_assert(sizeof(VDPState::vram) >> VRAM_PAGE_SHIFT == 16, "One bit per VRAM page");
+
+    m_shared_vram       = source;
+    m_shared_vram_pages = 0xffff;
+}
+
+void VDP::UnshareVRam()
+{
+    for (uint32_t page = 0; page < 16; ++page)
+    {
+        if (m_shared_vram_pages & (1 << page))
+            memcpy(&m_state.vram[page << VRAM_PAGE_SHIFT], &m_shared_vram[page << VRAM_PAGE_SHIFT], VRAM_PAGE_SIZE);
+    }
+
+    m_shared_vram_pages = 0;
+}
+
+void VDP::WriteVRam(word address, byte data)
+{
+    const uint32_t page = address >> VRAM_PAGE_SHIFT;
+    if (m_shared_vram_pages & (1 << page))
+    {
+        memcpy(&m_state.vram[page << VRAM_PAGE_SHIFT], &m_shared_vram[page << VRAM_PAGE_SHIFT], VRAM_PAGE_SIZE);
+        m_shared_vram_pages &= ~(1 << page);
+    }
+
+    m_state.vram[address] = data;
+}
+
+byte VDP::ReadControlPort()
+{
+    const byte status = GetStatusFlags();
+
+    // Reading the status clears every flag and acknowledges pending interrupts.
+    m_state.status_flags           = 0x00;
+    m_state.line_interrupt_pending = false;
+    m_state.is_first_byte          = true;
+
+    UpdateInterruptLines();
+
+    return status;
 }
 
 byte VDP::ReadDataPort()
 {
-    m_is_first_byte = true;
+    m_state.is_first_byte = true;
 
-    byte data = m_read_buffer;
+    byte data = m_state.read_buffer;
 
     switch (GetCodeRegister())
     {
     case 0: 
-        m_read_buffer = m_VRam[GetAddressRegister()];
+        m_state.read_buffer = ReadVRam(GetAddressRegister());
         break;
     case 1:
-        m_read_buffer = m_VRam[GetAddressRegister()];
+        m_state.read_buffer = ReadVRam(GetAddressRegister());
         break;
     default: 
         assert(false);
@@ -311,18 +363,18 @@ byte VDP::ReadDataPort()
 
 void VDP::WriteDataPort(byte data)
 {
-    m_is_first_byte = true;
-    m_read_buffer   = data;
+    m_state.is_first_byte = true;
+    m_state.read_buffer   = data;
 
     switch (GetCodeRegister())
     {
     case 0: // DROP
     case 1: // DROP
     case 2:
-        m_VRam[GetAddressRegister()] = data;
+        WriteVRam(GetAddressRegister(), data);
         break;
     case 3:
-        m_CRam[GetAddressRegister() & 0x1f] = data;
+        m_state.cram[GetAddressRegister() & 0x1f] = data;
         break;
     default:
         break;
@@ -331,20 +383,20 @@ void VDP::WriteDataPort(byte data)
 
 void VDP::WriteControlPort(byte data)
 {
-    if (m_is_first_byte)
+    if (m_state.is_first_byte)
     {
-        m_command_word  = (m_command_word & 0xff00) | data;
-        m_is_first_byte = false;
+        m_state.command_word  = (m_state.command_word & 0xff00) | data;
+        m_state.is_first_byte = false;
     }
     else
     {
-        m_is_first_byte = true;
-        m_command_word  = (m_command_word & 0x00ff) | (data << 8);
+        m_state.is_first_byte = true;
+        m_state.command_word  = (m_state.command_word & 0x00ff) | (data << 8);
 
         switch (GetCodeRegister())
         {
         case 0:
-            m_read_buffer = m_VRam[GetAddressRegister()];
+            m_state.read_buffer = ReadVRam(GetAddressRegister());
             IncrementAddressRegister();
             break;
         
@@ -354,11 +406,14 @@ void VDP::WriteControlPort(byte data)
 
             assert(reg < 11 && "Register must have a value between 0 and 10");
 
-            m_registers[reg] = GetAddressRegister() && 0x00ff;
+            m_state.registers[reg] = GetAddressRegister() & 0x00ff;
             if (reg < 2)
             {
-                m_line_mode   = GetLineMode();
-                m_format_dirt = true;
+                m_state.line_mode   = GetLineMode();
+                m_state.format_dirt = true;
+
+                // Enabling an interrupt with its flag already set asserts the line straight away.
+                UpdateInterruptLines();
             }
             break;
         }
@@ -370,19 +425,19 @@ void VDP::WriteControlPort(byte data)
 
 word VDP::GetAddressRegister() const
 {
-    return m_command_word & 0x3fff;
+    return m_state.command_word & 0x3fff;
 }
 
 byte VDP::GetCodeRegister() const
 {
-    return m_command_word >> 14;
+    return m_state.command_word >> 14;
 }
 
-VDP::LINE_MODE VDP::GetLineMode() const
+LINE_MODE VDP::GetLineMode() const
 {
-    if ((m_registers[0] & 0x06) == 0x06 && (m_registers[1] & 0x10) == 0x10)
+    if ((m_state.registers[0] & 0x06) == 0x06 && (m_state.registers[1] & 0x10) == 0x10)
         return LINE_MODE::MODE_224;
-    else if ((m_registers[0] & 0x06) == 0x06 && (m_registers[1] & 0x4) == 0x4)
+    else if ((m_state.registers[0] & 0x06) == 0x06 && (m_state.registers[1] & 0x4) == 0x4)
         return LINE_MODE::MODE_240;
     else
         return LINE_MODE::DEFAULT;
@@ -390,28 +445,28 @@ VDP::LINE_MODE VDP::GetLineMode() const
 
 void VDP::IncrementAddressRegister()
 {
-    if (m_command_word & 0x3ff)
-        ++m_command_word;
+    if (m_state.command_word & 0x3ff)
+        ++m_state.command_word;
     else
-        m_command_word = 0xC000;
+        m_state.command_word = 0xC000;
 }
 
 const VLineFormat& VDP::GetCurrentLineFormat()
 {
-    if (m_format_dirt)
+    if (m_state.format_dirt)
     {
-        m_line_format = FindLineFormat();
-        m_format_dirt = false;
+        m_state.line_format = FindLineFormat();
+        m_state.format_dirt = false;
     }
 
-    return m_line_format;
+    return m_state.line_format;
 }
 
 VLineFormat VDP::FindLineFormat() const
 {
-    if (m_pal)
+    if (m_state.pal)
     {
-        switch (m_line_mode)
+        switch (m_state.line_mode)
         {
         case LINE_MODE::DEFAULT:  return PAL_256x192;
         case LINE_MODE::MODE_224: return PAL_256x224;
@@ -421,7 +476,7 @@ VLineFormat VDP::FindLineFormat() const
     }
     else
     {
-        switch (m_line_mode)
+        switch (m_state.line_mode)
         {
         case LINE_MODE::DEFAULT:  return NTSC_256x192;
         case LINE_MODE::MODE_224: return NTSC_256x224;
@@ -435,60 +490,60 @@ VLineFormat VDP::FindLineFormat() const
 
 byte VDP::GetVCounter() const
 {
-    if (m_pal)
+    if (m_state.pal)
     {
-        switch (m_line_mode)
+        switch (m_state.line_mode)
         {
         case LINE_MODE::DEFAULT: 
-            return m_v_counter > 0xF2 ? m_v_counter - (0xF2 - 0xBA + 1) : m_v_counter;
+            return m_state.v_counter > 0xF2 ? m_state.v_counter - (0xF2 - 0xBA + 1) : m_state.v_counter;
         
         case LINE_MODE::MODE_224: 	
-            if ((m_v_counter - 0xFF) > 0x02)
+            if ((m_state.v_counter - 0xFF) > 0x02)
             {
-                return m_v_counter - (0xFF - 0xCA + 1);
+                return m_state.v_counter - (0xFF - 0xCA + 1);
             }
-            else if (m_v_counter > 0xFF) // 0x00-0x02
+            else if (m_state.v_counter > 0xFF) // 0x00-0x02
             {
-                return m_v_counter - (0xFF + 1);
+                return m_state.v_counter - (0xFF + 1);
             }
 
         case LINE_MODE::MODE_240: 
-            if ((m_v_counter - 0xFF) > 0x0A) // 
+            if ((m_state.v_counter - 0xFF) > 0x0A) // 
             {
-                return m_v_counter - (0xFF - 0xD2 + 1);
+                return m_state.v_counter - (0xFF - 0xD2 + 1);
             }
-            else if (m_v_counter > 0xFF) // 0x00-0x0A
+            else if (m_state.v_counter > 0xFF) // 0x00-0x0A
             {
-                return m_v_counter - (0xFF + 1);
+                return m_state.v_counter - (0xFF + 1);
             }
         }
     }
     else
     {
-        switch (m_line_mode)
+        switch (m_state.line_mode)
         {
-        case LINE_MODE::DEFAULT:  return m_v_counter > 0xDA ? m_v_counter - (0xDA - 0xD5 + 1) : m_v_counter;
-        case LINE_MODE::MODE_224: return m_v_counter > 0xEA ? m_v_counter - (0xEA - 0xE5 + 1) : m_v_counter;
+        case LINE_MODE::DEFAULT:  return m_state.v_counter > 0xDA ? m_state.v_counter - (0xDA - 0xD5 + 1) : m_state.v_counter;
+        case LINE_MODE::MODE_224: return m_state.v_counter > 0xEA ? m_state.v_counter - (0xEA - 0xE5 + 1) : m_state.v_counter;
         case LINE_MODE::MODE_240: assert(false && "LINE_MODE::MODE_240 - Unsupported mode for NTSC"); //Drop
         }
     }
 
-    return static_cast<uint8_t>(m_v_counter);
+    return static_cast<uint8_t>(m_state.v_counter);
 }
 
 bool VDP::IsDisplayVisible() const
 {
-    return m_registers[1] && (1 << 5);
+    return m_state.registers[1] && (1 << 5);
 }
 
 SCREEN_MODE VDP::GetScreenMode() const
 {
     SCREEN_MODE result = SCREEN_MODE::GRAPHIC_I;
     
-    const byte m1 = m_registers[1] & (1 << 4);
-    const byte m2 = m_registers[0] & (1 << 1);
-    const byte m3 = m_registers[1] & (1 << 3);
-    const byte m4 = m_registers[0] & (1 << 2);
+    const byte m1 = m_state.registers[1] & (1 << 4);
+    const byte m2 = m_state.registers[0] & (1 << 1);
+    const byte m3 = m_state.registers[1] & (1 << 3);
+    const byte m4 = m_state.registers[0] & (1 << 2);
 
     if (m4)
     {
@@ -505,47 +560,47 @@ SCREEN_MODE VDP::GetScreenMode() const
 
 bool VDP::IsVerticalScrollActive() const
 {
-    return !(m_registers[0] & (1 << 7));
+    return !(m_state.registers[0] & (1 << 7));
 }
 
 bool VDP::IsHorizontalScrollActive() const
 {
-    return !(m_registers[0] & (1 << 6));
+    return !(m_state.registers[0] & (1 << 6));
 }
 
 bool VDP::ShouldUseOverscanColor() const
 {
-    return m_registers[0] & (1 << 5);
+    return m_state.registers[0] & (1 << 5);
 }
 
 bool VDP::IsLineInterruptEnabled() const
 {
-    return m_registers[0] & (1 << 4);
+    return m_state.registers[0] & (1 << 4);
 }
 
 bool VDP::ShouldShiftSprites() const
 {
-    return m_registers[0] & (1 << 3);
+    return m_state.registers[0] & (1 << 3);
 }
 
 bool VDP::IsMonochromeDisplay() const
 {
-    return m_registers[0] & 1;
+    return m_state.registers[0] & 1;
 }
 
 bool VDP::IsFrameInterruptEnabled() const
 {
-    return m_registers[1] & (1 << 6);
+    return m_state.registers[1] & (1 << 5);
 }
 
 bool VDP::AreSpritesDoubleSized() const
 {
-    return m_registers[1] & 1;
+    return m_state.registers[1] & 1;
 }
 
 SPRITE_SIZE VDP::GetSpriteSize() const
 {
-    const bool sprite_flag = m_registers[1] & (1 << 1);
+    const bool sprite_flag = m_state.registers[1] & (1 << 1);
     if (GetScreenMode() == SCREEN_MODE::MODE_4)
     {
         return sprite_flag ? SPRITE_SIZE::SIZE_8x16 : SPRITE_SIZE::SIZE_8x8;
@@ -558,22 +613,28 @@ SPRITE_SIZE VDP::GetSpriteSize() const
 
 void VDP::SetSpriteCollision()
 {
-    m_status_flags |= (1 << 5);
+    m_state.status_flags |= (1 << 5);
 }
 
 void VDP::SetSpriteOverflow()
 {
-    m_status_flags |= (1 << 6);
+    m_state.status_flags |= (1 << 6);
 }
 
-bool VDP::IsInterruptRequested() const
+void VDP::UpdateInterruptLines()
 {
-    return m_status_flags & (1 << 7) && m_registers[1] & (1 << 5);
+    assert(m_context.cpu != nullptr);
+
+    const bool frame_interrupt = (m_state.status_flags & (1 << 7)) && IsFrameInterruptEnabled();
+    const bool line_interrupt  = m_state.line_interrupt_pending && IsLineInterruptEnabled();
+
+    m_context.cpu->SetInterruptLine(Z80::EVENT_IRQ_FRAME, frame_interrupt);
+    m_context.cpu->SetInterruptLine(Z80::EVENT_IRQ_LINE,  line_interrupt);
 }
 
 bool VDP::IsBckgTableNameExtended() const
 {
-    return m_line_mode == LINE_MODE::MODE_224 || m_line_mode == LINE_MODE::MODE_240;
+    return m_state.line_mode == LINE_MODE::MODE_224 || m_state.line_mode == LINE_MODE::MODE_240;
 }
 
 uint16_t VDP::GetBackgroundTableName() const
@@ -583,7 +644,7 @@ uint16_t VDP::GetBackgroundTableName() const
     // MODE_224 and MODE_240 uses uses specific values based on the bits 2 and 3
     if (name_table_extended)
     {
-        const byte value = (m_registers[2] & 0x0C) >> 2;
+        const byte value = (m_state.registers[2] & 0x0C) >> 2;
 
         switch (value)
         {
@@ -596,12 +657,12 @@ uint16_t VDP::GetBackgroundTableName() const
     }
     else
     {
-        const uint16_t map_address = (m_registers[2] & (name_table_extended ? 0x0C : 0x0E)) << 10;
+        const uint16_t map_address = (m_state.registers[2] & (name_table_extended ? 0x0C : 0x0E)) << 10;
         return map_address;
     }
 }
 
 byte VDP::GetOverscanColor() const
 {
-    return m_registers[7] & 0x0F;
+    return m_state.registers[7] & 0x0F;
 }
@@ -61,6 +61,49 @@ enum class SPRITE_SIZE : uint8_t
 
 };
 
+enum class LINE_MODE : uint8_t
+{
+    DEFAULT  = 192,
+    MODE_224 = 224,
+    MODE_240 = 240
+};
+
+/*
+    VDP memories, registers and counters. It lives in the MachineState arena, the VDP only keeps
+    a reference to it. The frame buffer is output, not state, and stays owned by the VDP.
+*/
+struct VDPState
+{
+    byte        vram[0x4000];
+    byte        cram[32];
+    byte        registers[16];
+    /* 14 bits: address. 2 MSB: code regiter */
+    word        command_word;
+    bool        is_first_byte;
+    /*
+        BIT 7   = Frame Interrupt Pending
+        BIT 6   = Sprite Overflow
+        BIT 5   = Sprite Collision
+        BIT 4-0 = Unused
+    */
+    byte        status_flags;
+    byte        read_buffer;
+    LINE_MODE   line_mode;
+    bool        pal;
+    bool        format_dirt;
+    uint16_t    h_counter; // 16 bits, only 9 used (pixel within the line)
+    uint16_t    v_counter;
+    uint32_t    cycle_count; // master cycles elapsed in the current line
+    VLineFormat line_format;
+    uint16_t    current_line;
+    bool        line_interrupt_pending;
+    byte        line_counter;
+    uint8_t     scroll_y;
+
+    uint32_t    lines_per_frame;
+    uint32_t    cycles_per_line; // master cycles
+};
+
 class Z80;
 struct VDPContext
 {
@@ -72,23 +115,26 @@ struct VDPContext
 
 class VDP
 {
-    enum class LINE_MODE : uint8_t
-    {
-        DEFAULT  = 192,
-        MODE_224 = 224,
-        MODE_240 = 240
-    };
-
 public:
     static constexpr uint32_t MAX_WIDTH = 256;
     static constexpr uint32_t MAX_HEIGHT = 192;
 
+    static constexpr uint32_t VRAM_PAGE_SHIFT = 10;
+    static constexpr uint32_t VRAM_PAGE_SIZE  = 1 << VRAM_PAGE_SHIFT;
+
 public:
-    VDP();
+    VDP(VDPState& state);
     ~VDP();
 
 public:
     inline void SetContext(const VDPContext& context) { m_context = context; }
+    // Frames emulated only for their state (run-ahead, skipped frames) don't draw into the frame buffer.
+    inline void SetRenderEnabled(bool enabled) { m_render_enabled = enabled; }
+
+    // Forked consoles (see SMS::Fork) read the VRAM from source until they write a 1KB page of it,
+    // which is then copied into their own state. Drawing a line copies whatever is still shared.
+    void ShareVRam   (const byte* source);
+    void UnshareVRam ();
 
 public:
     bool                     Tick		                (uint32_t cycles);
@@ -96,13 +142,16 @@ public:
 
 public:
 
+    // nullptr until the first line is drawn.
     inline const byte* const GetFrameBuffer     () const { return m_frame_buffer; }
-    inline void              SetVideoSystemInfo (uint32_t lines_per_frame, uint32_t cycles_per_line) { m_lines_per_frame = lines_per_frame; m_cycles_per_line = cycles_per_line; }
+    inline void              SetVideoSystemInfo (uint32_t lines_per_frame, uint32_t cycles_per_line) { m_state.lines_per_frame = lines_per_frame; m_state.cycles_per_line = cycles_per_line; }
+    // Master cycles until the current line ends, which is the next time the VDP state (counters, interrupts) changes.
+    inline uint32_t          GetCyclesToNextEvent () const { return m_state.cycles_per_line - m_state.cycle_count; }
 
 public:
-    inline byte         ReadControlPort          () const { return GetStatusFlags(); }
-    inline byte         GetStatusFlags           () const { return m_status_flags; }
-    inline byte         GetHCounter              () const { return m_h_counter; }
+    byte                ReadControlPort          ();
+    inline byte         GetStatusFlags           () const { return m_state.status_flags; }
+    inline byte         GetHCounter              () const { return static_cast<byte>(m_state.h_counter >> 1); }
     byte			    GetVCounter              () const;
     byte                ReadDataPort             ();
     void                WriteDataPort            (byte data);
@@ -128,9 +177,12 @@ private:
     const VLineFormat& GetCurrentLineFormat     ();
     void		       SetSpriteCollision		();
     void               SetSpriteOverflow        ();
-    bool               IsInterruptRequested     () const;
+    void               UpdateInterruptLines     ();
+    inline byte        ReadVRam                 (word address) const { return (m_shared_vram_pages >> (address >> VRAM_PAGE_SHIFT)) & 1 ? m_shared_vram[address] : m_state.vram[address]; }
+    void               WriteVRam                (word address, byte data);
 
 private:
+    bool               EndLine                  ();
     void               ScanLine                 (uint32_t line);
     void               ClearScreen              (uint32_t line);
     void               RenderBackground         (uint32_t line);
@@ -157,37 +209,11 @@ private:
     byte               GetOverscanColor         () const;
 
 private:
-    byte*       m_VRam;
-    byte*       m_CRam;
-    byte*       m_registers;
+    VDPState&   m_state;
     byte*       m_frame_buffer;
-    /* 14 bits: address. 2 MSB: code regiter */
-    word        m_command_word;
-    bool        m_is_first_byte;
-    /*
-        BIT 7   = Frame Interrupt Pending
-        BIT 6   = Sprite Overflow
-        BIT 5   = Sprite Collision
-        BIT 4-0 = Unused
-    */
-    byte        m_status_flags;
-    byte        m_read_buffer;
-    LINE_MODE   m_line_mode;
-    bool        m_pal;
-    uint16_t    m_h_counter; // 16 bits, only 9 used
-    uint16_t    m_v_counter;
-    uint32_t    m_cycle_count;
-    VLineFormat m_line_format;
-    bool        m_format_dirt;
-    uint16_t    m_current_line;
-    bool        m_request_interrupt;
-
-private:
-    uint8_t     m_scroll_y;
-
-private:
-    uint32_t    m_lines_per_frame;
-    uint32_t    m_cycles_per_line;
+    bool        m_render_enabled;
+    const byte* m_shared_vram;
+    uint16_t    m_shared_vram_pages; // Bit per 1KB page still read from m_shared_vram.
 
 private:
     VDPContext  m_context;
@@ -0,0 +1,497 @@
+#include "YM2413.h"
+#include "Z80.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+// About 93ms at 44.1kHz, like the PSG.
+constexpr uint32_t MAX_BUFFERED_SAMPLES = 4096;
+
+// Samples rendered together, one channel after the other.
+constexpr uint32_t BLOCK_SAMPLES = 64;
+
+constexpr uint32_t PHASE_MASK   = (1 << 19) - 1;
+constexpr uint32_t ENVELOPE_END = 127 << 16;
+constexpr int32_t  SILENCE      = 127;
+
+// Tremolo: a triangle of 105 steps up and down, one every 64 samples (3.7Hz), 0 to 13 envelope steps (4.8dB).
+constexpr uint32_t AM_PERIOD = 210 << 6;
+
+// Vibrato: 8 steps, one every 1024 samples (6.1Hz).
+constexpr int32_t VIBRATO_TABLE[8] = { 0, 1, 2, 1, 0, -1, -2, -1 };
+
+// Frequency multipliers, doubled.
+constexpr uint32_t MULTIPLIERS[16] = { 1, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 20, 24, 24, 30, 30 };
+
+// Key scale level attenuation by the top bits of the F-number, 6dB per octave before the KSL shift.
+constexpr int32_t  KSL_TABLE[16] = { 0, 32, 40, 45, 48, 51, 53, 55, 56, 58, 59, 60, 61, 62, 63, 64 };
+constexpr uint32_t KSL_SHIFT[4]  = { 8, 2, 1, 0 }; // Off, 1.5, 3 and 6dB per octave.
+
+// Rhythm keys of register 0x0E for the slots of channels 6 to 8: bass drum (both slots), hi-hat, snare, tom, top cymbal.
+constexpr byte RHYTHM_KEYS[6] = { 0x10, 0x10, 0x01, 0x08, 0x04, 0x02 };
+
+// Built-in instruments, laid out like the user instrument in registers 0x00-0x07. 1-15 are the
+// melodic ones, 16-18 the bass drum, hi-hat/snare and tom/top cymbal.
+constexpr byte PATCHES[19][8] =
+{
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // User, from the registers.
+    { 0x71, 0x61, 0x1e, 0x17, 0xd0, 0x78, 0x00, 0x17 }, // Violin
+    { 0x13, 0x41, 0x1a, 0x0d, 0xd8, 0xf7, 0x23, 0x13 }, // Guitar
+    { 0x13, 0x01, 0x99, 0x00, 0xf2, 0xc4, 0x21, 0x23 }, // Piano
+    { 0x11, 0x61, 0x0e, 0x07, 0x8d, 0x64, 0x70, 0x27 }, // Flute
+    { 0x32, 0x21, 0x1e, 0x06, 0xe1, 0x76, 0x01, 0x28 }, // Clarinet
+    { 0x31, 0x22, 0x16, 0x05, 0xe0, 0x71, 0x00, 0x18 }, // Oboe
+    { 0x21, 0x61, 0x1d, 0x07, 0x82, 0x81, 0x11, 0x07 }, // Trumpet
+    { 0x33, 0x21, 0x2d, 0x13, 0xb0, 0x70, 0x00, 0x07 }, // Organ
+    { 0x61, 0x61, 0x1b, 0x06, 0x64, 0x65, 0x10, 0x17 }, // Horn
+    { 0x41, 0x61, 0x0b, 0x18, 0x85, 0xf0, 0x81, 0x07 }, // Synthesizer
+    { 0x33, 0x01, 0x83, 0x11, 0xea, 0xef, 0x10, 0x04 }, // Harpsichord
+    { 0x17, 0xc1, 0x24, 0x07, 0xf8, 0xf8, 0x22, 0x12 }, // Vibraphone
+    { 0x61, 0x50, 0x0c, 0x05, 0xd2, 0xf5, 0x40, 0x42 }, // Synth bass
+    { 0x01, 0x01, 0x55, 0x03, 0xe9, 0x90, 0x03, 0x02 }, // Acoustic bass
+    { 0x41, 0x41, 0x89, 0x03, 0xf1, 0xe4, 0xc0, 0x13 }, // Electric guitar
+    { 0x01, 0x01, 0x18, 0x0f, 0xdf, 0xf8, 0x6a, 0x6d }, // Bass drum
+    { 0x01, 0x01, 0x00, 0x00, 0xc8, 0xd8, 0xa7, 0x68 }, // Hi-hat, snare
+    { 0x05, 0x01, 0x00, 0x00, 0xf8, 0xaa, 0x59, 0x55 }, // Tom, top cymbal
+};
+
+namespace
+{
+    struct Tables
+    {
+        uint16_t log_sin[256]; // Attenuation of the first quarter of the sine, 1/256 of a halving.
+        uint16_t exp[256];     // Linear level of 12 bits for an attenuation fraction.
+    };
+
+    void BuildTables(Tables& tables)
+    {
+        constexpr double PI = 3.14159265358979323846;
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            tables.log_sin[i] = static_cast<uint16_t>(lround(-log2(sin((i + 0.5) * PI / 512.0)) * 256.0));
+            tables.exp[i]     = static_cast<uint16_t>(lround(4095.0 * exp2(-static_cast<double>(i) / 256.0)));
+        }
+    }
+
+    const Tables& GetTables()
+    {
+        static Tables tables;
+        static const bool built = (BuildTables(tables), true);
+        (void)built;
+        return tables;
+    }
+
+    // Envelope change per sample, 16 bits of fraction, for a 4 bits rate and the key scaling.
+    // Each rate doubles the speed every 4 steps, the low bits interpolate in between.
+    uint32_t GetRateStep(uint32_t rate, uint32_t key_scale)
+    {
+        if (rate == 0)
+            return 0;
+
+        const uint32_t effective = rate * 4 + key_scale < 63 ? rate * 4 + key_scale : 63;
+        return ((4 + (effective & 3)) << (effective >> 2)) << 1;
+    }
+};
+
+// One slot decoded from the registers, constant over a block.
+struct YM2413::SlotParams
+{
+    uint32_t phase_step;     // Per sample.
+    int32_t  vibrato_step;   // Per unit of VIBRATO_TABLE, 0 without vibrato.
+    uint32_t attack_step;    // The attack is exponential, this scales the remaining attenuation.
+    uint32_t decay_step;
+    uint32_t sustain_step;   // 0 for sustained instruments, which hold their level while the key is on.
+    uint32_t release_step;
+    uint32_t sustain_level;  // Where the decay stops, with the fraction.
+    int32_t  level;          // Total level (or volume) and key scaling, in envelope steps.
+    bool     am;
+    bool     half_sine;
+    uint8_t  feedback;
+};
+
+YM2413::YM2413(YM2413State& state) :
+    m_state          (state),
+    m_output         (MAX_BUFFERED_SAMPLES),
+    m_frame_start    (0),
+    m_output_enabled (true)
+{
+    ResetState(m_state, 0);
+}
+
+void YM2413::ResetState(YM2413State& state, uint64_t cycle)
+{
+    memset(&state, 0, sizeof(state));
+
+    for (YM2413Slot& slot : state.slots)
+    {
+        slot.envelope = ENVELOPE_END;
+        slot.eg_state = EG_OFF;
+    }
+
+    state.noise = 1;
+    state.cycle = cycle;
+}
+
+void YM2413::Reset(uint64_t cycle)
+{
+    ResetState(m_state, cycle);
+    m_output.Clear();
+    m_frame_start = cycle;
+}
+
+void YM2413::SetOutputRate(uint32_t cpu_clock, uint32_t sample_rate)
+{
+    m_output.SetRates(cpu_clock, sample_rate);
+    GetTables();
+    m_frame_start = m_state.cycle;
+}
+
+void YM2413::Resync()
+{
+    m_frame_start = m_state.cycle;
+}
+
+void YM2413::WriteData(byte data)
+{
+    assert(m_context.cpu != nullptr && "The FM unit needs the CPU clock");
+    WriteRegister(m_state.address, data, m_context.cpu->GetTotalCycles());
+}
+
+void YM2413::WriteControl(byte data)
+{
+    assert(m_context.cpu != nullptr && "The FM unit needs the CPU clock");
+
+    // The output changes from this cycle on.
+    Run(m_context.cpu->GetTotalCycles());
+    m_state.audio_control = data & 0x7;
+}
+
+void YM2413::WriteRegister(byte reg, byte data, uint64_t cycle)
+{
+    // Everything before the write plays with the old registers.
+    Run(cycle);
+
+    reg &= 0x3f;
+    m_state.registers[reg] = data;
+
+    if (reg == 0x0e || (reg >= 0x20 && reg <= 0x28))
+        UpdateKeys();
+}
+
+void YM2413::EndFrame(uint64_t cycle)
+{
+    Run(cycle);
+
+    if (m_output_enabled)
+        m_output.EndFrame(static_cast<uint32_t>(cycle - m_frame_start));
+
+    m_frame_start = cycle;
+}
+
+void YM2413::Run(uint64_t cycle)
+{
+    if (cycle <= m_state.cycle)
+        return;
+
+    uint64_t num_samples = (cycle - m_state.cycle + CYCLES_PER_SAMPLE - 1) / CYCLES_PER_SAMPLE;
+    const bool audible = (m_state.audio_control & 1) != 0;
+
+    while (num_samples > 0)
+    {
+        const uint32_t count = num_samples < BLOCK_SAMPLES ? static_cast<uint32_t>(num_samples) : BLOCK_SAMPLES;
+
+        int32_t mix[BLOCK_SAMPLES];
+        RenderBlock(count, mix);
+
+        // Only the changes go to the output, a held level costs nothing.
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // Every channel at full level reaches about 65K, halved it stays within 16 bits like the PSG.
+            const int32_t sample = audible ? mix[i] >> 1 : 0;
+            if (sample != m_state.last_output)
+            {
+                if (m_output_enabled && m_state.cycle >= m_frame_start)
+                    m_output.AddDelta(static_cast<uint32_t>(m_state.cycle - m_frame_start), sample - m_state.last_output);
+                m_state.last_output = sample;
+            }
+            m_state.cycle += CYCLES_PER_SAMPLE;
+        }
+
+        num_samples -= count;
+    }
+}
+
+void YM2413::RenderBlock(uint32_t count, int32_t* mix)
+{
+    // The LFOs are shared by every channel, computed once for the block.
+    int32_t am[BLOCK_SAMPLES];
+    int32_t vibrato[BLOCK_SAMPLES];
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t am_step = m_state.am_phase >> 6;
+        am[i]      = static_cast<int32_t>((am_step < 105 ? am_step : 209 - am_step) >> 3);
+        vibrato[i] = VIBRATO_TABLE[(m_state.vibrato_phase >> 10) & 7];
+        mix[i]     = 0;
+
+        m_state.am_phase      = m_state.am_phase + 1 < AM_PERIOD ? m_state.am_phase + 1 : 0;
+        m_state.vibrato_phase = (m_state.vibrato_phase + 1) & 0x1fff;
+    }
+
+    const bool     rhythm       = IsRhythmMode();
+    const uint32_t num_melodic  = rhythm ? 6 : NUM_CHANNELS;
+
+    for (uint32_t channel = 0; channel < num_melodic; ++channel)
+        RenderChannel(channel, count, am, vibrato, mix);
+
+    if (rhythm)
+        RenderRhythm(count, am, vibrato, mix);
+}
+
+void YM2413::RenderChannel(uint32_t channel, uint32_t count, const int32_t* am, const int32_t* vibrato, int32_t* mix)
+{
+    YM2413Slot& modulator = m_state.slots[channel * 2];
+    YM2413Slot& carrier   = m_state.slots[channel * 2 + 1];
+
+    // Silent until the next key on, which restarts the phases anyway.
+    if (modulator.eg_state == EG_OFF && carrier.eg_state == EG_OFF)
+        return;
+
+    SlotParams mod;
+    SlotParams car;
+    GetSlotParams(channel, 0, mod);
+    GetSlotParams(channel, 1, car);
+
+    // The rhythm bass drum plays twice as loud as a melodic channel.
+    const int32_t gain = channel == 6 && IsRhythmMode() ? 2 : 1;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const int32_t feedback = mod.feedback ? (modulator.output[0] + modulator.output[1]) >> (9 - mod.feedback) : 0;
+        const int32_t mod_out  = Operator(static_cast<uint32_t>(static_cast<int32_t>(modulator.phase >> 9) + feedback), GetAttenuation(modulator, mod, am[i]), mod.half_sine);
+
+        modulator.output[1] = modulator.output[0];
+        modulator.output[0] = static_cast<int16_t>(mod_out);
+
+        // The modulator swings the carrier phase by up to 2 periods either way.
+        const int32_t car_out = Operator(static_cast<uint32_t>(static_cast<int32_t>(carrier.phase >> 9) + (mod_out >> 1)), GetAttenuation(carrier, car, am[i]), car.half_sine);
+        mix[i] += car_out * gain;
+
+        modulator.phase = (modulator.phase + static_cast<uint32_t>(static_cast<int32_t>(mod.phase_step) + mod.vibrato_step * vibrato[i])) & PHASE_MASK;
+        carrier.phase   = (carrier.phase   + static_cast<uint32_t>(static_cast<int32_t>(car.phase_step) + car.vibrato_step * vibrato[i])) & PHASE_MASK;
+
+        StepEnvelope(modulator, mod);
+        StepEnvelope(carrier,   car);
+    }
+}
+
+void YM2413::RenderRhythm(uint32_t count, const int32_t* am, const int32_t* vibrato, int32_t* mix)
+{
+    // The bass drum is a normal channel, the other four sounds use one slot each of channels 7 and 8.
+    RenderChannel(6, count, am, vibrato, mix);
+
+    YM2413Slot& hi_hat     = m_state.slots[14];
+    YM2413Slot& snare      = m_state.slots[15];
+    YM2413Slot& tom        = m_state.slots[16];
+    YM2413Slot& top_cymbal = m_state.slots[17];
+
+    SlotParams hh;
+    SlotParams sd;
+    SlotParams tt;
+    SlotParams tc;
+    GetSlotParams(7, 0, hh);
+    GetSlotParams(7, 1, sd);
+    GetSlotParams(8, 0, tt);
+    GetSlotParams(8, 1, tc);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (m_state.noise & 1)
+            m_state.noise ^= 0x800302;
+        m_state.noise >>= 1;
+
+        const uint32_t noise = m_state.noise & 1;
+
+        // The metallic sounds mix bits of the hi-hat and top cymbal phases instead of a sine.
+        const uint32_t h    = hi_hat.phase >> 9;
+        const uint32_t t    = top_cymbal.phase >> 9;
+        const uint32_t ring = (((h >> 2) ^ (h >> 7)) | ((h >> 3) ^ (t >> 5)) | ((t >> 3) ^ (t >> 5))) & 1;
+        const uint32_t bit8 = (h >> 8) & 1;
+
+        int32_t out = 0;
+        out += Operator((ring << 9) | ((ring ^ noise) ? 0xd0 : 0x34), GetAttenuation(hi_hat, hh, am[i]), false);
+        out += Operator((bit8 << 9) | ((bit8 ^ noise) << 8),          GetAttenuation(snare, sd, am[i]), false);
+        out += Operator(tom.phase >> 9,                              GetAttenuation(tom, tt, am[i]), tt.half_sine);
+        out += Operator((ring << 9) | 0x80,                          GetAttenuation(top_cymbal, tc, am[i]), false);
+        mix[i] += out * 2;
+
+        hi_hat.phase     = (hi_hat.phase     + static_cast<uint32_t>(static_cast<int32_t>(hh.phase_step) + hh.vibrato_step * vibrato[i])) & PHASE_MASK;
+        snare.phase      = (snare.phase      + static_cast<uint32_t>(static_cast<int32_t>(sd.phase_step) + sd.vibrato_step * vibrato[i])) & PHASE_MASK;
+        tom.phase        = (tom.phase        + static_cast<uint32_t>(static_cast<int32_t>(tt.phase_step) + tt.vibrato_step * vibrato[i])) & PHASE_MASK;
+        top_cymbal.phase = (top_cymbal.phase + static_cast<uint32_t>(static_cast<int32_t>(tc.phase_step) + tc.vibrato_step * vibrato[i])) & PHASE_MASK;
+
+        StepEnvelope(hi_hat,     hh);
+        StepEnvelope(snare,      sd);
+        StepEnvelope(tom,        tt);
+        StepEnvelope(top_cymbal, tc);
+    }
+}
+
+void YM2413::UpdateKeys()
+{
+    const byte rhythm_keys = IsRhythmMode() ? m_state.registers[0x0e] : 0;
+
+    for (uint32_t index = 0; index < 18; ++index)
+    {
+        const uint32_t channel = index >> 1;
+
+        bool key = (m_state.registers[0x20 + channel] & 0x10) != 0;
+        if (index >= 12)
+            key = key || (rhythm_keys & RHYTHM_KEYS[index - 12]) != 0;
+
+        YM2413Slot& slot = m_state.slots[index];
+        if (key == (slot.key_on != 0))
+            continue;
+
+        slot.key_on = key ? 1 : 0;
+
+        if (key)
+        {
+            // The attack starts from the current attenuation, the wave from the start.
+            slot.eg_state  = EG_ATTACK;
+            slot.phase     = 0;
+            slot.output[0] = 0;
+            slot.output[1] = 0;
+        }
+        else if (slot.eg_state != EG_OFF)
+        {
+            slot.eg_state = EG_RELEASE;
+        }
+    }
+}
+
+const byte* YM2413::GetPatch(uint32_t channel) const
+{
+    if (channel >= 6 && IsRhythmMode())
+        return PATCHES[16 + channel - 6];
+
+    const uint32_t instrument = m_state.registers[0x30 + channel] >> 4;
+    return instrument == 0 ? m_state.registers : PATCHES[instrument];
+}
+
+void YM2413::GetSlotParams(uint32_t channel, uint32_t op, SlotParams& params) const
+{
+    const byte* patch  = GetPatch(channel);
+    const byte  flags  = patch[op];
+    const byte  key    = m_state.registers[0x20 + channel];
+    const byte  volume = m_state.registers[0x30 + channel];
+
+    const uint32_t fnum       = m_state.registers[0x10 + channel] | ((key & 1) << 8);
+    const uint32_t block      = (key >> 1) & 0x7;
+    const uint32_t multiplier = MULTIPLIERS[flags & 0xf];
+
+    params.phase_step   = ((fnum << block) * multiplier) >> 1;
+    params.vibrato_step = (flags & 0x40) ? static_cast<int32_t>((((fnum >> 6) << block) * multiplier) >> 2) : 0;
+
+    // Higher notes run their envelope faster, a lot faster with KSR.
+    const uint32_t key_scale = ((block << 1) | (fnum >> 8)) >> ((flags & 0x10) ? 0 : 2);
+    const bool     sustained = (flags & 0x20) != 0;
+    const uint32_t release   = patch[6 + op] & 0xf;
+
+    params.attack_step   = GetRateStep(patch[4 + op] >> 4, key_scale);
+    params.decay_step    = GetRateStep(patch[4 + op] & 0xf, key_scale);
+    params.sustain_step  = sustained ? 0 : GetRateStep(release, key_scale);
+    params.sustain_level = ((patch[6 + op] >> 4) * 8) << 16;
+
+    // At key off, the sustain switch of the channel gives a slow release whatever the instrument.
+    if (key & 0x20)
+        params.release_step = GetRateStep(5, key_scale);
+    else
+        params.release_step = GetRateStep(sustained ? release : 7, key_scale);
+
+    // Higher notes are also quieter with KSL.
+    const uint32_t ksl_bits = (op == 0 ? patch[2] : patch[3]) >> 6;
+    int32_t        ksl      = (KSL_TABLE[fnum >> 5] << 2) - ((8 - static_cast<int32_t>(block)) << 5);
+    ksl = ksl > 0 && ksl_bits ? (ksl >> KSL_SHIFT[ksl_bits]) >> 1 : 0;
+
+    // Modulators have the total level of the instrument (0.75dB steps), carriers the volume of the
+    // channel (3dB steps). The hi-hat and the tom are modulator slots with a volume of their own.
+    int32_t level = 0;
+    if (op == 1)
+        level = (volume & 0xf) * 8;
+    else if (channel >= 7 && IsRhythmMode())
+        level = (volume >> 4) * 8;
+    else
+        level = (patch[2] & 0x3f) * 2;
+
+    params.level     = level + ksl;
+    params.am        = (flags & 0x80) != 0;
+    params.half_sine = (patch[3] & (op == 0 ? 0x08 : 0x10)) != 0;
+    params.feedback  = op == 0 ? patch[3] & 0x7 : 0;
+}
+
+void YM2413::StepEnvelope(YM2413Slot& slot, const SlotParams& params)
+{
+    switch (slot.eg_state)
+    {
+    case EG_ATTACK:
+    {
+        const uint32_t decrement = static_cast<uint32_t>((static_cast<uint64_t>(slot.envelope) * params.attack_step) >> 18);
+        slot.envelope = decrement < slot.envelope ? slot.envelope - decrement : 0;
+
+        if (slot.envelope < (1 << 16))
+        {
+            slot.envelope = 0;
+            slot.eg_state = EG_DECAY;
+        }
+        return;
+    }
+    case EG_DECAY:
+        slot.envelope += params.decay_step;
+        if (slot.envelope >= params.sustain_level)
+        {
+            slot.envelope = params.sustain_level;
+            slot.eg_state = EG_SUSTAIN;
+        }
+        break;
+    case EG_SUSTAIN:
+        slot.envelope += params.sustain_step;
+        break;
+    case EG_RELEASE:
+        slot.envelope += params.release_step;
+        break;
+    default:
+        return;
+    }
+
+    if (slot.envelope >= ENVELOPE_END)
+    {
+        slot.envelope = ENVELOPE_END;
+        slot.eg_state = EG_OFF;
+    }
+}
+
+int32_t YM2413::GetAttenuation(const YM2413Slot& slot, const SlotParams& params, int32_t am)
+{
+    const int32_t attenuation = static_cast<int32_t>(slot.envelope >> 16) + params.level + (params.am ? am : 0);
+    return attenuation < SILENCE ? attenuation : SILENCE;
+}
+
+int32_t YM2413::Operator(uint32_t phase_index, int32_t attenuation, bool half_sine)
+{
+    phase_index &= 1023;
+
+    // Half sine instruments are silent over the negative half.
+    if (attenuation >= SILENCE || (half_sine && (phase_index & 512)))
+        return 0;
+
+    const Tables& tables = GetTables();
+
+    // The quarter wave table mirrored, the envelope added as attenuation (16 units of 1/256 per 0.375dB step).
+    const uint32_t quarter = (phase_index & 256) ? (~phase_index & 255) : (phase_index & 255);
+    const uint32_t log     = tables.log_sin[quarter] + (static_cast<uint32_t>(attenuation) << 4);
+    const int32_t  linear  = log < (12 << 8) ? tables.exp[log & 255] >> (log >> 8) : 0;
+
+    return (phase_index & 512) ? -linear : linear;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Types.h"
+#include "BandLimitedBuffer.h"
+
+// One operator of the YM2413, part of YM2413State.
+struct YM2413Slot
+{
+    uint32_t phase;     // 19 bits, the top 10 index the sine.
+    uint32_t envelope;  // Attenuation in steps of 0.375dB, 16 bits of fraction. 127 is silence.
+    uint8_t  eg_state;  // YM2413::EnvelopeState.
+    uint8_t  key_on;
+    int16_t  output[2]; // Last two outputs, fed back into the modulators.
+};
+
+/*
+    YM2413 (OPLL) registers and generators. Part of the MachineState arena, the chip only keeps
+    a reference to it. Slots are the modulator then the carrier of each of the 9 channels.
+*/
+struct YM2413State
+{
+    byte       registers[0x40];
+    byte       address;         // Register selected by port 0xF0.
+    byte       audio_control;   // Port 0xF2, bit 0 turns the FM output on.
+    YM2413Slot slots[18];
+    uint32_t   am_phase;        // Samples into the tremolo period.
+    uint32_t   vibrato_phase;   // Samples into the vibrato period.
+    uint32_t   noise;           // 23 bits shift register of the rhythm sounds.
+    int32_t    last_output;     // Last sample handed to the output, the next one is a step from it.
+    uint64_t   cycle;           // CPU cycle of the next sample.
+};
+
+class Z80;
+struct YM2413Context
+{
+    YM2413Context() {}
+    YM2413Context(Z80* _cpu) : cpu(_cpu) {}
+
+    Z80* cpu = nullptr;
+};
+
+/*
+    FM sound unit of the Japanese Master System (ports 0xF0-0xF2): 9 two-operator channels, or 6
+    and 5 rhythm sounds, 15 built-in instruments and a user defined one.
+
+    Like the real chip, the synthesis works on attenuations: a log-sine table gives the attenuation
+    of the wave, the envelope, levels and tremolo are added to it in 0.375dB steps and a single
+    exponential table lookup turns the sum into a linear sample. Everything is fixed point.
+
+    The chip makes a sample every 72 clocks (49.7kHz at the 3.58MHz clock shared with the CPU).
+    Samples are rendered in blocks, one channel at a time over the whole block, so the parameters
+    of a channel are decoded once per block rather than once per sample. A register write renders
+    up to its cycle first, so a block never straddles a change. Each sample goes to a
+    BandLimitedBuffer as a step from the previous one, which also resamples to the output rate.
+*/
+class YM2413
+{
+public:
+    static constexpr uint32_t CYCLES_PER_SAMPLE = 72;
+    static constexpr uint32_t NUM_CHANNELS      = 9;
+
+    enum EnvelopeState : uint8_t
+    {
+        EG_ATTACK,
+        EG_DECAY,
+        EG_SUSTAIN,
+        EG_RELEASE,
+        EG_OFF
+    };
+
+public:
+    YM2413(YM2413State& state);
+
+    inline void SetContext(const YM2413Context& context) { m_context = context; }
+
+    // Power on state, the chip runs from cycle.
+    void Reset            (uint64_t cycle);
+    static void ResetState(YM2413State& state, uint64_t cycle);
+
+    void SetOutputRate    (uint32_t cpu_clock, uint32_t sample_rate);
+    // Frames emulated only for their state (run-ahead) don't produce sound.
+    inline void SetOutputEnabled(bool enabled) { m_output_enabled = enabled; }
+    // The state was replaced (loaded, rewound), the output goes on from its cycle.
+    void Resync           ();
+
+    // Ports 0xF0, 0xF1 and 0xF2.
+    inline void WriteAddress (byte data) { m_state.address = data & 0x3f; }
+    void        WriteData    (byte data);
+    void        WriteControl (byte data);
+    inline byte ReadControl  () const { return m_state.audio_control; }
+
+    // The audio control selects the FM output (bit 0), the PSG is muted when only the FM is selected
+    // and when neither is.
+    inline bool IsPSGAudible () const { return (m_state.audio_control & 0x3) == 0 || (m_state.audio_control & 0x3) == 0x3; }
+
+    // Register write at the given CPU cycle, what the data port does with the CPU clock.
+    void WriteRegister (byte reg, byte data, uint64_t cycle);
+    void EndFrame      (uint64_t cycle);
+
+    BandLimitedBuffer& GetOutput() { return m_output; }
+
+private:
+    struct SlotParams;
+
+private:
+    void Run               (uint64_t cycle);
+    void RenderBlock       (uint32_t count, int32_t* mix);
+    void RenderChannel     (uint32_t channel, uint32_t count, const int32_t* am, const int32_t* vibrato, int32_t* mix);
+    void RenderRhythm      (uint32_t count, const int32_t* am, const int32_t* vibrato, int32_t* mix);
+    void UpdateKeys        ();
+    void GetSlotParams     (uint32_t channel, uint32_t op, SlotParams& params) const;
+    const byte* GetPatch   (uint32_t channel) const;
+    bool IsRhythmMode      () const { return (m_state.registers[0x0e] & 0x20) != 0; }
+
+    static void    StepEnvelope (YM2413Slot& slot, const SlotParams& params);
+    static int32_t GetAttenuation(const YM2413Slot& slot, const SlotParams& params, int32_t am);
+    static int32_t Operator     (uint32_t phase_index, int32_t attenuation, bool half_sine);
+
+private:
+    YM2413State&      m_state;
+    YM2413Context     m_context;
+    BandLimitedBuffer m_output;
+    uint64_t          m_frame_start;    // CPU cycle of time 0 in m_output.
+    bool              m_output_enabled;
+};
@@ -9,73 +9,70 @@
 
 #include <iostream>
 
-Z80::Z80() :
-    m_memory		  (new Memory()),
-    m_reg_AF		  (0x0040),
-    m_reg_BC		  (0x0000),
-    m_reg_DE		  (0x0000),
-    m_reg_HL		  (0x0000),
-    m_reg_AF_shadow   (0x0000),
-    m_reg_BC_shadow   (0x0000),
-    m_reg_DE_shadow   (0x0000),
-    m_reg_HL_shadow   (0x0000),
-    m_reg_IX		  (0xFFFF),
-    m_reg_IY          (0xFFFF),
-    m_program_counter (0x0000),
-    m_stack_pointer   (0xDFF0),
-    m_cycle_count     (0x0000),
-    m_current_prefix  (0x0000),
-    m_reg_interrupt   (0x00),
-    m_reg_refresh	  (0x00),
-    m_halt			  (false),
-    m_IFF1            (false),
-    m_IFF2            (false),
-    m_after_EI        (false),
-    m_interrupt_mode  (InterruptMode::MODE_0)
-{
-
-}
-
-Z80::~Z80()
-{
-   
+Z80::Z80(Z80State& state, Memory* memory) :
+    m_state  (state),
+    m_memory (memory)
+{
+    assert(m_memory != nullptr && "The CPU needs a memory to run");
+    Reset();
 }
 
 void Z80::Reset()
 {
-    //m_memory = new Memory();
-    m_reg_AF = 0x0040;
-    m_reg_BC = 0x0000;
-    m_reg_DE = 0x0000;
-    m_reg_HL = 0x0000;
-    m_reg_AF_shadow = 0x0000;
-    m_reg_BC_shadow = 0x0000;
-    m_reg_DE_shadow = 0x0000;
-    m_reg_HL_shadow = 0x0000;
-    m_reg_IX = 0xFFFF;
-    m_reg_IY = 0xFFFF;
-    m_program_counter = 0x0000;
-    m_stack_pointer = 0xDFF0;
-    m_cycle_count = 0x0000;
-    m_current_prefix = 0x0000;
-    m_reg_interrupt = 0x00;
-    m_reg_refresh = 0x00;
-    m_halt = false;
-    m_IFF1 = false;
-    m_IFF2 = false;
-    m_after_EI = false;
-    m_interrupt_mode = InterruptMode::MODE_0;
+    m_state.reg_AF = 0x0040;
+    m_state.reg_BC = 0x0000;
+    m_state.reg_DE = 0x0000;
+    m_state.reg_HL = 0x0000;
+    m_state.reg_AF_shadow = 0x0000;
+    m_state.reg_BC_shadow = 0x0000;
+    m_state.reg_DE_shadow = 0x0000;
+    m_state.reg_HL_shadow = 0x0000;
+    m_state.reg_IX = 0xFFFF;
+    m_state.reg_IY = 0xFFFF;
+    m_state.program_counter = 0x0000;
+    m_state.stack_pointer = 0xDFF0;
+    m_state.cycle_count = 0x0000;
+    m_state.total_cycles = 0;
+    m_state.current_prefix = 0x0000;
+    m_state.reg_interrupt = 0x00;
+    m_state.reg_refresh = 0x00;
+    m_state.halt = false;
+    m_state.IFF1 = false;
+    m_state.IFF2 = false;
+    m_state.after_EI = false;
+    m_state.pending_events = EVENT_NONE;
+    m_state.interrupt_mode = InterruptMode::MODE_0;
 }
 
 uint32_t Z80::Tick()
 {
-    m_cycle_count = 0;
+    m_state.cycle_count = 0;
 
-    byte opcode = ReadByte();
-    m_cycle_count += ProcessOPCode(opcode, Z80Instructions::s_opcode_funcs);
-    
-    // std::cout << "Running OPCode: " << std::hex << static_cast<int>(opcode) << "\n";
-    return m_cycle_count;
+    // Single check for IRQ lines, NMI and EI delay.
+    if (m_state.pending_events != EVENT_NONE && ProcessPendingEvents())
+    {
+        // Interrupt accepted, m_state.cycle_count holds its cost.
+    }
+    else if (m_state.halt)
+    {
+        // While halted the CPU keeps executing NOPs until an interrupt is accepted.
+        IncrementRefresh();
+        m_state.cycle_count = 4;
+    }
+    else
+    {
+#if SMS_ENABLE_TRACE
+        RecordTrace();
+#endif
+        byte opcode = ReadByte();
+        m_state.cycle_count += ProcessOPCode(opcode, Z80Instructions::s_opcode_funcs);
+#if SMS_ENABLE_TRACE
+        m_trace.Commit();
+#endif
+    }
+
+    m_state.total_cycles += m_state.cycle_count;
+    return m_state.cycle_count;
 }
 
 uint32_t Z80::ProcessOPCode(byte opcode, OPCodeFunc funcs [256])
@@ -87,11 +84,86 @@ uint32_t Z80::ProcessOPCode(byte opcode, OPCodeFunc funcs [256])
     return funcs[opcode](*this);
 }
 
+bool Z80::ProcessPendingEvents()
+{
+    if (m_state.pending_events & EVENT_NMI)
+    {
+        m_state.pending_events &= ~EVENT_NMI;
+
+        // NMI can't be masked. IFF1 is kept in IFF2 so RETN can restore it.
+        m_state.IFF2 = m_state.IFF1;
+        m_state.IFF1 = false;
+        AcceptInterrupt(0x0066);
+        m_state.cycle_count += 11;
+        return true;
+    }
+
+    if (m_state.pending_events & EVENT_EI_DELAY)
+    {
+        // The instruction following EI is always executed before accepting an interrupt.
+        m_state.pending_events &= ~EVENT_EI_DELAY;
+        m_state.after_EI = false;
+        return false;
+    }
+
+    if ((m_state.pending_events & EVENT_IRQ_MASK) && m_state.IFF1)
+    {
+        m_state.IFF1 = false;
+        m_state.IFF2 = false;
+
+        switch (m_state.interrupt_mode)
+        {
+        case InterruptMode::MODE_2:
+        {
+            // Data bus is floating on SMS (0xFF), so the vector is read from I * 256 + 0xFF.
+            const word vector  = (m_state.reg_interrupt << 8) | 0xFF;
+            const word address = m_memory->ReadMemory(vector) | (m_memory->ReadMemory(vector + 1) << 8);
+            AcceptInterrupt(address);
+            m_state.cycle_count += 19;
+            break;
+        }
+        default:
+            // Mode 0 reads 0xFF (RST 38h) from the floating bus, which is the same as mode 1.
+            AcceptInterrupt(0x0038);
+            m_state.cycle_count += 13;
+            break;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+#if SMS_ENABLE_TRACE
+void Z80::RecordTrace()
+{
+    Z80TraceEntry& entry = m_trace.Begin();
+    entry.cycle = m_state.total_cycles;
+    entry.pc    = m_state.program_counter;
+    entry.af    = m_state.reg_AF.value;
+    entry.bc    = m_state.reg_BC.value;
+    entry.de    = m_state.reg_DE.value;
+    entry.hl    = m_state.reg_HL.value;
+    entry.ix    = m_state.reg_IX.value;
+    entry.iy    = m_state.reg_IY.value;
+    entry.sp    = m_state.stack_pointer;
+}
+#endif
+
+void Z80::AcceptInterrupt(word address)
+{
+    m_state.halt = false;
+    IncrementRefresh();
+
+    PUSH(Register(m_state.program_counter));
+    m_state.program_counter = address;
+}
+
 void Z80::IncrementRefresh()
 {
     // once the lower 6 bits or the r register reaches 127 
     // then the lower 6 bits are all set to 0
-    m_reg_refresh = ((m_reg_refresh + 1) & 0x7F) | (m_reg_refresh & 0x80);
+    m_state.reg_refresh = ((m_state.reg_refresh + 1) & 0x7F) | (m_state.reg_refresh & 0x80);
 }
 
 bool Z80::HasParity(const byte data)
@@ -109,57 +181,64 @@ bool Z80::HasParity(const byte data)
 
 word Z80::ReadWord()
 {
-    const word result = m_memory->ReadMemory(m_program_counter + 1) << 8 | m_memory->ReadMemory(m_program_counter);
-    m_program_counter += 2;
+    const word result = m_memory->ReadMemory(m_state.program_counter + 1) << 8 | m_memory->ReadMemory(m_state.program_counter);
+    m_state.program_counter += 2;
+#if SMS_ENABLE_TRACE
+    m_trace.AddByte(result & 0xFF);
+    m_trace.AddByte(result >> 8);
+#endif
     return result;
 }
 
 byte Z80::ReadByte()
 {
-    const byte result = m_memory->ReadMemory(m_program_counter);
-    ++m_program_counter;
+    const byte result = m_memory->ReadMemory(m_state.program_counter);
+    ++m_state.program_counter;
+#if SMS_ENABLE_TRACE
+    m_trace.AddByte(result);
+#endif
     return result;
 }
 
 bool Z80::ReadFlag(FLAG flag)
 {
-    return m_reg_AF.lo & (1 << flag);
+    return m_state.reg_AF.lo & (1 << flag);
 }
 
 void Z80::WriteFlag(FLAG flag, bool value)
 {
-    m_reg_AF.lo = value ? (m_reg_AF.lo | (1<<flag)) : (m_reg_AF.lo & ~(1<<flag));
+    m_state.reg_AF.lo = value ? (m_state.reg_AF.lo | (1<<flag)) : (m_state.reg_AF.lo & ~(1<<flag));
 }
 
 Register& Z80::GetPrefixedHL()
 {
-    switch (m_current_prefix)
+    switch (m_state.current_prefix)
     {
-        case 0xDD: return m_reg_IX;
-        case 0xFD: return m_reg_IY;
-        default:   return m_reg_HL;
+        case 0xDD: return m_state.reg_IX;
+        case 0xFD: return m_state.reg_IY;
+        default:   return m_state.reg_HL;
     }
 }
 
 
 word Z80::GetPrefixedHLAddress()
 {
-    switch (m_current_prefix)
+    switch (m_state.current_prefix)
     {
     case 0xDD:
     {
-        const byte offset = m_memory->ReadMemory(m_program_counter);
-        ++m_program_counter;
-        return m_reg_IX.value + offset;
+        const byte offset = m_memory->ReadMemory(m_state.program_counter);
+        ++m_state.program_counter;
+        return m_state.reg_IX.value + offset;
     }
     case 0xED:
     {
-        const byte offset = m_memory->ReadMemory(m_program_counter);
-        ++m_program_counter;
-        return m_reg_IY.value + offset;
+        const byte offset = m_memory->ReadMemory(m_state.program_counter);
+        ++m_state.program_counter;
+        return m_state.reg_IY.value + offset;
     }
     default:
-        return m_reg_HL.value;
+        return m_state.reg_HL.value;
     }
 }
 
@@ -246,12 +325,12 @@ void Z80::ADC_HL(byte& acc)
 
 void Z80::ADC_HL(word num)
 {
-    const uint32_t result     = m_reg_HL.value + num + ReadFlag(CARRY);
+    const uint32_t result     = m_state.reg_HL.value + num + ReadFlag(CARRY);
     const bool     zero       = (result & 0xFFFF) == 0;
     const bool     carry      = (result > 0xFFFF);
-    const bool     half_carry = ((m_reg_HL.value & 0x0FFF) + (num & 0x0FFF) >= 0x0FFF);
+    const bool     half_carry = ((m_state.reg_HL.value & 0x0FFF) + (num & 0x0FFF) >= 0x0FFF);
     const bool     sign       = (result & (0x80)) != 0;
-    const bool     overflow   = ((m_reg_HL.value & 0x80) != (num & 0x80)) && ((num & 0x80) == (result & 0x80));
+    const bool     overflow   = ((m_state.reg_HL.value & 0x80) != (num & 0x80)) && ((num & 0x80) == (result & 0x80));
 
     WriteFlag(ZERO,            zero);
     WriteFlag(CARRY,           carry);
@@ -260,19 +339,19 @@ void Z80::ADC_HL(word num)
     WriteFlag(PARITY_OVERFLOW, overflow);
     WriteFlag(ADD_SUBSTRACT,   0);
 
-    m_reg_HL.value = result;
+    m_state.reg_HL.value = result;
 }
 
 void Z80::AND(byte data)
 {
-    m_reg_AF.hi = data & m_reg_AF.hi;
+    m_state.reg_AF.hi = data & m_state.reg_AF.hi;
 
-    WriteFlag(SIGN,            m_reg_AF.hi & 0x80);
-    WriteFlag(ZERO,            m_reg_AF.hi == 0);
+    WriteFlag(SIGN,            m_state.reg_AF.hi & 0x80);
+    WriteFlag(ZERO,            m_state.reg_AF.hi == 0);
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
     WriteFlag(CARRY,           0);
-    WriteFlag(PARITY_OVERFLOW, HasParity(m_reg_AF.hi));
+    WriteFlag(PARITY_OVERFLOW, HasParity(m_state.reg_AF.hi));
 }
 
 void Z80::AND_HL()
@@ -300,17 +379,17 @@ void Z80::BIT_HL(uint8_t bit)
 
 void Z80::CALL()
 {
-    const word address = m_program_counter;
+    const word address = m_state.program_counter;
     const byte lo      = m_memory->ReadMemory(address);
     const byte hi      = m_memory->ReadMemory(address + 1);
     
-    m_program_counter += 2;
+    m_state.program_counter += 2;
     
-    m_memory->WriteMemory(m_stack_pointer - 1, (m_program_counter & 0xFF00) >> 8);	
-    m_memory->WriteMemory(m_stack_pointer - 2, m_program_counter & 0X00FF);
-    m_stack_pointer -= 2;
+    m_memory->WriteMemory(m_state.stack_pointer - 1, (m_state.program_counter & 0xFF00) >> 8);	
+    m_memory->WriteMemory(m_state.stack_pointer - 2, m_state.program_counter & 0X00FF);
+    m_state.stack_pointer -= 2;
 
-    m_program_counter = lo + (hi << 8);
+    m_state.program_counter = lo + (hi << 8);
 }
 
 bool Z80::CALL(bool cond)
@@ -333,9 +412,9 @@ void Z80::CCF()
 */
 void Z80::CP(byte sub)
 {
-    const word result     = m_reg_AF.hi - sub;
-    const bool half_carry = (m_reg_AF.hi & 0x0F) + (sub & 0x0F) >= 0x10;
-    const bool overflow   = ((m_reg_AF.hi & 0x80) != (sub & 0x80)) && ((sub & 0x80) == (result & 0x80));
+    const word result     = m_state.reg_AF.hi - sub;
+    const bool half_carry = (m_state.reg_AF.hi & 0x0F) + (sub & 0x0F) >= 0x10;
+    const bool overflow   = ((m_state.reg_AF.hi & 0x80) != (sub & 0x80)) && ((sub & 0x80) == (result & 0x80));
 
     WriteFlag(ADD_SUBSTRACT,   1);
     WriteFlag(ZERO,			   result == 0);
@@ -352,37 +431,37 @@ void Z80::CP_HL()
 
 void Z80::CPD()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
     CP(value);
 
-    --m_reg_HL.value;
-    --m_reg_BC.value;
+    --m_state.reg_HL.value;
+    --m_state.reg_BC.value;
 }
 
 bool Z80::CPDR()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
     CP(value);
 
-    --m_reg_HL.value;
-    --m_reg_BC.value;
+    --m_state.reg_HL.value;
+    --m_state.reg_BC.value;
 
-    if (m_reg_BC.value - 1 == 0 || value != m_reg_AF.hi)
+    if (m_state.reg_BC.value - 1 == 0 || value != m_state.reg_AF.hi)
         return false;
 
-    m_program_counter -= 2;
+    m_state.program_counter -= 2;
     return true;
 }
 
 void Z80::CPI()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
 
-    ++m_reg_HL.value;
-    --m_reg_BC.value;
+    ++m_state.reg_HL.value;
+    --m_state.reg_BC.value;
     
-    WriteFlag(ZERO,            value == m_reg_AF.hi);
-    WriteFlag(PARITY_OVERFLOW, m_reg_BC.value - 1 != 0);
+    WriteFlag(ZERO,            value == m_state.reg_AF.hi);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_BC.value - 1 != 0);
     WriteFlag(SIGN,            value & 0x80);
     WriteFlag(HALF_CARRY,      value & (1 << 3));
     WriteFlag(ADD_SUBSTRACT,   0);
@@ -390,20 +469,20 @@ void Z80::CPI()
 
 bool Z80::CPIR()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
 
-    ++m_reg_HL.value;
-    --m_reg_BC.value;
+    ++m_state.reg_HL.value;
+    --m_state.reg_BC.value;
     
-    WriteFlag(ZERO,            value == m_reg_AF.hi);
-    WriteFlag(PARITY_OVERFLOW, m_reg_BC.value - 1 != 0);
+    WriteFlag(ZERO,            value == m_state.reg_AF.hi);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_BC.value - 1 != 0);
     WriteFlag(SIGN,            value & 0x80);
     WriteFlag(HALF_CARRY,      value & (1 << 3));
     WriteFlag(ADD_SUBSTRACT,   0);
 
-    if (m_reg_BC.value == 0 && value == m_reg_AF.hi)
+    if (m_state.reg_BC.value == 0 && value == m_state.reg_AF.hi)
     {
-        m_program_counter -= 2;
+        m_state.program_counter -= 2;
         return true;
     }
     return false;
@@ -411,7 +490,7 @@ bool Z80::CPIR()
 
 void Z80::CPL()
 {
-    m_reg_AF.hi = ~m_reg_AF.hi;
+    m_state.reg_AF.hi = ~m_state.reg_AF.hi;
 
     WriteFlag(ADD_SUBSTRACT, 0);
 }
@@ -422,7 +501,7 @@ void Z80::DAA()
     const bool carry_flag      = ReadFlag(CARRY);
     const bool half_carry_flag = ReadFlag(HALF_CARRY);
     
-    byte acc       = m_reg_AF.hi;
+    byte acc       = m_state.reg_AF.hi;
     bool new_carry = 0;
 
     if (!add_sub_flag) 
@@ -453,13 +532,13 @@ void Z80::DAA()
     WriteFlag(ZERO, acc == 0);
     WriteFlag(HALF_CARRY, 0);
     
-    m_reg_AF.hi = acc;
+    m_state.reg_AF.hi = acc;
 }
 
 void Z80::DI()
 {
-    m_IFF1 = false;
-    m_IFF2 = false;
+    m_state.IFF1 = false;
+    m_state.IFF2 = false;
 }
 
 void Z80::DEC(byte& reg)
@@ -490,25 +569,27 @@ void Z80::DEC_HL()
 
 bool Z80::DJNZ()
 {
-    --m_reg_BC.hi;
-    if (m_reg_BC.hi == 0)
+    --m_state.reg_BC.hi;
+    if (m_state.reg_BC.hi == 0)
     {
-        const byte dis = m_memory->ReadMemory(m_program_counter);
-        m_program_counter += dis;
+        const byte dis = m_memory->ReadMemory(m_state.program_counter);
+        m_state.program_counter += dis;
         return true;
     }
     else
     {
-        ++m_program_counter;
+        ++m_state.program_counter;
         return false;
     }
 }
 
 void Z80::EI()
 {
-    m_IFF1     = true;
-    m_IFF2     = true;
-    m_after_EI = true;
+    m_state.IFF1     = true;
+    m_state.IFF2     = true;
+    m_state.after_EI = true;
+
+    m_state.pending_events |= EVENT_EI_DELAY;
 }
 
 void Z80::EX(Register& reg, Register& shd)
@@ -520,7 +601,7 @@ void Z80::EX(Register& reg, Register& shd)
 
 void Z80::EX(Register& reg)
 {
-    word address    = m_stack_pointer;
+    word address    = m_state.stack_pointer;
     byte reg_lo     = reg.lo;
     byte reg_hi     = reg.hi;
 
@@ -537,53 +618,53 @@ void Z80::EX_SPHL()
     const byte lo  = reg.lo;
     const byte hi  = reg.hi;
     
-    reg.lo = m_memory->ReadMemory(m_stack_pointer);
-    reg.hi = m_memory->ReadMemory(m_stack_pointer + 1);
+    reg.lo = m_memory->ReadMemory(m_state.stack_pointer);
+    reg.hi = m_memory->ReadMemory(m_state.stack_pointer + 1);
 
-    m_memory->WriteMemory(m_stack_pointer, lo);
-    m_memory->WriteMemory(m_stack_pointer + 1, hi);
+    m_memory->WriteMemory(m_state.stack_pointer, lo);
+    m_memory->WriteMemory(m_state.stack_pointer + 1, hi);
 }
 
 void Z80::EXX()
 {
-    word tmp              = m_reg_BC.value;
-    m_reg_BC.value        = m_reg_BC_shadow.value;
-    m_reg_BC_shadow.value = tmp;
+    word tmp              = m_state.reg_BC.value;
+    m_state.reg_BC.value        = m_state.reg_BC_shadow.value;
+    m_state.reg_BC_shadow.value = tmp;
 
-    tmp                   = m_reg_DE.value;
-    m_reg_DE.value        = m_reg_DE_shadow.value;
-    m_reg_DE_shadow.value = tmp;
+    tmp                   = m_state.reg_DE.value;
+    m_state.reg_DE.value        = m_state.reg_DE_shadow.value;
+    m_state.reg_DE_shadow.value = tmp;
 
-    tmp                   = m_reg_HL.value;
-    m_reg_HL.value        = m_reg_HL_shadow.value;
-    m_reg_HL_shadow.value = tmp;
+    tmp                   = m_state.reg_HL.value;
+    m_state.reg_HL.value        = m_state.reg_HL_shadow.value;
+    m_state.reg_HL_shadow.value = tmp;
 }
 
 void Z80::HALT()
 {
-    m_halt = true;
+    m_state.halt = true;
 }
 
 void Z80::IM0()
 {
-    m_interrupt_mode = InterruptMode::MODE_0;
+    m_state.interrupt_mode = InterruptMode::MODE_0;
 }
 
 void Z80::IM1()
 {
-    m_interrupt_mode = InterruptMode::MODE_1;
+    m_state.interrupt_mode = InterruptMode::MODE_1;
 }
 
 void Z80::IM2()
 {
-    m_interrupt_mode = InterruptMode::MODE_2;
+    m_state.interrupt_mode = InterruptMode::MODE_2;
 }
 
 void Z80::IN_C(byte& in)
 {
     assert(m_context.io_device != nullptr);
     
-    const byte address = m_reg_BC.lo;
+    const byte address = m_state.reg_BC.lo;
     const byte data = m_context.io_device->Read(address);
     in = data;
 
@@ -597,11 +678,11 @@ void Z80::IN_C(byte& in)
 void Z80::IN_N(byte& in)
 {
     // IN A (n)
-    // param in must be the accumulator (m_reg_AF.hi)
-    assert(in == m_reg_AF.hi);
+    // param in must be the accumulator (m_state.reg_AF.hi)
+    assert(in == m_state.reg_AF.hi);
 
-    const byte address = m_memory->ReadMemory(m_program_counter);
-    ++m_program_counter;
+    const byte address = m_memory->ReadMemory(m_state.program_counter);
+    ++m_state.program_counter;
 
     const byte data = m_context.io_device->Read(address);
     in = data;
@@ -609,22 +690,22 @@ void Z80::IN_N(byte& in)
 
 void Z80::IND()
 {
-    const byte address = m_reg_BC.lo;
+    const byte address = m_state.reg_BC.lo;
     const byte data = m_context.io_device->Read(address);
 
-    m_memory->WriteMemory(m_reg_HL.value, data);
+    m_memory->WriteMemory(m_state.reg_HL.value, data);
 
-    DEC(m_reg_BC.hi);
-    DEC(m_reg_HL);
+    DEC(m_state.reg_BC.hi);
+    DEC(m_state.reg_HL);
 }
 
 bool Z80::INDR()
 {
     IND();
 
-    if (m_reg_BC.hi != 0)
+    if (m_state.reg_BC.hi != 0)
     {
-        m_program_counter -= 2;
+        m_state.program_counter -= 2;
 
         return true;
     }
@@ -660,22 +741,22 @@ void Z80::INC_HL()
 
 void Z80::INI()
 {
-    const byte address = m_reg_BC.lo;
+    const byte address = m_state.reg_BC.lo;
     const byte data = m_context.io_device->Read(address);
 
-    m_memory->WriteMemory(m_reg_HL.value, data);
+    m_memory->WriteMemory(m_state.reg_HL.value, data);
 
-    DEC(m_reg_BC.hi);
-    INC(m_reg_HL);
+    DEC(m_state.reg_BC.hi);
+    INC(m_state.reg_HL);
 }
 
 bool Z80::INIR()
 {
     INI();
 
-    if (m_reg_BC.hi = !0)
+    if (m_state.reg_BC.hi = !0)
     {
-        m_program_counter -= 2;
+        m_state.program_counter -= 2;
         return true;
     }
 
@@ -684,15 +765,15 @@ bool Z80::INIR()
 
 void Z80::JP()
 {
-    const word address = m_program_counter;
+    const word address = m_state.program_counter;
     const byte lo      = m_memory->ReadMemory(address);
     const byte hi      = m_memory->ReadMemory(address + 1);
-    m_program_counter  = lo + (hi << 8);
+    m_state.program_counter  = lo + (hi << 8);
 }
 
 void Z80::JP(word address)
 {
-    m_program_counter = address;
+    m_state.program_counter = address;
 }
 
 void Z80::JP(bool cond)
@@ -700,13 +781,13 @@ void Z80::JP(bool cond)
     if (cond)
         JP();
     else
-        m_program_counter += 2;
+        m_state.program_counter += 2;
 }
 
 void Z80::JR()
 {
-    const word value = m_program_counter;
-    m_program_counter = value + 1 + (m_memory->ReadMemory(value));
+    const word value = m_state.program_counter;
+    m_state.program_counter = value + 1 + (m_memory->ReadMemory(value));
 }
 
 bool Z80::JR(bool cond)
@@ -718,7 +799,7 @@ bool Z80::JR(bool cond)
     }
     else
     {
-        ++m_program_counter;
+        ++m_state.program_counter;
         return false;
     }
 }
@@ -779,94 +860,94 @@ void Z80::LD_NNDD(byte data)
 void Z80::LD_HL_N()
 {
     const word address = GetPrefixedHLAddress();
-    const byte n	   = m_memory->ReadMemory(m_program_counter + 1);
+    const byte n	   = m_memory->ReadMemory(m_state.program_counter + 1);
 
     m_memory->WriteMemory(address, n);
-    ++m_program_counter;
+    ++m_state.program_counter;
 }
 
 void Z80::LD_SP_HL()
 {
-    m_stack_pointer = GetPrefixedHL().value;
+    m_state.stack_pointer = GetPrefixedHL().value;
 }
 
 void Z80::LDD()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
-    m_memory->WriteMemory(m_reg_DE.value, value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
+    m_memory->WriteMemory(m_state.reg_DE.value, value);
 
-    --m_reg_HL.value;
-    --m_reg_DE.value;
-    --m_reg_BC.value;
+    --m_state.reg_HL.value;
+    --m_state.reg_DE.value;
+    --m_state.reg_BC.value;
 
-    WriteFlag(PARITY_OVERFLOW, m_reg_BC.value - 1 != 0);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_BC.value - 1 != 0);
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
 }
 
 bool Z80::LDDR()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
-    m_memory->WriteMemory(m_reg_DE.value, value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
+    m_memory->WriteMemory(m_state.reg_DE.value, value);
 
-    --m_reg_HL.value;
-    --m_reg_DE.value;
-    --m_reg_BC.value;
+    --m_state.reg_HL.value;
+    --m_state.reg_DE.value;
+    --m_state.reg_BC.value;
     
-    WriteFlag(PARITY_OVERFLOW, m_reg_BC.value - 1 != 0);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_BC.value - 1 != 0);
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
 
-    if (m_reg_BC.value == 0)
+    if (m_state.reg_BC.value == 0)
         return false;
 
-    m_program_counter -= 2;
+    m_state.program_counter -= 2;
     return true;
 }
 
 void Z80::LDI()
 {
-    const byte result = m_memory->ReadMemory(m_reg_HL.value);
-    m_memory->WriteMemory(m_reg_DE.value, result);
+    const byte result = m_memory->ReadMemory(m_state.reg_HL.value);
+    m_memory->WriteMemory(m_state.reg_DE.value, result);
     
-    ++m_reg_DE.value;
-    ++m_reg_HL.value;
-    --m_reg_BC.value;
+    ++m_state.reg_DE.value;
+    ++m_state.reg_HL.value;
+    --m_state.reg_BC.value;
 
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
-    WriteFlag(PARITY_OVERFLOW, m_reg_BC.value - 1 != 0);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_BC.value - 1 != 0);
 }
 
 bool Z80::LDIR()
 {
-    const byte result = m_memory->ReadMemory(m_reg_HL.value);
-    m_memory->WriteMemory(m_reg_DE.value, result);
+    const byte result = m_memory->ReadMemory(m_state.reg_HL.value);
+    m_memory->WriteMemory(m_state.reg_DE.value, result);
 
-    ++m_reg_DE.value;
-    ++m_reg_HL.value;
-    --m_reg_BC.value;
+    ++m_state.reg_DE.value;
+    ++m_state.reg_HL.value;
+    --m_state.reg_BC.value;
 
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
-    WriteFlag(PARITY_OVERFLOW, m_reg_BC.value - 1 != 0);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_BC.value - 1 != 0);
     
-    if (m_reg_BC.value == 0)
+    if (m_state.reg_BC.value == 0)
         return false;
 
-    m_program_counter -= 2;
+    m_state.program_counter -= 2;
     return true;
 }
 
 void Z80::LD_AR()
 {
     // LD A,R
-    const byte value = m_reg_refresh;
-    LD(m_reg_AF.hi, value);
+    const byte value = m_state.reg_refresh;
+    LD(m_state.reg_AF.hi, value);
 
     WriteFlag(SIGN,            value & 0x80);
     WriteFlag(ZERO,            value == 0);
-    WriteFlag(PARITY_OVERFLOW, m_IFF2);
+    WriteFlag(PARITY_OVERFLOW, m_state.IFF2);
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
 }
@@ -874,28 +955,28 @@ void Z80::LD_AR()
 void Z80::LD_AI()
 {
      // LD A,I
-    const byte value = m_reg_interrupt;
-    LD(m_reg_AF.hi, value);
+    const byte value = m_state.reg_interrupt;
+    LD(m_state.reg_AF.hi, value);
 
     WriteFlag(SIGN, value & 0x80);
     WriteFlag(ZERO, value == 0);
     WriteFlag(HALF_CARRY, 0);
     WriteFlag(ADD_SUBSTRACT, 0);
-    WriteFlag(PARITY_OVERFLOW, m_IFF2);
+    WriteFlag(PARITY_OVERFLOW, m_state.IFF2);
 }
 
 void Z80::NEG()
 { 
-    const byte result = 0 - m_reg_AF.hi;
+    const byte result = 0 - m_state.reg_AF.hi;
     
     WriteFlag(SIGN,            result & 0x80);
     WriteFlag(ZERO,            result == 0);
     WriteFlag(HALF_CARRY,      result & (1<<3));
-    WriteFlag(PARITY_OVERFLOW, m_reg_AF.hi == 0x80);
+    WriteFlag(PARITY_OVERFLOW, m_state.reg_AF.hi == 0x80);
     WriteFlag(ADD_SUBSTRACT,   1);
-    WriteFlag(CARRY,		   m_reg_AF.hi != 0);
+    WriteFlag(CARRY,		   m_state.reg_AF.hi != 0);
 
-    m_reg_AF.hi = result;
+    m_state.reg_AF.hi = result;
 }
 
 void Z80::NOP()
@@ -905,14 +986,14 @@ void Z80::NOP()
 
 void Z80::OR(byte data)
 {
-    m_reg_AF.hi = data | m_reg_AF.hi;
+    m_state.reg_AF.hi = data | m_state.reg_AF.hi;
 
-    WriteFlag(SIGN,            m_reg_AF.hi & 0x80);
-    WriteFlag(ZERO,            m_reg_AF.hi == 0);
+    WriteFlag(SIGN,            m_state.reg_AF.hi & 0x80);
+    WriteFlag(ZERO,            m_state.reg_AF.hi == 0);
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
     WriteFlag(CARRY,           0);
-    WriteFlag(PARITY_OVERFLOW, HasParity(m_reg_AF.hi));
+    WriteFlag(PARITY_OVERFLOW, HasParity(m_state.reg_AF.hi));
 }
 
 void Z80::OR_HL()
@@ -922,50 +1003,50 @@ void Z80::OR_HL()
 
 void Z80::OUT_C(byte& out)
 {
-    const byte address = m_reg_BC.lo;
+    const byte address = m_state.reg_BC.lo;
     m_context.io_device->Write(address, out);
 }
 
 void Z80::OUT_N(byte& out)
 {
     // OUT (n) A
-    assert(out == m_reg_AF.hi);
+    assert(out == m_state.reg_AF.hi);
 
-    const byte address = m_memory->ReadMemory(m_program_counter);
-    ++m_program_counter; 
+    const byte address = m_memory->ReadMemory(m_state.program_counter);
+    ++m_state.program_counter; 
 
     m_context.io_device->Write(address, out);
 }
 
 void Z80::OUTD()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
-    const byte address = m_reg_BC.lo;
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
+    const byte address = m_state.reg_BC.lo;
     m_context.io_device->Write(address, value);
 
-    DEC(m_reg_BC.hi);
-    DEC(m_reg_HL);
+    DEC(m_state.reg_BC.hi);
+    DEC(m_state.reg_HL);
 }
 
 void Z80::OUTI()
 {
-    const byte value = m_memory->ReadMemory(m_reg_HL.value);
+    const byte value = m_memory->ReadMemory(m_state.reg_HL.value);
 
-    DEC(m_reg_BC.hi);
+    DEC(m_state.reg_BC.hi);
 
-    const byte address = m_reg_BC.lo;
+    const byte address = m_state.reg_BC.lo;
     m_context.io_device->Write(address, value);
 
-    INC(m_reg_HL);
+    INC(m_state.reg_HL);
 }
 
 bool Z80::OTDR()
 {
     OUTD();
     
-    if (m_reg_BC.hi != 0)
+    if (m_state.reg_BC.hi != 0)
     {
-        m_program_counter -= 2;
+        m_state.program_counter -= 2;
         return true;
     }
 
@@ -979,9 +1060,9 @@ bool Z80::OTIR()
 {
     OUTI();
 
-    if (m_reg_BC.hi != 0)
+    if (m_state.reg_BC.hi != 0)
     {
-        m_program_counter -= 2;
+        m_state.program_counter -= 2;
         return true;
     }
 
@@ -993,18 +1074,18 @@ bool Z80::OTIR()
 
 void Z80::POP(Register& reg)
 {
-    byte lo = m_memory->ReadMemory(m_stack_pointer);
-    byte hi = m_memory->ReadMemory(m_stack_pointer + 1);
-    m_stack_pointer += 2;
+    byte lo = m_memory->ReadMemory(m_state.stack_pointer);
+    byte hi = m_memory->ReadMemory(m_state.stack_pointer + 1);
+    m_state.stack_pointer += 2;
     reg.value = lo + (hi << 8);
 }
 
 void Z80::PUSH(const Register reg)
 {
-    const word address = m_stack_pointer;
+    const word address = m_state.stack_pointer;
     m_memory->WriteMemory(address - 1, reg.hi);
     m_memory->WriteMemory(address - 2, reg.lo);
-    m_stack_pointer -= 2;
+    m_state.stack_pointer -= 2;
 }
 
 void Z80::RES(uint8_t bit, byte& reg)
@@ -1021,10 +1102,10 @@ void Z80::RES_HL(uint8_t bit)
 
 void Z80::RET()
 {
-    byte lo = m_memory->ReadMemory(m_stack_pointer);
-    byte hi = m_memory->ReadMemory(m_stack_pointer + 1);
-    m_stack_pointer += 2;
-    m_program_counter = lo + (hi << 8);
+    byte lo = m_memory->ReadMemory(m_state.stack_pointer);
+    byte hi = m_memory->ReadMemory(m_state.stack_pointer + 1);
+    m_state.stack_pointer += 2;
+    m_state.program_counter = lo + (hi << 8);
 }
 
 bool Z80::RET(bool cond)
@@ -1036,7 +1117,7 @@ bool Z80::RET(bool cond)
     }
     else
     {
-        ++m_program_counter;
+        ++m_state.program_counter;
         return false;
     }
 }
@@ -1044,13 +1125,13 @@ bool Z80::RET(bool cond)
 void Z80::RETI()
 {
     RET();
-    m_IFF1 = m_IFF2;
+    m_state.IFF1 = m_state.IFF2;
 }
 
 void Z80::RETN()
 {
     RET();
-    m_IFF1 = m_IFF2;
+    m_state.IFF1 = m_state.IFF2;
 }
 
 void Z80::RL(byte& reg)
@@ -1085,8 +1166,8 @@ void Z80::RL_HL()
 
 void Z80::RLA()
 {
-    const bool carry = (m_reg_AF.hi & (1 << 7));
-    m_reg_AF.hi      = (m_reg_AF.hi << 1) + ReadFlag(CARRY);
+    const bool carry = (m_state.reg_AF.hi & (1 << 7));
+    m_state.reg_AF.hi      = (m_state.reg_AF.hi << 1) + ReadFlag(CARRY);
 
     WriteFlag(CARRY,         carry);
     WriteFlag(HALF_CARRY,    0);
@@ -1125,8 +1206,8 @@ void Z80::RLC_HL()
 
 void Z80::RLCA()
 {
-    const bool carry = m_reg_AF.hi & 0x80;
-    m_reg_AF.hi      = (m_reg_AF.hi << 1) + carry;
+    const bool carry = m_state.reg_AF.hi & 0x80;
+    m_state.reg_AF.hi      = (m_state.reg_AF.hi << 1) + carry;
 
     WriteFlag(CARRY,         carry);
     WriteFlag(HALF_CARRY,    0);
@@ -1135,12 +1216,12 @@ void Z80::RLCA()
 
 void Z80::RLD()
 {
-    const word address = m_reg_HL.value;
+    const word address = m_state.reg_HL.value;
     const byte value   = m_memory->ReadMemory(address);
-    const byte result  = (m_reg_AF.hi & 0xF0) | ((value >> 4) & 0x0F);
+    const byte result  = (m_state.reg_AF.hi & 0xF0) | ((value >> 4) & 0x0F);
 
-    m_memory->WriteMemory(address, ((value << 4) & 0xF0) | (m_reg_AF.hi & 0x0F));
-    m_reg_AF.hi = result;
+    m_memory->WriteMemory(address, ((value << 4) & 0xF0) | (m_state.reg_AF.hi & 0x0F));
+    m_state.reg_AF.hi = result;
 
     WriteFlag(SIGN,            result & 0x80);
     WriteFlag(ZERO,            result == 0);
@@ -1181,8 +1262,8 @@ void Z80::RR_HL()
 
 void Z80::RRA()
 {
-    const bool carry = m_reg_AF.hi & 1;
-    m_reg_AF.hi      = (m_reg_AF.hi >> 1) + (ReadFlag(CARRY) << 7);
+    const bool carry = m_state.reg_AF.hi & 1;
+    m_state.reg_AF.hi      = (m_state.reg_AF.hi >> 1) + (ReadFlag(CARRY) << 7);
 
     WriteFlag(CARRY,         carry);
     WriteFlag(HALF_CARRY,    0);
@@ -1221,8 +1302,8 @@ void Z80::RRC_HL()
 
 void Z80::RRCA()
 {
-    const bool carry = m_reg_AF.hi & 1;
-    m_reg_AF.hi      = (m_reg_AF.hi >> 1) + (carry << 7);
+    const bool carry = m_state.reg_AF.hi & 1;
+    m_state.reg_AF.hi      = (m_state.reg_AF.hi >> 1) + (carry << 7);
 
     WriteFlag(CARRY,         carry);
     WriteFlag(HALF_CARRY,    0);
@@ -1231,12 +1312,12 @@ void Z80::RRCA()
 
 void Z80::RRD()
 {
-    const word address = m_reg_HL.value;
+    const word address = m_state.reg_HL.value;
     const byte value   = m_memory->ReadMemory(address);
-    const byte result  = (m_reg_AF.hi & 0XF0) | (value & 0x0F);
+    const byte result  = (m_state.reg_AF.hi & 0XF0) | (value & 0x0F);
     
-    m_memory->WriteMemory(address, ((m_reg_AF.hi << 4) & 0xF0) | ((value >> 4) & 0x0F));
-    m_reg_AF.hi = result;
+    m_memory->WriteMemory(address, ((m_state.reg_AF.hi << 4) & 0xF0) | ((value >> 4) & 0x0F));
+    m_state.reg_AF.hi = result;
 
     WriteFlag(SIGN,            result & 0x80);
     WriteFlag(ZERO,            result == 0);
@@ -1247,11 +1328,11 @@ void Z80::RRD()
 
 void Z80::RST(byte data)
 {
-    const word address = m_stack_pointer;
-    m_memory->WriteMemory(address, m_program_counter & 0x00FF);
-    m_memory->WriteMemory(address - 1, m_program_counter >> 8);
-    m_stack_pointer -= 2;
-    m_program_counter = data;
+    const word address = m_state.stack_pointer;
+    m_memory->WriteMemory(address, m_state.program_counter & 0x00FF);
+    m_memory->WriteMemory(address - 1, m_state.program_counter >> 8);
+    m_state.stack_pointer -= 2;
+    m_state.program_counter = data;
 }
 
 void Z80::SBC(byte& acc, byte sub)
@@ -1273,12 +1354,12 @@ void Z80::SBC_HL(byte& acc)
 
 void Z80::SBC_HL(word num)
 {
-    const uint32_t result     = m_reg_HL.value - num - ReadFlag(CARRY);
+    const uint32_t result     = m_state.reg_HL.value - num - ReadFlag(CARRY);
     const bool     zero       = (result & 0xFFFF) == 0;
     const bool     carry      = (result > 0xFFFF);
-    const bool     half_carry = ((m_reg_HL.value & 0x0FFF) + (num & 0x0FFF) >= 0x0FFF);
+    const bool     half_carry = ((m_state.reg_HL.value & 0x0FFF) + (num & 0x0FFF) >= 0x0FFF);
     const bool     sign       = (result & (0x80)) != 0;
-    const bool     overflow   = ((m_reg_HL.value & 0x80) != (num & 0x80)) && ((num & 0x80) == (result & 0x80));
+    const bool     overflow   = ((m_state.reg_HL.value & 0x80) != (num & 0x80)) && ((num & 0x80) == (result & 0x80));
 
     WriteFlag(ZERO,            zero);
     WriteFlag(CARRY,           carry);
@@ -1287,7 +1368,7 @@ void Z80::SBC_HL(word num)
     WriteFlag(PARITY_OVERFLOW, overflow);
     WriteFlag(ADD_SUBSTRACT,   1);
 
-    m_reg_HL.value = result;
+    m_state.reg_HL.value = result;
 }
 
 void Z80::SCF()
@@ -1451,14 +1532,14 @@ void Z80::SUB_HL(byte& acc)
 
 void Z80::XOR(byte data)
 {
-    m_reg_AF.hi = data ^ m_reg_AF.hi;
+    m_state.reg_AF.hi = data ^ m_state.reg_AF.hi;
 
-    WriteFlag(SIGN,            m_reg_AF.hi & 0x80);
-    WriteFlag(ZERO,            m_reg_AF.hi == 0);
+    WriteFlag(SIGN,            m_state.reg_AF.hi & 0x80);
+    WriteFlag(ZERO,            m_state.reg_AF.hi == 0);
     WriteFlag(HALF_CARRY,      0);
     WriteFlag(ADD_SUBSTRACT,   0);
     WriteFlag(CARRY,           0);
-    WriteFlag(PARITY_OVERFLOW, HasParity(m_reg_AF.hi));
+    WriteFlag(PARITY_OVERFLOW, HasParity(m_state.reg_AF.hi));
 }
 
 void Z80::XOR_HL()
@@ -1489,5 +1570,5 @@ void Z80::FD()
 
 void Z80::UNUSED()
 {
-    assert(false && "This opcode is not meant to be used");
+    Z80_TRACE_ASSERT(*this, false && "This opcode is not meant to be used");
 }
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Types.h"
+#include "Debug/Z80Trace.h"
 
 class Memory;
 class GameRom;
 union Register
 {
+    Register() = default;
     Register(word v) : value(v) {}
 
     word value;
@@ -37,6 +39,49 @@ struct Z80Context
     IODevice* io_device = nullptr;
 };
 
+enum class Z80InterruptMode : uint8_t
+{
+    MODE_0 = 0,
+    MODE_1,
+    MODE_2
+};
+
+/*
+    Everything the CPU needs to resume execution. It lives in the MachineState arena,
+    the Z80 only keeps a reference to it.
+*/
+struct Z80State
+{
+    Register         reg_AF; // A - Accumulator. F - Flags
+    Register         reg_BC;
+    Register         reg_DE;
+    Register         reg_HL; // Address registers.
+    // Shadow registers aren't modified. They should be swapped with the normal ones.
+    Register         reg_AF_shadow;
+    Register         reg_BC_shadow;
+    Register         reg_DE_shadow;
+    Register         reg_HL_shadow;
+    // HL Prefixes: 
+    Register         reg_IX;
+    Register         reg_IY;
+
+    word             program_counter; // points to next opcode
+    word             stack_pointer; // next address to store variable in stack.
+    byte             reg_refresh; // increments with each opcode.
+    byte             reg_interrupt; //
+
+    byte             current_prefix;
+    bool             halt;
+    bool             IFF1;
+    bool             IFF2;
+    bool             after_EI;
+    Z80InterruptMode interrupt_mode;
+
+    uint32_t         pending_events; // Z80::PendingEvent bits.
+    uint32_t         cycle_count; // cycles that needs the opcode.
+    uint64_t         total_cycles; // cycles executed since reset.
+};
+
 class Z80;
 using OPCodeFunc = uint8_t(*)(Z80&);
 using TestCodeFunc = bool(*)(Z80&);
@@ -47,19 +92,29 @@ using TestCodeFunc = bool(*)(Z80&);
 class Z80
 {
 public:
-    enum class InterruptMode : uint8_t
+    using InterruptMode = Z80InterruptMode;
+
+    // Every asynchronous source is folded into a single word so the
+    // instruction loop only needs one test to know if something is pending.
+    enum PendingEvent : uint32_t
     {
-        MODE_0 = 0,
-        MODE_1,
-        MODE_2
+        EVENT_NONE      = 0,
+        EVENT_IRQ_FRAME = 1 << 0, // VDP frame interrupt line.
+        EVENT_IRQ_LINE  = 1 << 1, // VDP line interrupt line.
+        EVENT_NMI       = 1 << 2, // Pause button (edge triggered).
+        EVENT_EI_DELAY  = 1 << 3, // Interrupts are not accepted right after EI.
+
+        EVENT_IRQ_MASK  = EVENT_IRQ_FRAME | EVENT_IRQ_LINE
     };
 
 public:
-    Z80();
-    ~Z80();
+    Z80(Z80State& state, Memory* memory);
 
 public: // inline
     inline void SetContext(const Z80Context& context) { m_context = context; }
+    inline void SetInterruptLine(PendingEvent source, bool active) { m_state.pending_events = active ? (m_state.pending_events | source) : (m_state.pending_events & ~source); }
+    inline void RequestNMI() { m_state.pending_events |= EVENT_NMI; }
+    inline uint32_t GetPendingEvents() const { return m_state.pending_events; }
 
 public:
     void        Reset();
@@ -76,9 +131,19 @@ public:
 public:
     //  For testing purposes
     Memory* GetMemory() const { return m_memory; }
+    uint64_t GetTotalCycles() const { return m_state.total_cycles; }
+
+#if SMS_ENABLE_TRACE
+    const Z80Trace& GetTrace() const { return m_trace; }
+#endif
 
 private:
     uint32_t    ProcessOPCode(byte opcode, OPCodeFunc[256]);
+    bool        ProcessPendingEvents();
+#if SMS_ENABLE_TRACE
+    void        RecordTrace();
+#endif
+    void        AcceptInterrupt(word address);
     void        IncrementRefresh();
     void        WriteFlag(FLAG flag, bool value);
 
@@ -86,41 +151,18 @@ private:
     static bool HasParity(const byte data);
 
 public:
-    Register      m_reg_AF; // A - Accumulator. F - Flags
-    Register      m_reg_BC;
-    Register      m_reg_DE;
-    Register      m_reg_HL; // Address registers.
-    // Shadow registers aren't modified. They should be swapped with the normal ones.
-    Register      m_reg_AF_shadow;
-    Register      m_reg_BC_shadow;
-    Register      m_reg_DE_shadow;
-    Register      m_reg_HL_shadow;
-    // HL Prefixes: 
-    Register      m_reg_IX;
-    Register      m_reg_IY;
-
-    word          m_program_counter; // points to next opcode
-    word          m_stack_pointer; // next address to store variable in stack.
-    byte          m_reg_refresh; // increments with each opcode.
-    byte          m_reg_interrupt; //
+    Z80State&     m_state; // Registers are public, the generated instruction tables use them directly.
 
 private:
-    uint32_t      m_cycle_count; // cycles that needs the opcode.
-
     Memory*       m_memory;
 
-    byte          m_current_prefix;
-    bool          m_halt;
-
-    bool          m_IFF1;
-    bool          m_IFF2;
-    bool          m_after_EI;
-
-    InterruptMode m_interrupt_mode;
-
 private:
     Z80Context    m_context;
 
+#if SMS_ENABLE_TRACE
+    Z80Trace      m_trace;
+#endif
+
 // opcodes declaration.
 public:
     void ADD(byte& acc, byte add);
@@ -12,25 +12,25 @@ namespace Z80Instructions
 {
 	inline uint8_t opcodesCB0x00(Z80& cpu)
 	{
-		cpu.RLC(cpu.m_reg_BC.hi);
+		cpu.RLC(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x01(Z80& cpu)
 	{
-		cpu.RLC(cpu.m_reg_BC.lo);
+		cpu.RLC(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x02(Z80& cpu)
 	{
-		cpu.RLC(cpu.m_reg_DE.hi);
+		cpu.RLC(cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x03(Z80& cpu)
 	{
-		cpu.RLC(cpu.m_reg_DE.lo);
+		cpu.RLC(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -54,31 +54,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x07(Z80& cpu)
 	{
-		cpu.RLC(cpu.m_reg_AF.hi);
+		cpu.RLC(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x08(Z80& cpu)
 	{
-		cpu.RRC(cpu.m_reg_BC.hi);
+		cpu.RRC(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x09(Z80& cpu)
 	{
-		cpu.RRC(cpu.m_reg_BC.lo);
+		cpu.RRC(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x0a(Z80& cpu)
 	{
-		cpu.RRC(cpu.m_reg_DE.hi);
+		cpu.RRC(cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x0b(Z80& cpu)
 	{
-		cpu.RRC(cpu.m_reg_DE.lo);
+		cpu.RRC(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -102,31 +102,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x0f(Z80& cpu)
 	{
-		cpu.RRC(cpu.m_reg_AF.hi);
+		cpu.RRC(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x10(Z80& cpu)
 	{
-		cpu.RL(cpu.m_reg_BC.hi);
+		cpu.RL(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x11(Z80& cpu)
 	{
-		cpu.RL(cpu.m_reg_BC.lo);
+		cpu.RL(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x12(Z80& cpu)
 	{
-		cpu.RL(cpu.m_reg_BC.hi);
+		cpu.RL(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x13(Z80& cpu)
 	{
-		cpu.RL(cpu.m_reg_DE.lo);
+		cpu.RL(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -150,31 +150,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x17(Z80& cpu)
 	{
-		cpu.RL(cpu.m_reg_AF.hi);
+		cpu.RL(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x18(Z80& cpu)
 	{
-		cpu.RR(cpu.m_reg_BC.hi);
+		cpu.RR(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x19(Z80& cpu)
 	{
-		cpu.RR(cpu.m_reg_BC.lo);
+		cpu.RR(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x1a(Z80& cpu)
 	{
-		cpu.RR(cpu.m_reg_DE.hi);
+		cpu.RR(cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x1b(Z80& cpu)
 	{
-		cpu.RR(cpu.m_reg_DE.lo);
+		cpu.RR(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -198,31 +198,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x1f(Z80& cpu)
 	{
-		cpu.RR(cpu.m_reg_AF.hi);
+		cpu.RR(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x20(Z80& cpu)
 	{
-		cpu.SLA(cpu.m_reg_BC.hi);
+		cpu.SLA(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x21(Z80& cpu)
 	{
-		cpu.SLA(cpu.m_reg_BC.lo);
+		cpu.SLA(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x22(Z80& cpu)
 	{
-		cpu.SLA(cpu.m_reg_DE.hi);
+		cpu.SLA(cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x23(Z80& cpu)
 	{
-		cpu.SLA(cpu.m_reg_DE.lo);
+		cpu.SLA(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -246,31 +246,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x27(Z80& cpu)
 	{
-		cpu.SLA(cpu.m_reg_AF.hi);
+		cpu.SLA(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x28(Z80& cpu)
 	{
-		cpu.SRA(cpu.m_reg_BC.hi);
+		cpu.SRA(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x29(Z80& cpu)
 	{
-		cpu.SRA(cpu.m_reg_BC.lo);
+		cpu.SRA(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x2a(Z80& cpu)
 	{
-		cpu.SRA(cpu.m_reg_DE.hi);
+		cpu.SRA(cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x2b(Z80& cpu)
 	{
-		cpu.SRA(cpu.m_reg_DE.lo);
+		cpu.SRA(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -294,31 +294,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x2f(Z80& cpu)
 	{
-		cpu.SRA(cpu.m_reg_AF.hi);
+		cpu.SRA(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x38(Z80& cpu)
 	{
-		cpu.SRL(cpu.m_reg_BC.hi);
+		cpu.SRL(cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x39(Z80& cpu)
 	{
-		cpu.SRL(cpu.m_reg_BC.lo);
+		cpu.SRL(cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x3a(Z80& cpu)
 	{
-		cpu.SRL(cpu.m_reg_DE.hi);
+		cpu.SRL(cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x3b(Z80& cpu)
 	{
-		cpu.SRL(cpu.m_reg_DE.lo);
+		cpu.SRL(cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -342,31 +342,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x3f(Z80& cpu)
 	{
-		cpu.SRL(cpu.m_reg_AF.hi);
+		cpu.SRL(cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x40(Z80& cpu)
 	{
-		cpu.BIT(0, cpu.m_reg_BC.hi);
+		cpu.BIT(0, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x41(Z80& cpu)
 	{
-		cpu.BIT(0, cpu.m_reg_BC.lo);
+		cpu.BIT(0, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x42(Z80& cpu)
 	{
-		cpu.BIT(0, cpu.m_reg_DE.hi);
+		cpu.BIT(0, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x43(Z80& cpu)
 	{
-		cpu.BIT(0, cpu.m_reg_DE.lo);
+		cpu.BIT(0, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -390,31 +390,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x47(Z80& cpu)
 	{
-		cpu.BIT(0, cpu.m_reg_AF.hi);
+		cpu.BIT(0, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x48(Z80& cpu)
 	{
-		cpu.BIT(1, cpu.m_reg_BC.hi);
+		cpu.BIT(1, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x49(Z80& cpu)
 	{
-		cpu.BIT(1, cpu.m_reg_BC.lo);
+		cpu.BIT(1, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x4a(Z80& cpu)
 	{
-		cpu.BIT(1, cpu.m_reg_DE.hi);
+		cpu.BIT(1, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x4b(Z80& cpu)
 	{
-		cpu.BIT(1, cpu.m_reg_DE.lo);
+		cpu.BIT(1, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -438,31 +438,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x4f(Z80& cpu)
 	{
-		cpu.BIT(1, cpu.m_reg_AF.hi);
+		cpu.BIT(1, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x50(Z80& cpu)
 	{
-		cpu.BIT(2, cpu.m_reg_BC.hi);
+		cpu.BIT(2, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x51(Z80& cpu)
 	{
-		cpu.BIT(2, cpu.m_reg_BC.lo);
+		cpu.BIT(2, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x52(Z80& cpu)
 	{
-		cpu.BIT(2, cpu.m_reg_DE.hi);
+		cpu.BIT(2, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x53(Z80& cpu)
 	{
-		cpu.BIT(2, cpu.m_reg_DE.lo);
+		cpu.BIT(2, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -486,31 +486,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x57(Z80& cpu)
 	{
-		cpu.BIT(2, cpu.m_reg_AF.hi);
+		cpu.BIT(2, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x58(Z80& cpu)
 	{
-		cpu.BIT(3, cpu.m_reg_BC.hi);
+		cpu.BIT(3, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x59(Z80& cpu)
 	{
-		cpu.BIT(3, cpu.m_reg_BC.lo);
+		cpu.BIT(3, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x5a(Z80& cpu)
 	{
-		cpu.BIT(3, cpu.m_reg_DE.hi);
+		cpu.BIT(3, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x5b(Z80& cpu)
 	{
-		cpu.BIT(3, cpu.m_reg_DE.lo);
+		cpu.BIT(3, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -534,31 +534,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x5f(Z80& cpu)
 	{
-		cpu.BIT(3, cpu.m_reg_AF.hi);
+		cpu.BIT(3, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x60(Z80& cpu)
 	{
-		cpu.BIT(4, cpu.m_reg_BC.hi);
+		cpu.BIT(4, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x61(Z80& cpu)
 	{
-		cpu.BIT(4, cpu.m_reg_BC.lo);
+		cpu.BIT(4, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x62(Z80& cpu)
 	{
-		cpu.BIT(4, cpu.m_reg_DE.hi);
+		cpu.BIT(4, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x63(Z80& cpu)
 	{
-		cpu.BIT(4, cpu.m_reg_DE.lo);
+		cpu.BIT(4, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -582,31 +582,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x67(Z80& cpu)
 	{
-		cpu.BIT(4, cpu.m_reg_AF.hi);
+		cpu.BIT(4, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x68(Z80& cpu)
 	{
-		cpu.BIT(5, cpu.m_reg_BC.hi);
+		cpu.BIT(5, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x69(Z80& cpu)
 	{
-		cpu.BIT(5, cpu.m_reg_BC.lo);
+		cpu.BIT(5, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x6a(Z80& cpu)
 	{
-		cpu.BIT(5, cpu.m_reg_DE.hi);
+		cpu.BIT(5, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x6b(Z80& cpu)
 	{
-		cpu.BIT(5, cpu.m_reg_DE.lo);
+		cpu.BIT(5, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -630,31 +630,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x6f(Z80& cpu)
 	{
-		cpu.BIT(5, cpu.m_reg_AF.hi);
+		cpu.BIT(5, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x70(Z80& cpu)
 	{
-		cpu.BIT(6, cpu.m_reg_BC.hi);
+		cpu.BIT(6, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x71(Z80& cpu)
 	{
-		cpu.BIT(6, cpu.m_reg_BC.lo);
+		cpu.BIT(6, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x72(Z80& cpu)
 	{
-		cpu.BIT(6, cpu.m_reg_DE.hi);
+		cpu.BIT(6, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x73(Z80& cpu)
 	{
-		cpu.BIT(6, cpu.m_reg_DE.lo);
+		cpu.BIT(6, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -678,31 +678,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x77(Z80& cpu)
 	{
-		cpu.BIT(6, cpu.m_reg_AF.hi);
+		cpu.BIT(6, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x78(Z80& cpu)
 	{
-		cpu.BIT(7, cpu.m_reg_BC.hi);
+		cpu.BIT(7, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x79(Z80& cpu)
 	{
-		cpu.BIT(7, cpu.m_reg_BC.lo);
+		cpu.BIT(7, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x7a(Z80& cpu)
 	{
-		cpu.BIT(7, cpu.m_reg_DE.hi);
+		cpu.BIT(7, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x7b(Z80& cpu)
 	{
-		cpu.BIT(7, cpu.m_reg_DE.lo);
+		cpu.BIT(7, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -726,31 +726,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x7f(Z80& cpu)
 	{
-		cpu.BIT(7, cpu.m_reg_AF.hi);
+		cpu.BIT(7, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x80(Z80& cpu)
 	{
-		cpu.RES(0, cpu.m_reg_BC.hi);
+		cpu.RES(0, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x81(Z80& cpu)
 	{
-		cpu.RES(0, cpu.m_reg_BC.lo);
+		cpu.RES(0, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x82(Z80& cpu)
 	{
-		cpu.RES(0, cpu.m_reg_DE.hi);
+		cpu.RES(0, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x83(Z80& cpu)
 	{
-		cpu.RES(0, cpu.m_reg_DE.lo);
+		cpu.RES(0, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -774,31 +774,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x87(Z80& cpu)
 	{
-		cpu.RES(0, cpu.m_reg_AF.hi);
+		cpu.RES(0, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x88(Z80& cpu)
 	{
-		cpu.RES(1, cpu.m_reg_BC.hi);
+		cpu.RES(1, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x89(Z80& cpu)
 	{
-		cpu.RES(1, cpu.m_reg_BC.lo);
+		cpu.RES(1, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x8a(Z80& cpu)
 	{
-		cpu.RES(1, cpu.m_reg_DE.hi);
+		cpu.RES(1, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x8b(Z80& cpu)
 	{
-		cpu.RES(1, cpu.m_reg_DE.lo);
+		cpu.RES(1, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -822,31 +822,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x8f(Z80& cpu)
 	{
-		cpu.RES(1, cpu.m_reg_AF.hi);
+		cpu.RES(1, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x90(Z80& cpu)
 	{
-		cpu.RES(2, cpu.m_reg_BC.hi);
+		cpu.RES(2, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x91(Z80& cpu)
 	{
-		cpu.RES(2, cpu.m_reg_BC.lo);
+		cpu.RES(2, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x92(Z80& cpu)
 	{
-		cpu.RES(2, cpu.m_reg_DE.hi);
+		cpu.RES(2, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x93(Z80& cpu)
 	{
-		cpu.RES(2, cpu.m_reg_DE.lo);
+		cpu.RES(2, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -870,31 +870,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x97(Z80& cpu)
 	{
-		cpu.RES(2, cpu.m_reg_AF.hi);
+		cpu.RES(2, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x98(Z80& cpu)
 	{
-		cpu.RES(3, cpu.m_reg_BC.hi);
+		cpu.RES(3, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x99(Z80& cpu)
 	{
-		cpu.RES(3, cpu.m_reg_BC.lo);
+		cpu.RES(3, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x9a(Z80& cpu)
 	{
-		cpu.RES(3, cpu.m_reg_DE.hi);
+		cpu.RES(3, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0x9b(Z80& cpu)
 	{
-		cpu.RES(3, cpu.m_reg_DE.lo);
+		cpu.RES(3, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -918,31 +918,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0x9f(Z80& cpu)
 	{
-		cpu.RES(3, cpu.m_reg_AF.hi);
+		cpu.RES(3, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xa0(Z80& cpu)
 	{
-		cpu.RES(4, cpu.m_reg_BC.hi);
+		cpu.RES(4, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xa1(Z80& cpu)
 	{
-		cpu.RES(4, cpu.m_reg_BC.lo);
+		cpu.RES(4, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xa2(Z80& cpu)
 	{
-		cpu.RES(4, cpu.m_reg_DE.hi);
+		cpu.RES(4, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xa3(Z80& cpu)
 	{
-		cpu.RES(4, cpu.m_reg_DE.lo);
+		cpu.RES(4, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -966,31 +966,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xa7(Z80& cpu)
 	{
-		cpu.RES(4, cpu.m_reg_AF.hi);
+		cpu.RES(4, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xa8(Z80& cpu)
 	{
-		cpu.RES(5, cpu.m_reg_BC.hi);
+		cpu.RES(5, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xa9(Z80& cpu)
 	{
-		cpu.RES(5, cpu.m_reg_BC.lo);
+		cpu.RES(5, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xaa(Z80& cpu)
 	{
-		cpu.RES(5, cpu.m_reg_DE.hi);
+		cpu.RES(5, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xab(Z80& cpu)
 	{
-		cpu.RES(5, cpu.m_reg_DE.lo);
+		cpu.RES(5, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1014,31 +1014,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xaf(Z80& cpu)
 	{
-		cpu.RES(5, cpu.m_reg_AF.hi);
+		cpu.RES(5, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xb0(Z80& cpu)
 	{
-		cpu.RES(6, cpu.m_reg_BC.hi);
+		cpu.RES(6, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xb1(Z80& cpu)
 	{
-		cpu.RES(6, cpu.m_reg_BC.lo);
+		cpu.RES(6, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xb2(Z80& cpu)
 	{
-		cpu.RES(6, cpu.m_reg_DE.hi);
+		cpu.RES(6, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xb3(Z80& cpu)
 	{
-		cpu.RES(6, cpu.m_reg_DE.lo);
+		cpu.RES(6, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1062,31 +1062,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xb7(Z80& cpu)
 	{
-		cpu.RES(6, cpu.m_reg_AF.hi);
+		cpu.RES(6, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xb8(Z80& cpu)
 	{
-		cpu.RES(7, cpu.m_reg_BC.hi);
+		cpu.RES(7, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xb9(Z80& cpu)
 	{
-		cpu.RES(7, cpu.m_reg_BC.lo);
+		cpu.RES(7, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xba(Z80& cpu)
 	{
-		cpu.RES(7, cpu.m_reg_DE.hi);
+		cpu.RES(7, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xbb(Z80& cpu)
 	{
-		cpu.RES(7, cpu.m_reg_DE.lo);
+		cpu.RES(7, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1110,31 +1110,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xbf(Z80& cpu)
 	{
-		cpu.RES(7, cpu.m_reg_AF.hi);
+		cpu.RES(7, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xc0(Z80& cpu)
 	{
-		cpu.SET(0, cpu.m_reg_BC.hi);
+		cpu.SET(0, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xc1(Z80& cpu)
 	{
-		cpu.SET(0, cpu.m_reg_BC.lo);
+		cpu.SET(0, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xc2(Z80& cpu)
 	{
-		cpu.SET(0, cpu.m_reg_DE.hi);
+		cpu.SET(0, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xc3(Z80& cpu)
 	{
-		cpu.SET(0, cpu.m_reg_DE.lo);
+		cpu.SET(0, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1158,31 +1158,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xc7(Z80& cpu)
 	{
-		cpu.SET(0, cpu.m_reg_AF.hi);
+		cpu.SET(0, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xc8(Z80& cpu)
 	{
-		cpu.SET(1, cpu.m_reg_BC.hi);
+		cpu.SET(1, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xc9(Z80& cpu)
 	{
-		cpu.SET(1, cpu.m_reg_BC.lo);
+		cpu.SET(1, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xca(Z80& cpu)
 	{
-		cpu.SET(1, cpu.m_reg_DE.hi);
+		cpu.SET(1, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xcb(Z80& cpu)
 	{
-		cpu.SET(1, cpu.m_reg_DE.lo);
+		cpu.SET(1, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1206,31 +1206,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xcf(Z80& cpu)
 	{
-		cpu.SET(1, cpu.m_reg_AF.hi);
+		cpu.SET(1, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xd0(Z80& cpu)
 	{
-		cpu.SET(2, cpu.m_reg_BC.hi);
+		cpu.SET(2, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xd1(Z80& cpu)
 	{
-		cpu.SET(2, cpu.m_reg_BC.lo);
+		cpu.SET(2, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xd2(Z80& cpu)
 	{
-		cpu.SET(2, cpu.m_reg_DE.hi);
+		cpu.SET(2, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xd3(Z80& cpu)
 	{
-		cpu.SET(2, cpu.m_reg_DE.lo);
+		cpu.SET(2, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1254,31 +1254,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xd7(Z80& cpu)
 	{
-		cpu.SET(2, cpu.m_reg_AF.hi);
+		cpu.SET(2, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xd8(Z80& cpu)
 	{
-		cpu.SET(3, cpu.m_reg_BC.hi);
+		cpu.SET(3, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xd9(Z80& cpu)
 	{
-		cpu.SET(3, cpu.m_reg_BC.lo);
+		cpu.SET(3, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xda(Z80& cpu)
 	{
-		cpu.SET(3, cpu.m_reg_DE.hi);
+		cpu.SET(3, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xdb(Z80& cpu)
 	{
-		cpu.SET(3, cpu.m_reg_DE.lo);
+		cpu.SET(3, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1302,31 +1302,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xdf(Z80& cpu)
 	{
-		cpu.SET(3, cpu.m_reg_AF.hi);
+		cpu.SET(3, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xe0(Z80& cpu)
 	{
-		cpu.SET(4, cpu.m_reg_BC.hi);
+		cpu.SET(4, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xe1(Z80& cpu)
 	{
-		cpu.SET(4, cpu.m_reg_BC.lo);
+		cpu.SET(4, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xe2(Z80& cpu)
 	{
-		cpu.SET(4, cpu.m_reg_DE.hi);
+		cpu.SET(4, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xe3(Z80& cpu)
 	{
-		cpu.SET(4, cpu.m_reg_DE.lo);
+		cpu.SET(4, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1350,31 +1350,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xe7(Z80& cpu)
 	{
-		cpu.SET(4, cpu.m_reg_AF.hi);
+		cpu.SET(4, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xe8(Z80& cpu)
 	{
-		cpu.SET(5, cpu.m_reg_BC.hi);
+		cpu.SET(5, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xe9(Z80& cpu)
 	{
-		cpu.SET(5, cpu.m_reg_BC.lo);
+		cpu.SET(5, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xea(Z80& cpu)
 	{
-		cpu.SET(5, cpu.m_reg_DE.hi);
+		cpu.SET(5, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xeb(Z80& cpu)
 	{
-		cpu.SET(5, cpu.m_reg_DE.lo);
+		cpu.SET(5, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1398,31 +1398,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xef(Z80& cpu)
 	{
-		cpu.SET(5, cpu.m_reg_AF.hi);
+		cpu.SET(5, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xf0(Z80& cpu)
 	{
-		cpu.SET(6, cpu.m_reg_BC.hi);
+		cpu.SET(6, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xf1(Z80& cpu)
 	{
-		cpu.SET(6, cpu.m_reg_BC.lo);
+		cpu.SET(6, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xf2(Z80& cpu)
 	{
-		cpu.SET(6, cpu.m_reg_DE.hi);
+		cpu.SET(6, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xf3(Z80& cpu)
 	{
-		cpu.SET(6, cpu.m_reg_DE.lo);
+		cpu.SET(6, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1446,31 +1446,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xf7(Z80& cpu)
 	{
-		cpu.SET(6, cpu.m_reg_AF.hi);
+		cpu.SET(6, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xf8(Z80& cpu)
 	{
-		cpu.SET(7, cpu.m_reg_BC.hi);
+		cpu.SET(7, cpu.m_state.reg_BC.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xf9(Z80& cpu)
 	{
-		cpu.SET(7, cpu.m_reg_BC.lo);
+		cpu.SET(7, cpu.m_state.reg_BC.lo);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xfa(Z80& cpu)
 	{
-		cpu.SET(7, cpu.m_reg_DE.hi);
+		cpu.SET(7, cpu.m_state.reg_DE.hi);
 		return 8;
 	};
 
 	inline uint8_t opcodesCB0xfb(Z80& cpu)
 	{
-		cpu.SET(7, cpu.m_reg_DE.lo);
+		cpu.SET(7, cpu.m_state.reg_DE.lo);
 		return 8;
 	};
 
@@ -1494,7 +1494,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesCB0xff(Z80& cpu)
 	{
-		cpu.SET(7, cpu.m_reg_AF.hi);
+		cpu.SET(7, cpu.m_state.reg_AF.hi);
 		return 8;
 	};
 
@@ -12,25 +12,25 @@ namespace Z80Instructions
 {
 	inline uint8_t opcodesED0x40(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_BC.hi);
+		cpu.IN_C(cpu.m_state.reg_BC.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x41(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_BC.hi);
+		cpu.OUT_C(cpu.m_state.reg_BC.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x42(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_BC.value);
+		cpu.SBC(cpu.m_state.reg_BC.value);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x43(Z80& cpu)
 	{
-		cpu.LD_NNDD(cpu.m_reg_BC);
+		cpu.LD_NNDD(cpu.m_state.reg_BC);
 		return 20;
 	};
 
@@ -54,31 +54,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesED0x47(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_interrupt, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_interrupt, cpu.m_state.reg_AF.hi);
 		return 9;
 	};
 
 	inline uint8_t opcodesED0x48(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_BC.lo);
+		cpu.IN_C(cpu.m_state.reg_BC.lo);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x49(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_BC.lo);
+		cpu.OUT_C(cpu.m_state.reg_BC.lo);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x4a(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_BC.value);
+		cpu.ADC(cpu.m_state.reg_BC.value);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x4b(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_reg_BC);
+		cpu.LD_DDNN(cpu.m_state.reg_BC);
 		return 20;
 	};
 
@@ -90,31 +90,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesED0x4f(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_refresh, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_refresh, cpu.m_state.reg_AF.hi);
 		return 9;
 	};
 
 	inline uint8_t opcodesED0x50(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_DE.hi);
+		cpu.IN_C(cpu.m_state.reg_DE.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x51(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_DE.hi);
+		cpu.OUT_C(cpu.m_state.reg_DE.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x52(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_DE.value);
+		cpu.SBC(cpu.m_state.reg_DE.value);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x53(Z80& cpu)
 	{
-		cpu.LD_NNDD(cpu.m_reg_DE);
+		cpu.LD_NNDD(cpu.m_state.reg_DE);
 		return 20;
 	};
 
@@ -132,25 +132,25 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesED0x58(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_DE.lo);
+		cpu.IN_C(cpu.m_state.reg_DE.lo);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x59(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_DE.lo);
+		cpu.OUT_C(cpu.m_state.reg_DE.lo);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x5a(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_BC.value);
+		cpu.ADD(cpu.m_state.reg_BC.value);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x5b(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_reg_BC);
+		cpu.LD_DDNN(cpu.m_state.reg_BC);
 		return 20;
 	};
 
@@ -168,25 +168,25 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesED0x60(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_HL.hi);
+		cpu.IN_C(cpu.m_state.reg_HL.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x61(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_HL.hi);
+		cpu.OUT_C(cpu.m_state.reg_HL.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x62(Z80& cpu)
 	{
-		cpu.SBC_HL(cpu.m_reg_HL.value);
+		cpu.SBC_HL(cpu.m_state.reg_HL.value);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x63(Z80& cpu)
 	{
-		cpu.LD_NNDD(cpu.m_reg_HL.value);
+		cpu.LD_NNDD(cpu.m_state.reg_HL.value);
 		return 20;
 	};
 
@@ -198,25 +198,25 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesED0x68(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_HL.lo);
+		cpu.IN_C(cpu.m_state.reg_HL.lo);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x69(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_HL.lo);
+		cpu.OUT_C(cpu.m_state.reg_HL.lo);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x6a(Z80& cpu)
 	{
-		cpu.ADC_HL(cpu.m_reg_HL.value);
+		cpu.ADC_HL(cpu.m_state.reg_HL.value);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x6b(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_reg_HL);
+		cpu.LD_DDNN(cpu.m_state.reg_HL);
 		return 20;
 	};
 
@@ -228,37 +228,37 @@ namespace Z80Instructions
 
 	inline uint8_t opcodesED0x72(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_stack_pointer);
+		cpu.SBC(cpu.m_state.stack_pointer);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x73(Z80& cpu)
 	{
-		cpu.LD_NNDD(cpu.m_stack_pointer);
+		cpu.LD_NNDD(cpu.m_state.stack_pointer);
 		return 20;
 	};
 
 	inline uint8_t opcodesED0x78(Z80& cpu)
 	{
-		cpu.IN_C(cpu.m_reg_AF.hi);
+		cpu.IN_C(cpu.m_state.reg_AF.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x79(Z80& cpu)
 	{
-		cpu.OUT_C(cpu.m_reg_AF.hi);
+		cpu.OUT_C(cpu.m_state.reg_AF.hi);
 		return 12;
 	};
 
 	inline uint8_t opcodesED0x7a(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_stack_pointer);
+		cpu.ADC(cpu.m_state.stack_pointer);
 		return 15;
 	};
 
 	inline uint8_t opcodesED0x7b(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_stack_pointer);
+		cpu.LD_DDNN(cpu.m_state.stack_pointer);
 		return 20;
 	};
 
@@ -17,37 +17,37 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x01(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_reg_BC);
+		cpu.LD_DDNN(cpu.m_state.reg_BC);
 		return 10;
 	};
 
 	inline uint8_t opcodes0x02(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.value, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_BC.value, cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x03(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_BC);
+		cpu.INC(cpu.m_state.reg_BC);
 		return 6;
 	};
 
 	inline uint8_t opcodes0x04(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_BC.hi);
+		cpu.INC(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x05(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_BC.hi);
+		cpu.DEC(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x06(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.ReadByte());
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.ReadByte());
 		return 7;
 	};
 
@@ -59,43 +59,43 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x08(Z80& cpu)
 	{
-		cpu.EX(cpu.m_reg_AF, cpu.m_reg_AF_shadow);
+		cpu.EX(cpu.m_state.reg_AF, cpu.m_state.reg_AF_shadow);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x09(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_BC.value);
+		cpu.ADD(cpu.m_state.reg_BC.value);
 		return 11;
 	};
 
 	inline uint8_t opcodes0x0a(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_BC.value);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.value);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x0b(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_BC);
+		cpu.DEC(cpu.m_state.reg_BC);
 		return 6;
 	};
 
 	inline uint8_t opcodes0x0c(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_BC.lo);
+		cpu.INC(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x0d(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_BC.lo);
+		cpu.DEC(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x0e(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.ReadByte());
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.ReadByte());
 		return 7;
 	};
 
@@ -112,37 +112,37 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x11(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_reg_DE);
+		cpu.LD_DDNN(cpu.m_state.reg_DE);
 		return 10;
 	};
 
 	inline uint8_t opcodes0x12(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.value, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_DE.value, cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x13(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_DE);
+		cpu.INC(cpu.m_state.reg_DE);
 		return 6;
 	};
 
 	inline uint8_t opcodes0x14(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_DE.hi);
+		cpu.INC(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x15(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_DE.hi);
+		cpu.DEC(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x16(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.ReadByte());
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.ReadByte());
 		return 7;
 	};
 
@@ -160,37 +160,37 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x19(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_DE.value);
+		cpu.ADD(cpu.m_state.reg_DE.value);
 		return 11;
 	};
 
 	inline uint8_t opcodes0x1a(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_DE.value);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.value);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x1b(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_DE);
+		cpu.DEC(cpu.m_state.reg_DE);
 		return 6;
 	};
 
 	inline uint8_t opcodes0x1c(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_DE.lo);
+		cpu.INC(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x1d(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_DE.lo);
+		cpu.DEC(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x1e(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.ReadByte());
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.ReadByte());
 		return 7;
 	};
 
@@ -301,19 +301,19 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x31(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_stack_pointer);
+		cpu.LD_DDNN(cpu.m_state.stack_pointer);
 		return 10;
 	};
 
 	inline uint8_t opcodes0x32(Z80& cpu)
 	{
-		cpu.LD_NNDD(cpu.m_reg_AF.hi);
+		cpu.LD_NNDD(cpu.m_state.reg_AF.hi);
 		return 13;
 	};
 
 	inline uint8_t opcodes0x33(Z80& cpu)
 	{
-		cpu.INC(cpu.m_stack_pointer);
+		cpu.INC(cpu.m_state.stack_pointer);
 		return 6;
 	};
 
@@ -348,37 +348,37 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x39(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_stack_pointer);
+		cpu.ADD(cpu.m_state.stack_pointer);
 		return 11;
 	};
 
 	inline uint8_t opcodes0x3a(Z80& cpu)
 	{
-		cpu.LD_DDNN(cpu.m_reg_AF.hi);
+		cpu.LD_DDNN(cpu.m_state.reg_AF.hi);
 		return 13;
 	};
 
 	inline uint8_t opcodes0x3b(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_stack_pointer);
+		cpu.DEC(cpu.m_state.stack_pointer);
 		return 6;
 	};
 
 	inline uint8_t opcodes0x3c(Z80& cpu)
 	{
-		cpu.INC(cpu.m_reg_AF.hi);
+		cpu.INC(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x3d(Z80& cpu)
 	{
-		cpu.DEC(cpu.m_reg_AF.hi);
+		cpu.DEC(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x3e(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.ReadByte());
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.ReadByte());
 		return 7;
 	};
 
@@ -390,217 +390,217 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x40(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x41(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x42(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x43(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x44(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.GetPrefixedHL().hi);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x45(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.GetPrefixedHL().lo);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x46(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.GetPrefixedHLAddress());
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.GetPrefixedHLAddress());
 		return 7;
 	};
 
 	inline uint8_t opcodes0x47(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.hi, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_BC.hi, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x48(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x49(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x4a(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x4b(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x4c(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.GetPrefixedHL().hi);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x4d(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.GetPrefixedHL().lo);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x4e(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.GetPrefixedHLAddress());
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.GetPrefixedHLAddress());
 		return 7;
 	};
 
 	inline uint8_t opcodes0x4f(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_BC.lo, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_BC.lo, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x50(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x51(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x52(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x53(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x54(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.GetPrefixedHL().hi);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x55(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.GetPrefixedHL().lo);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x56(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.GetPrefixedHLAddress());
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.GetPrefixedHLAddress());
 		return 7;
 	};
 
 	inline uint8_t opcodes0x57(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.hi, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_DE.hi, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x58(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x59(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x5a(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x5b(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x5c(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.GetPrefixedHL().hi);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x5d(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.GetPrefixedHL().lo);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x5e(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.GetPrefixedHLAddress());
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.GetPrefixedHLAddress());
 		return 7;
 	};
 
 	inline uint8_t opcodes0x5f(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_DE.lo, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_DE.lo, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x60(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x61(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x62(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x63(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -624,31 +624,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x67(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.GetPrefixedHL().hi, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x68(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x69(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x6a(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x6b(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -672,31 +672,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x6f(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.GetPrefixedHL().lo, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x70(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_reg_BC.hi);
+		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_state.reg_BC.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x71(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_reg_BC.lo);
+		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_state.reg_BC.lo);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x72(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_reg_DE.hi);
+		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_state.reg_DE.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x73(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_reg_DE.lo);
+		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_state.reg_DE.lo);
 		return 7;
 	};
 
@@ -720,175 +720,175 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x77(Z80& cpu)
 	{
-		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_reg_AF.hi);
+		cpu.LD(cpu.GetPrefixedHLAddress(), cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x78(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_BC.hi);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x79(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_BC.lo);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x7a(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_DE.hi);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x7b(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_DE.lo);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x7c(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().hi);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x7d(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().lo);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x7e(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.GetPrefixedHLAddress());
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHLAddress());
 		return 7;
 	};
 
 	inline uint8_t opcodes0x7f(Z80& cpu)
 	{
-		cpu.LD(cpu.m_reg_AF.hi, cpu.m_reg_AF.hi);
+		cpu.LD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x80(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.m_reg_BC.hi);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x81(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.m_reg_BC.lo);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x82(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.m_reg_DE.hi);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x83(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.m_reg_DE.lo);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x84(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().hi);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x85(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().lo);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x86(Z80& cpu)
 	{
-		cpu.ADD_HL(cpu.m_reg_AF.hi);
+		cpu.ADD_HL(cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x87(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.m_reg_AF.hi);
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x88(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.m_reg_BC.hi);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x89(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.m_reg_BC.lo);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x8a(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.m_reg_DE.hi);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x8b(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.m_reg_DE.lo);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x8c(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().hi);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x8d(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().lo);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x8e(Z80& cpu)
 	{
-		cpu.ADC_HL(cpu.m_reg_AF.hi);
+		cpu.ADC_HL(cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x8f(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.m_reg_AF.hi);
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x90(Z80& cpu)
 	{
-		cpu.SUB(cpu.m_reg_BC.hi);
+		cpu.SUB(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x91(Z80& cpu)
 	{
-		cpu.SUB(cpu.m_reg_BC.lo);
+		cpu.SUB(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x92(Z80& cpu)
 	{
-		cpu.SUB(cpu.m_reg_DE.hi);
+		cpu.SUB(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x93(Z80& cpu)
 	{
-		cpu.SUB(cpu.m_reg_DE.lo);
+		cpu.SUB(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -906,85 +906,85 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0x96(Z80& cpu)
 	{
-		cpu.SUB_HL(cpu.m_reg_AF.hi);
+		cpu.SUB_HL(cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x97(Z80& cpu)
 	{
-		cpu.SUB(cpu.m_reg_AF.hi);
+		cpu.SUB(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x98(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.m_reg_BC.hi);
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x99(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.m_reg_BC.lo);
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x9a(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.m_reg_DE.hi);
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x9b(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.m_reg_DE.lo);
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x9c(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().hi);
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x9d(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.GetPrefixedHL().lo);
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.GetPrefixedHL().lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0x9e(Z80& cpu)
 	{
-		cpu.SBC_HL(cpu.m_reg_AF.hi);
+		cpu.SBC_HL(cpu.m_state.reg_AF.hi);
 		return 7;
 	};
 
 	inline uint8_t opcodes0x9f(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi);
+		cpu.SBC(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xa0(Z80& cpu)
 	{
-		cpu.AND(cpu.m_reg_BC.hi);
+		cpu.AND(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xa1(Z80& cpu)
 	{
-		cpu.AND(cpu.m_reg_BC.lo);
+		cpu.AND(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xa2(Z80& cpu)
 	{
-		cpu.AND(cpu.m_reg_DE.hi);
+		cpu.AND(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xa3(Z80& cpu)
 	{
-		cpu.AND(cpu.m_reg_DE.lo);
+		cpu.AND(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -1008,31 +1008,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xa7(Z80& cpu)
 	{
-		cpu.AND(cpu.m_reg_AF.hi);
+		cpu.AND(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xa8(Z80& cpu)
 	{
-		cpu.XOR(cpu.m_reg_BC.hi);
+		cpu.XOR(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xa9(Z80& cpu)
 	{
-		cpu.XOR(cpu.m_reg_BC.lo);
+		cpu.XOR(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xaa(Z80& cpu)
 	{
-		cpu.XOR(cpu.m_reg_DE.hi);
+		cpu.XOR(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xab(Z80& cpu)
 	{
-		cpu.XOR(cpu.m_reg_DE.lo);
+		cpu.XOR(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -1056,31 +1056,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xaf(Z80& cpu)
 	{
-		cpu.XOR(cpu.m_reg_AF.hi);
+		cpu.XOR(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xb0(Z80& cpu)
 	{
-		cpu.OR(cpu.m_reg_BC.hi);
+		cpu.OR(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xb1(Z80& cpu)
 	{
-		cpu.OR(cpu.m_reg_BC.lo);
+		cpu.OR(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xb2(Z80& cpu)
 	{
-		cpu.OR(cpu.m_reg_DE.hi);
+		cpu.OR(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xb3(Z80& cpu)
 	{
-		cpu.OR(cpu.m_reg_DE.lo);
+		cpu.OR(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -1104,31 +1104,31 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xb7(Z80& cpu)
 	{
-		cpu.OR(cpu.m_reg_AF.hi);
+		cpu.OR(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xb8(Z80& cpu)
 	{
-		cpu.CP(cpu.m_reg_BC.hi);
+		cpu.CP(cpu.m_state.reg_BC.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xb9(Z80& cpu)
 	{
-		cpu.CP(cpu.m_reg_BC.lo);
+		cpu.CP(cpu.m_state.reg_BC.lo);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xba(Z80& cpu)
 	{
-		cpu.CP(cpu.m_reg_DE.hi);
+		cpu.CP(cpu.m_state.reg_DE.hi);
 		return 4;
 	};
 
 	inline uint8_t opcodes0xbb(Z80& cpu)
 	{
-		cpu.CP(cpu.m_reg_DE.lo);
+		cpu.CP(cpu.m_state.reg_DE.lo);
 		return 4;
 	};
 
@@ -1152,7 +1152,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xbf(Z80& cpu)
 	{
-		cpu.CP(cpu.m_reg_AF.hi);
+		cpu.CP(cpu.m_state.reg_AF.hi);
 		return 4;
 	};
 
@@ -1163,7 +1163,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xc1(Z80& cpu)
 	{
-		cpu.POP(cpu.m_reg_BC);
+		cpu.POP(cpu.m_state.reg_BC);
 		return 10;
 	};
 
@@ -1186,13 +1186,13 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xc5(Z80& cpu)
 	{
-		cpu.PUSH(cpu.m_reg_BC);
+		cpu.PUSH(cpu.m_state.reg_BC);
 		return 11;
 	};
 
 	inline uint8_t opcodes0xc6(Z80& cpu)
 	{
-		cpu.ADD(cpu.m_reg_AF.hi, cpu.ReadByte());
+		cpu.ADD(cpu.m_state.reg_AF.hi, cpu.ReadByte());
 		return 7;
 	};
 
@@ -1238,7 +1238,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xce(Z80& cpu)
 	{
-		cpu.ADC(cpu.m_reg_AF.hi, cpu.ReadByte());
+		cpu.ADC(cpu.m_state.reg_AF.hi, cpu.ReadByte());
 		return 7;
 	};
 
@@ -1255,7 +1255,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xd1(Z80& cpu)
 	{
-		cpu.POP(cpu.m_reg_DE);
+		cpu.POP(cpu.m_state.reg_DE);
 		return 10;
 	};
 
@@ -1267,7 +1267,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xd3(Z80& cpu)
 	{
-		cpu.OUT_N(cpu.m_reg_AF.hi);
+		cpu.OUT_N(cpu.m_state.reg_AF.hi);
 		return 11;
 	};
 
@@ -1278,7 +1278,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xd5(Z80& cpu)
 	{
-		cpu.PUSH(cpu.m_reg_DE);
+		cpu.PUSH(cpu.m_state.reg_DE);
 		return 11;
 	};
 
@@ -1313,7 +1313,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xdb(Z80& cpu)
 	{
-		cpu.IN_N(cpu.m_reg_AF.hi);
+		cpu.IN_N(cpu.m_state.reg_AF.hi);
 		return 11;
 	};
 
@@ -1330,7 +1330,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xde(Z80& cpu)
 	{
-		cpu.SBC(cpu.m_reg_AF.hi, cpu.ReadByte());
+		cpu.SBC(cpu.m_state.reg_AF.hi, cpu.ReadByte());
 		return 7;
 	};
 
@@ -1405,7 +1405,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xeb(Z80& cpu)
 	{
-		cpu.EX(cpu.m_reg_DE, cpu.GetPrefixedHL());
+		cpu.EX(cpu.m_state.reg_DE, cpu.GetPrefixedHL());
 		return 4;
 	};
 
@@ -1439,7 +1439,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xf1(Z80& cpu)
 	{
-		cpu.POP(cpu.m_reg_AF);
+		cpu.POP(cpu.m_state.reg_AF);
 		return 10;
 	};
 
@@ -1462,7 +1462,7 @@ namespace Z80Instructions
 
 	inline uint8_t opcodes0xf5(Z80& cpu)
 	{
-		cpu.PUSH(cpu.m_reg_AF);
+		cpu.PUSH(cpu.m_state.reg_AF);
 		return 11;
 	};
 
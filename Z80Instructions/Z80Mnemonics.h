@@ -0,0 +1,788 @@
+/*
+	Autogenerated File (generate_mnemonics.py).
+*/
+
+#pragma once
+
+namespace Z80Instructions
+{
+	const char* const s_opcode_mnemonics [256] = 
+	{
+		"NOP", // 0x00
+		"LD bc,{nn}", // 0x01
+		"LD (bc),a", // 0x02
+		"INC bc", // 0x03
+		"INC b", // 0x04
+		"DEC b", // 0x05
+		"LD b,{n}", // 0x06
+		"RLCA", // 0x07
+		"EX af,af'", // 0x08
+		"ADD hl,bc", // 0x09
+		"LD a,(bc)", // 0x0a
+		"DEC bc", // 0x0b
+		"INC c", // 0x0c
+		"DEC c", // 0x0d
+		"LD c,{n}", // 0x0e
+		"RRCA", // 0x0f
+		"DJNZ {e}", // 0x10
+		"LD de,{nn}", // 0x11
+		"LD (de),a", // 0x12
+		"INC de", // 0x13
+		"INC d", // 0x14
+		"DEC d", // 0x15
+		"LD d,{n}", // 0x16
+		"RLA", // 0x17
+		"JR {e}", // 0x18
+		"ADD hl,de", // 0x19
+		"LD a,(de)", // 0x1a
+		"DEC de", // 0x1b
+		"INC e", // 0x1c
+		"DEC e", // 0x1d
+		"LD e,{n}", // 0x1e
+		"RRA", // 0x1f
+		"JR nz,{e}", // 0x20
+		"LD hl,{nn}", // 0x21
+		"LD ({nn}),hl", // 0x22
+		"INC hl", // 0x23
+		"INC h", // 0x24
+		"DEC h", // 0x25
+		"LD h,{n}", // 0x26
+		"DAA", // 0x27
+		"JR z,{e}", // 0x28
+		"ADD hl,hl", // 0x29
+		"LD hl,({nn})", // 0x2a
+		"DEC hl", // 0x2b
+		"INC l", // 0x2c
+		"DEC l", // 0x2d
+		"LD l,{n}", // 0x2e
+		"CPL", // 0x2f
+		"JR nc,{e}", // 0x30
+		"LD sp,{nn}", // 0x31
+		"LD ({nn}),a", // 0x32
+		"INC sp", // 0x33
+		"INC (hl)", // 0x34
+		"DEC (hl)", // 0x35
+		"LD (hl),{n}", // 0x36
+		"SCF", // 0x37
+		"JR c,{e}", // 0x38
+		"ADD hl,sp", // 0x39
+		"LD a,({nn})", // 0x3a
+		"DEC sp", // 0x3b
+		"INC a", // 0x3c
+		"DEC a", // 0x3d
+		"LD a,{n}", // 0x3e
+		"CCF", // 0x3f
+		"LD b,b", // 0x40
+		"LD b,c", // 0x41
+		"LD b,d", // 0x42
+		"LD b,e", // 0x43
+		"LD b,h", // 0x44
+		"LD b,l", // 0x45
+		"LD b,(hl)", // 0x46
+		"LD b,a", // 0x47
+		"LD c,b", // 0x48
+		"LD c,c", // 0x49
+		"LD c,d", // 0x4a
+		"LD c,e", // 0x4b
+		"LD c,h", // 0x4c
+		"LD c,l", // 0x4d
+		"LD c,(hl)", // 0x4e
+		"LD c,a", // 0x4f
+		"LD d,b", // 0x50
+		"LD d,c", // 0x51
+		"LD d,d", // 0x52
+		"LD d,e", // 0x53
+		"LD d,h", // 0x54
+		"LD d,l", // 0x55
+		"LD d,(hl)", // 0x56
+		"LD d,a", // 0x57
+		"LD e,b", // 0x58
+		"LD e,c", // 0x59
+		"LD e,d", // 0x5a
+		"LD e,e", // 0x5b
+		"LD e,h", // 0x5c
+		"LD e,l", // 0x5d
+		"LD e,(hl)", // 0x5e
+		"LD e,a", // 0x5f
+		"LD h,b", // 0x60
+		"LD h,c", // 0x61
+		"LD h,d", // 0x62
+		"LD h,e", // 0x63
+		"LD h,h", // 0x64
+		"LD h,l", // 0x65
+		"LD h,(hl)", // 0x66
+		"LD h,a", // 0x67
+		"LD l,b", // 0x68
+		"LD l,c", // 0x69
+		"LD l,d", // 0x6a
+		"LD l,e", // 0x6b
+		"LD l,h", // 0x6c
+		"LD l,l", // 0x6d
+		"LD l,(hl)", // 0x6e
+		"LD l,a", // 0x6f
+		"LD (hl),b", // 0x70
+		"LD (hl),c", // 0x71
+		"LD (hl),d", // 0x72
+		"LD (hl),e", // 0x73
+		"LD (hl),h", // 0x74
+		"LD (hl),l", // 0x75
+		"HALT", // 0x76
+		"LD (hl),a", // 0x77
+		"LD a,b", // 0x78
+		"LD a,c", // 0x79
+		"LD a,d", // 0x7a
+		"LD a,e", // 0x7b
+		"LD a,h", // 0x7c
+		"LD a,l", // 0x7d
+		"LD a,(hl)", // 0x7e
+		"LD a,a", // 0x7f
+		"ADD a,b", // 0x80
+		"ADD a,c", // 0x81
+		"ADD a,d", // 0x82
+		"ADD a,e", // 0x83
+		"ADD a,h", // 0x84
+		"ADD a,l", // 0x85
+		"ADD a,(hl)", // 0x86
+		"ADD a,a", // 0x87
+		"ADC a,b", // 0x88
+		"ADC a,c", // 0x89
+		"ADC a,d", // 0x8a
+		"ADC a,e", // 0x8b
+		"ADC a,h", // 0x8c
+		"ADC a,l", // 0x8d
+		"ADC a,(hl)", // 0x8e
+		"ADC a,a", // 0x8f
+		"SUB b", // 0x90
+		"SUB c", // 0x91
+		"SUB d", // 0x92
+		"SUB e", // 0x93
+		"SUB h", // 0x94
+		"SUB l", // 0x95
+		"SUB (hl)", // 0x96
+		"SUB a", // 0x97
+		"SBC a,b", // 0x98
+		"SBC a,c", // 0x99
+		"SBC a,d", // 0x9a
+		"SBC a,e", // 0x9b
+		"SBC a,h", // 0x9c
+		"SBC a,l", // 0x9d
+		"SBC a,(hl)", // 0x9e
+		"SBC a,a", // 0x9f
+		"AND b", // 0xa0
+		"AND c", // 0xa1
+		"AND d", // 0xa2
+		"AND e", // 0xa3
+		"AND h", // 0xa4
+		"AND l", // 0xa5
+		"AND (hl)", // 0xa6
+		"AND a", // 0xa7
+		"XOR b", // 0xa8
+		"XOR c", // 0xa9
+		"XOR d", // 0xaa
+		"XOR e", // 0xab
+		"XOR h", // 0xac
+		"XOR l", // 0xad
+		"XOR (hl)", // 0xae
+		"XOR a", // 0xaf
+		"OR b", // 0xb0
+		"OR c", // 0xb1
+		"OR d", // 0xb2
+		"OR e", // 0xb3
+		"OR h", // 0xb4
+		"OR l", // 0xb5
+		"OR (hl)", // 0xb6
+		"OR a", // 0xb7
+		"CP b", // 0xb8
+		"CP c", // 0xb9
+		"CP d", // 0xba
+		"CP e", // 0xbb
+		"CP h", // 0xbc
+		"CP l", // 0xbd
+		"CP (hl)", // 0xbe
+		"CP a", // 0xbf
+		"RET nz", // 0xc0
+		"POP bc", // 0xc1
+		"JP nz,{nn}", // 0xc2
+		"JP {nn}", // 0xc3
+		"CALL nz,{nn}", // 0xc4
+		"PUSH bc", // 0xc5
+		"ADD a,{n}", // 0xc6
+		"RST $00", // 0xc7
+		"RET z", // 0xc8
+		"RET", // 0xc9
+		"JP z,{nn}", // 0xca
+		nullptr, // 0xcb
+		"CALL z,{nn}", // 0xcc
+		"CALL {nn}", // 0xcd
+		"ADC a,{n}", // 0xce
+		"RST $08", // 0xcf
+		"RET nc", // 0xd0
+		"POP de", // 0xd1
+		"JP nc,{nn}", // 0xd2
+		"OUT ({n}),a", // 0xd3
+		"CALL nc,{nn}", // 0xd4
+		"PUSH de", // 0xd5
+		"SUB {n}", // 0xd6
+		"RST $10", // 0xd7
+		"RET c", // 0xd8
+		"EXX", // 0xd9
+		"JP c,{nn}", // 0xda
+		"IN a,({n})", // 0xdb
+		"CALL c,{nn}", // 0xdc
+		nullptr, // 0xdd
+		"SBC a,{n}", // 0xde
+		"RST $18", // 0xdf
+		"RET po", // 0xe0
+		"POP hl", // 0xe1
+		"JP po,{nn}", // 0xe2
+		"EX (sp),hl", // 0xe3
+		"CALL po,{nn}", // 0xe4
+		"PUSH hl", // 0xe5
+		"AND {n}", // 0xe6
+		"RST $20", // 0xe7
+		"RET pe", // 0xe8
+		"JP (hl)", // 0xe9
+		"JP pe,{nn}", // 0xea
+		"EX de,hl", // 0xeb
+		"CALL pe,{nn}", // 0xec
+		nullptr, // 0xed
+		"XOR {n}", // 0xee
+		"RST $28", // 0xef
+		"RET p", // 0xf0
+		"POP af", // 0xf1
+		"JP p,{nn}", // 0xf2
+		"DI", // 0xf3
+		"CALL p,{nn}", // 0xf4
+		"PUSH af", // 0xf5
+		"OR {n}", // 0xf6
+		"RST $30", // 0xf7
+		"RET m", // 0xf8
+		"LD sp,hl", // 0xf9
+		"JP m,{nn}", // 0xfa
+		"EI", // 0xfb
+		"CALL m,{nn}", // 0xfc
+		nullptr, // 0xfd
+		"CP {n}", // 0xfe
+		"RST $38"  // 0xff
+	};
+
+	const char* const s_opcode_cb_mnemonics [256] = 
+	{
+		"RLC b", // 0x00
+		"RLC c", // 0x01
+		"RLC d", // 0x02
+		"RLC e", // 0x03
+		"RLC h", // 0x04
+		"RLC l", // 0x05
+		"RLC (hl)", // 0x06
+		"RLC a", // 0x07
+		"RRC b", // 0x08
+		"RRC c", // 0x09
+		"RRC d", // 0x0a
+		"RRC e", // 0x0b
+		"RRC h", // 0x0c
+		"RRC l", // 0x0d
+		"RRC (hl)", // 0x0e
+		"RRC a", // 0x0f
+		"RL b", // 0x10
+		"RL c", // 0x11
+		"RL d", // 0x12
+		"RL e", // 0x13
+		"RL h", // 0x14
+		"RL l", // 0x15
+		"RL (hl)", // 0x16
+		"RL a", // 0x17
+		"RR b", // 0x18
+		"RR c", // 0x19
+		"RR d", // 0x1a
+		"RR e", // 0x1b
+		"RR h", // 0x1c
+		"RR l", // 0x1d
+		"RR (hl)", // 0x1e
+		"RR a", // 0x1f
+		"SLA b", // 0x20
+		"SLA c", // 0x21
+		"SLA d", // 0x22
+		"SLA e", // 0x23
+		"SLA h", // 0x24
+		"SLA l", // 0x25
+		"SLA (hl)", // 0x26
+		"SLA a", // 0x27
+		"SRA b", // 0x28
+		"SRA c", // 0x29
+		"SRA d", // 0x2a
+		"SRA e", // 0x2b
+		"SRA h", // 0x2c
+		"SRA l", // 0x2d
+		"SRA (hl)", // 0x2e
+		"SRA a", // 0x2f
+		nullptr, // 0x30
+		nullptr, // 0x31
+		nullptr, // 0x32
+		nullptr, // 0x33
+		nullptr, // 0x34
+		nullptr, // 0x35
+		nullptr, // 0x36
+		nullptr, // 0x37
+		"SRL b", // 0x38
+		"SRL c", // 0x39
+		"SRL d", // 0x3a
+		"SRL e", // 0x3b
+		"SRL h", // 0x3c
+		"SRL l", // 0x3d
+		"SRL (hl)", // 0x3e
+		"SRL a", // 0x3f
+		"BIT 0,b", // 0x40
+		"BIT 0,c", // 0x41
+		"BIT 0,d", // 0x42
+		"BIT 0,e", // 0x43
+		"BIT 0,h", // 0x44
+		"BIT 0,l", // 0x45
+		"BIT 0,(hl)", // 0x46
+		"BIT 0,a", // 0x47
+		"BIT 1,b", // 0x48
+		"BIT 1,c", // 0x49
+		"BIT 1,d", // 0x4a
+		"BIT 1,e", // 0x4b
+		"BIT 1,h", // 0x4c
+		"BIT 1,l", // 0x4d
+		"BIT 1,(hl)", // 0x4e
+		"BIT 1,a", // 0x4f
+		"BIT 2,b", // 0x50
+		"BIT 2,c", // 0x51
+		"BIT 2,d", // 0x52
+		"BIT 2,e", // 0x53
+		"BIT 2,h", // 0x54
+		"BIT 2,l", // 0x55
+		"BIT 2,(hl)", // 0x56
+		"BIT 2,a", // 0x57
+		"BIT 3,b", // 0x58
+		"BIT 3,c", // 0x59
+		"BIT 3,d", // 0x5a
+		"BIT 3,e", // 0x5b
+		"BIT 3,h", // 0x5c
+		"BIT 3,l", // 0x5d
+		"BIT 3,(hl)", // 0x5e
+		"BIT 3,a", // 0x5f
+		"BIT 4,b", // 0x60
+		"BIT 4,c", // 0x61
+		"BIT 4,d", // 0x62
+		"BIT 4,e", // 0x63
+		"BIT 4,h", // 0x64
+		"BIT 4,l", // 0x65
+		"BIT 4,(hl)", // 0x66
+		"BIT 4,a", // 0x67
+		"BIT 5,b", // 0x68
+		"BIT 5,c", // 0x69
+		"BIT 5,d", // 0x6a
+		"BIT 5,e", // 0x6b
+		"BIT 5,h", // 0x6c
+		"BIT 5,l", // 0x6d
+		"BIT 5,(hl)", // 0x6e
+		"BIT 5,a", // 0x6f
+		"BIT 6,b", // 0x70
+		"BIT 6,c", // 0x71
+		"BIT 6,d", // 0x72
+		"BIT 6,e", // 0x73
+		"BIT 6,h", // 0x74
+		"BIT 6,l", // 0x75
+		"BIT 6,(hl)", // 0x76
+		"BIT 6,a", // 0x77
+		"BIT 7,b", // 0x78
+		"BIT 7,c", // 0x79
+		"BIT 7,d", // 0x7a
+		"BIT 7,e", // 0x7b
+		"BIT 7,h", // 0x7c
+		"BIT 7,l", // 0x7d
+		"BIT 7,(hl)", // 0x7e
+		"BIT 7,a", // 0x7f
+		"RES 0,b", // 0x80
+		"RES 0,c", // 0x81
+		"RES 0,d", // 0x82
+		"RES 0,e", // 0x83
+		"RES 0,h", // 0x84
+		"RES 0,l", // 0x85
+		"RES 0,(hl)", // 0x86
+		"RES 0,a", // 0x87
+		"RES 1,b", // 0x88
+		"RES 1,c", // 0x89
+		"RES 1,d", // 0x8a
+		"RES 1,e", // 0x8b
+		"RES 1,h", // 0x8c
+		"RES 1,l", // 0x8d
+		"RES 1,(hl)", // 0x8e
+		"RES 1,a", // 0x8f
+		"RES 2,b", // 0x90
+		"RES 2,c", // 0x91
+		"RES 2,d", // 0x92
+		"RES 2,e", // 0x93
+		"RES 2,h", // 0x94
+		"RES 2,l", // 0x95
+		"RES 2,(hl)", // 0x96
+		"RES 2,a", // 0x97
+		"RES 3,b", // 0x98
+		"RES 3,c", // 0x99
+		"RES 3,d", // 0x9a
+		"RES 3,e", // 0x9b
+		"RES 3,h", // 0x9c
+		"RES 3,l", // 0x9d
+		"RES 3,(hl)", // 0x9e
+		"RES 3,a", // 0x9f
+		"RES 4,b", // 0xa0
+		"RES 4,c", // 0xa1
+		"RES 4,d", // 0xa2
+		"RES 4,e", // 0xa3
+		"RES 4,h", // 0xa4
+		"RES 4,l", // 0xa5
+		"RES 4,(hl)", // 0xa6
+		"RES 4,a", // 0xa7
+		"RES 5,b", // 0xa8
+		"RES 5,c", // 0xa9
+		"RES 5,d", // 0xaa
+		"RES 5,e", // 0xab
+		"RES 5,h", // 0xac
+		"RES 5,l", // 0xad
+		"RES 5,(hl)", // 0xae
+		"RES 5,a", // 0xaf
+		"RES 6,b", // 0xb0
+		"RES 6,c", // 0xb1
+		"RES 6,d", // 0xb2
+		"RES 6,e", // 0xb3
+		"RES 6,h", // 0xb4
+		"RES 6,l", // 0xb5
+		"RES 6,(hl)", // 0xb6
+		"RES 6,a", // 0xb7
+		"RES 7,b", // 0xb8
+		"RES 7,c", // 0xb9
+		"RES 7,d", // 0xba
+		"RES 7,e", // 0xbb
+		"RES 7,h", // 0xbc
+		"RES 7,l", // 0xbd
+		"RES 7,(hl)", // 0xbe
+		"RES 7,a", // 0xbf
+		"SET 0,b", // 0xc0
+		"SET 0,c", // 0xc1
+		"SET 0,d", // 0xc2
+		"SET 0,e", // 0xc3
+		"SET 0,h", // 0xc4
+		"SET 0,l", // 0xc5
+		"SET 0,(hl)", // 0xc6
+		"SET 0,a", // 0xc7
+		"SET 1,b", // 0xc8
+		"SET 1,c", // 0xc9
+		"SET 1,d", // 0xca
+		"SET 1,e", // 0xcb
+		"SET 1,h", // 0xcc
+		"SET 1,l", // 0xcd
+		"SET 1,(hl)", // 0xce
+		"SET 1,a", // 0xcf
+		"SET 2,b", // 0xd0
+		"SET 2,c", // 0xd1
+		"SET 2,d", // 0xd2
+		"SET 2,e", // 0xd3
+		"SET 2,h", // 0xd4
+		"SET 2,l", // 0xd5
+		"SET 2,(hl)", // 0xd6
+		"SET 2,a", // 0xd7
+		"SET 3,b", // 0xd8
+		"SET 3,c", // 0xd9
+		"SET 3,d", // 0xda
+		"SET 3,e", // 0xdb
+		"SET 3,h", // 0xdc
+		"SET 3,l", // 0xdd
+		"SET 3,(hl)", // 0xde
+		"SET 3,a", // 0xdf
+		"SET 4,b", // 0xe0
+		"SET 4,c", // 0xe1
+		"SET 4,d", // 0xe2
+		"SET 4,e", // 0xe3
+		"SET 4,h", // 0xe4
+		"SET 4,l", // 0xe5
+		"SET 4,(hl)", // 0xe6
+		"SET 4,a", // 0xe7
+		"SET 5,b", // 0xe8
+		"SET 5,c", // 0xe9
+		"SET 5,d", // 0xea
+		"SET 5,e", // 0xeb
+		"SET 5,h", // 0xec
+		"SET 5,l", // 0xed
+		"SET 5,(hl)", // 0xee
+		"SET 5,a", // 0xef
+		"SET 6,b", // 0xf0
+		"SET 6,c", // 0xf1
+		"SET 6,d", // 0xf2
+		"SET 6,e", // 0xf3
+		"SET 6,h", // 0xf4
+		"SET 6,l", // 0xf5
+		"SET 6,(hl)", // 0xf6
+		"SET 6,a", // 0xf7
+		"SET 7,b", // 0xf8
+		"SET 7,c", // 0xf9
+		"SET 7,d", // 0xfa
+		"SET 7,e", // 0xfb
+		"SET 7,h", // 0xfc
+		"SET 7,l", // 0xfd
+		"SET 7,(hl)", // 0xfe
+		"SET 7,a"  // 0xff
+	};
+
+	const char* const s_opcode_ed_mnemonics [256] = 
+	{
+		nullptr, // 0x00
+		nullptr, // 0x01
+		nullptr, // 0x02
+		nullptr, // 0x03
+		nullptr, // 0x04
+		nullptr, // 0x05
+		nullptr, // 0x06
+		nullptr, // 0x07
+		nullptr, // 0x08
+		nullptr, // 0x09
+		nullptr, // 0x0a
+		nullptr, // 0x0b
+		nullptr, // 0x0c
+		nullptr, // 0x0d
+		nullptr, // 0x0e
+		nullptr, // 0x0f
+		nullptr, // 0x10
+		nullptr, // 0x11
+		nullptr, // 0x12
+		nullptr, // 0x13
+		nullptr, // 0x14
+		nullptr, // 0x15
+		nullptr, // 0x16
+		nullptr, // 0x17
+		nullptr, // 0x18
+		nullptr, // 0x19
+		nullptr, // 0x1a
+		nullptr, // 0x1b
+		nullptr, // 0x1c
+		nullptr, // 0x1d
+		nullptr, // 0x1e
+		nullptr, // 0x1f
+		nullptr, // 0x20
+		nullptr, // 0x21
+		nullptr, // 0x22
+		nullptr, // 0x23
+		nullptr, // 0x24
+		nullptr, // 0x25
+		nullptr, // 0x26
+		nullptr, // 0x27
+		nullptr, // 0x28
+		nullptr, // 0x29
+		nullptr, // 0x2a
+		nullptr, // 0x2b
+		nullptr, // 0x2c
+		nullptr, // 0x2d
+		nullptr, // 0x2e
+		nullptr, // 0x2f
+		nullptr, // 0x30
+		nullptr, // 0x31
+		nullptr, // 0x32
+		nullptr, // 0x33
+		nullptr, // 0x34
+		nullptr, // 0x35
+		nullptr, // 0x36
+		nullptr, // 0x37
+		nullptr, // 0x38
+		nullptr, // 0x39
+		nullptr, // 0x3a
+		nullptr, // 0x3b
+		nullptr, // 0x3c
+		nullptr, // 0x3d
+		nullptr, // 0x3e
+		nullptr, // 0x3f
+		"IN b,(c)", // 0x40
+		"OUT (c),b", // 0x41
+		"SBC hl,bc", // 0x42
+		"LD ({nn}),bc", // 0x43
+		"NEG", // 0x44
+		"RETN", // 0x45
+		"IM 0", // 0x46
+		"LD i,a", // 0x47
+		"IN c,(c)", // 0x48
+		"OUT (c),c", // 0x49
+		"ADC hl,bc", // 0x4a
+		"LD bc,({nn})", // 0x4b
+		nullptr, // 0x4c
+		"RETI", // 0x4d
+		nullptr, // 0x4e
+		"LD r,a", // 0x4f
+		"IN d,(c)", // 0x50
+		"OUT (c),d", // 0x51
+		"SBC hl,de", // 0x52
+		"LD ({nn}),de", // 0x53
+		nullptr, // 0x54
+		nullptr, // 0x55
+		"IM 1", // 0x56
+		"LD a,i", // 0x57
+		"IN e,(c)", // 0x58
+		"OUT (c),e", // 0x59
+		"ADC hl,de", // 0x5a
+		"LD de,({nn})", // 0x5b
+		nullptr, // 0x5c
+		nullptr, // 0x5d
+		"IM 2", // 0x5e
+		"LD a,r", // 0x5f
+		"IN h,(c)", // 0x60
+		"OUT (c),h", // 0x61
+		"SBC hl,hl", // 0x62
+		"LD ({nn}),hl", // 0x63
+		nullptr, // 0x64
+		nullptr, // 0x65
+		nullptr, // 0x66
+		"RRD", // 0x67
+		"IN l,(c)", // 0x68
+		"OUT (c),l", // 0x69
+		"ADC hl,hl", // 0x6a
+		"LD hl,({nn})", // 0x6b
+		nullptr, // 0x6c
+		nullptr, // 0x6d
+		nullptr, // 0x6e
+		"RLD", // 0x6f
+		nullptr, // 0x70
+		nullptr, // 0x71
+		"SBC hl,sp", // 0x72
+		"LD ({nn}),sp", // 0x73
+		nullptr, // 0x74
+		nullptr, // 0x75
+		nullptr, // 0x76
+		nullptr, // 0x77
+		"IN a,(c)", // 0x78
+		"OUT (c),a", // 0x79
+		"ADC hl,sp", // 0x7a
+		"LD sp,({nn})", // 0x7b
+		nullptr, // 0x7c
+		nullptr, // 0x7d
+		nullptr, // 0x7e
+		nullptr, // 0x7f
+		nullptr, // 0x80
+		nullptr, // 0x81
+		nullptr, // 0x82
+		nullptr, // 0x83
+		nullptr, // 0x84
+		nullptr, // 0x85
+		nullptr, // 0x86
+		nullptr, // 0x87
+		nullptr, // 0x88
+		nullptr, // 0x89
+		nullptr, // 0x8a
+		nullptr, // 0x8b
+		nullptr, // 0x8c
+		nullptr, // 0x8d
+		nullptr, // 0x8e
+		nullptr, // 0x8f
+		nullptr, // 0x90
+		nullptr, // 0x91
+		nullptr, // 0x92
+		nullptr, // 0x93
+		nullptr, // 0x94
+		nullptr, // 0x95
+		nullptr, // 0x96
+		nullptr, // 0x97
+		nullptr, // 0x98
+		nullptr, // 0x99
+		nullptr, // 0x9a
+		nullptr, // 0x9b
+		nullptr, // 0x9c
+		nullptr, // 0x9d
+		nullptr, // 0x9e
+		nullptr, // 0x9f
+		"LDI", // 0xa0
+		"CPI", // 0xa1
+		"INI", // 0xa2
+		"OUTI", // 0xa3
+		nullptr, // 0xa4
+		nullptr, // 0xa5
+		nullptr, // 0xa6
+		nullptr, // 0xa7
+		"LDD", // 0xa8
+		"CPD", // 0xa9
+		"IND", // 0xaa
+		"OUTD", // 0xab
+		nullptr, // 0xac
+		nullptr, // 0xad
+		nullptr, // 0xae
+		nullptr, // 0xaf
+		"LDIR", // 0xb0
+		"CPIR", // 0xb1
+		"INIR", // 0xb2
+		"OTIR", // 0xb3
+		nullptr, // 0xb4
+		nullptr, // 0xb5
+		nullptr, // 0xb6
+		nullptr, // 0xb7
+		"LDDR", // 0xb8
+		"CPDR", // 0xb9
+		"INDR", // 0xba
+		"OTDR", // 0xbb
+		nullptr, // 0xbc
+		nullptr, // 0xbd
+		nullptr, // 0xbe
+		nullptr, // 0xbf
+		nullptr, // 0xc0
+		nullptr, // 0xc1
+		nullptr, // 0xc2
+		nullptr, // 0xc3
+		nullptr, // 0xc4
+		nullptr, // 0xc5
+		nullptr, // 0xc6
+		nullptr, // 0xc7
+		nullptr, // 0xc8
+		nullptr, // 0xc9
+		nullptr, // 0xca
+		nullptr, // 0xcb
+		nullptr, // 0xcc
+		nullptr, // 0xcd
+		nullptr, // 0xce
+		nullptr, // 0xcf
+		nullptr, // 0xd0
+		nullptr, // 0xd1
+		nullptr, // 0xd2
+		nullptr, // 0xd3
+		nullptr, // 0xd4
+		nullptr, // 0xd5
+		nullptr, // 0xd6
+		nullptr, // 0xd7
+		nullptr, // 0xd8
+		nullptr, // 0xd9
+		nullptr, // 0xda
+		nullptr, // 0xdb
+		nullptr, // 0xdc
+		nullptr, // 0xdd
+		nullptr, // 0xde
+		nullptr, // 0xdf
+		nullptr, // 0xe0
+		nullptr, // 0xe1
+		nullptr, // 0xe2
+		nullptr, // 0xe3
+		nullptr, // 0xe4
+		nullptr, // 0xe5
+		nullptr, // 0xe6
+		nullptr, // 0xe7
+		nullptr, // 0xe8
+		nullptr, // 0xe9
+		nullptr, // 0xea
+		nullptr, // 0xeb
+		nullptr, // 0xec
+		nullptr, // 0xed
+		nullptr, // 0xee
+		nullptr, // 0xef
+		nullptr, // 0xf0
+		nullptr, // 0xf1
+		nullptr, // 0xf2
+		nullptr, // 0xf3
+		nullptr, // 0xf4
+		nullptr, // 0xf5
+		nullptr, // 0xf6
+		nullptr, // 0xf7
+		nullptr, // 0xf8
+		nullptr, // 0xf9
+		nullptr, // 0xfa
+		nullptr, // 0xfb
+		nullptr, // 0xfc
+		nullptr, // 0xfd
+		nullptr, // 0xfe
+		nullptr  // 0xff
+	};
+}
@@ -2,14 +2,219 @@
 #include "GameRom.h"
 #include "Z80.h"
 #include "SMS.h"
+#include "RomLibrary.h"
+#include "YM2413.h"
+#include "MachineState.h"
+#include <chrono>
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
 
-int main()
+// Loads the ROM (mapping, decompression, hash, database lookup) repeatedly and prints the time per MB.
+static bool BenchmarkLoad(const char* rom_path, uint32_t iterations)
 {
+    double total_ms    = 0.0;
+    double total_bytes = 0.0;
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const GameRom game_rom(rom_path);
+        total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (!game_rom.IsValid())
+            return false;
+        total_bytes += game_rom.GetSize();
+    }
+
+    const double megabytes = total_bytes / (1024.0 * 1024.0);
+    std::cout << rom_path << ": " << total_ms / iterations << " ms per load, " << total_ms / megabytes << " ms per MB\n";
+    return true;
+}
+
+// Plays notes on every FM channel for the given emulated seconds, nine melodic channels then six and
+// the rhythm sounds, and prints the time it takes against real time.
+static void BenchmarkFM(uint32_t seconds)
+{
+    constexpr uint32_t CPU_CLOCK        = 3579545;
+    constexpr uint32_t FRAMES_PER_SEC   = 60;
+    constexpr uint32_t CYCLES_PER_FRAME = CPU_CLOCK / FRAMES_PER_SEC;
+
+    MachineState* state = new MachineState();
+    YM2413 fm(state->fm);
+    fm.SetOutputRate(CPU_CLOCK, SMS::AUDIO_SAMPLE_RATE);
+    fm.Reset(0);
+    state->fm.audio_control = 1; // Port 0xF2, what a game writes once it found the unit.
+
+    static const uint16_t NOTES[8] = { 172, 193, 217, 230, 258, 290, 325, 344 }; // A scale in F-numbers.
+    int16_t  samples[1024];
+    uint64_t cycle = 0;
+    double   total_ms = 0.0;
+
+    const uint32_t num_frames = seconds * FRAMES_PER_SEC;
+    for (uint32_t frame = 0; frame < num_frames; ++frame)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        // A new chord every 8 frames, spread over the frame like a sound driver would.
+        const bool rhythm = frame >= num_frames / 2;
+        if (frame % 8 == 0)
+        {
+            fm.WriteRegister(0x0e, rhythm ? 0x20 : 0x00, cycle);
+            for (uint32_t channel = 0; channel < (rhythm ? 6u : 9u); ++channel)
+            {
+                const uint16_t fnum = NOTES[(frame / 8 + channel * 3) % 8];
+                fm.WriteRegister(static_cast<byte>(0x20 + channel), 0x00, cycle);
+                fm.WriteRegister(static_cast<byte>(0x30 + channel), static_cast<byte>(((channel * 5) % 15 + 1) << 4 | 2), cycle);
+                fm.WriteRegister(static_cast<byte>(0x10 + channel), static_cast<byte>(fnum), cycle);
+                fm.WriteRegister(static_cast<byte>(0x20 + channel), static_cast<byte>(0x10 | (3 + channel % 3) << 1 | fnum >> 8), cycle);
+                cycle += 300;
+            }
+            if (rhythm)
+            {
+                fm.WriteRegister(0x16, 0x20, cycle); fm.WriteRegister(0x26, 0x05, cycle);
+                fm.WriteRegister(0x17, 0x50, cycle); fm.WriteRegister(0x27, 0x05, cycle);
+                fm.WriteRegister(0x18, 0xc0, cycle); fm.WriteRegister(0x28, 0x01, cycle);
+                fm.WriteRegister(0x36, 0x01, cycle); fm.WriteRegister(0x37, 0x11, cycle); fm.WriteRegister(0x38, 0x11, cycle);
+                fm.WriteRegister(0x0e, 0x3f, cycle);
+            }
+        }
+
+        cycle = static_cast<uint64_t>(frame + 1) * CYCLES_PER_FRAME;
+        fm.EndFrame(cycle);
+        while (fm.GetOutput().ReadSamples(samples, sizeof(samples) / sizeof(samples[0])) > 0) {}
+
+        total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    delete state;
+
+    const double sample_rate = static_cast<double>(CPU_CLOCK) / YM2413::CYCLES_PER_SAMPLE;
+    std::cout << "FM: " << num_frames << " frames at " << sample_rate / 1000.0 << "kHz, " << total_ms / seconds << " ms per emulated second ("
+              << total_ms / (seconds * 10.0) << "% of one core)\n";
+}
+
+/*
+    Usage: SierraMasterSystem [rom] [--headless frames] [--profile report.txt] [--load-state in.state] [--save-state out.state]
+                              [--rewind-memory megabytes] [--run-ahead frames] [--record movie.smm] [--pacing audio|video]
+                              [--frame-skip frames] [--fm]
+           SierraMasterSystem rom --play movie.smm
+           SierraMasterSystem --scan directory [--index library.idx]
+           SierraMasterSystem rom --benchmark-load iterations
+           SierraMasterSystem --benchmark-fm seconds
+*/
+int main(int argc, char* argv[])
+{
+    const char* rom_path            = "Roms/Taz-Mania.sms";
+    const char* profile_report_path = nullptr;
+    uint32_t    headless_frames     = 0;
+    const char* scan_path           = nullptr;
+    const char* index_path          = "library.idx";
+    uint32_t    load_iterations     = 0;
+    const char* load_state_path     = nullptr;
+    const char* save_state_path     = nullptr;
+    uint32_t    rewind_megabytes    = 0;
+    uint32_t    run_ahead_frames    = 0;
+    const char* record_path         = nullptr;
+    const char* play_path           = nullptr;
+    FramePacing frame_pacing        = FramePacing::Audio;
+    uint32_t    frame_skip          = 0;
+    bool        fm_enabled          = false;
+    uint32_t    fm_benchmark_secs   = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+            headless_frames = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            profile_report_path = argv[++i];
+        else if (strcmp(argv[i], "--scan") == 0 && i + 1 < argc)
+            scan_path = argv[++i];
+        else if (strcmp(argv[i], "--index") == 0 && i + 1 < argc)
+            index_path = argv[++i];
+        else if (strcmp(argv[i], "--benchmark-load") == 0 && i + 1 < argc)
+            load_iterations = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--load-state") == 0 && i + 1 < argc)
+            load_state_path = argv[++i];
+        else if (strcmp(argv[i], "--save-state") == 0 && i + 1 < argc)
+            save_state_path = argv[++i];
+        else if (strcmp(argv[i], "--rewind-memory") == 0 && i + 1 < argc)
+            rewind_megabytes = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--run-ahead") == 0 && i + 1 < argc)
+            run_ahead_frames = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_path = argv[++i];
+        else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc)
+            play_path = argv[++i];
+        else if (strcmp(argv[i], "--pacing") == 0 && i + 1 < argc)
+            frame_pacing = strcmp(argv[++i], "video") == 0 ? FramePacing::Video : FramePacing::Audio;
+        else if (strcmp(argv[i], "--frame-skip") == 0 && i + 1 < argc)
+            frame_skip = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--fm") == 0)
+            fm_enabled = true;
+        else if (strcmp(argv[i], "--benchmark-fm") == 0 && i + 1 < argc)
+            fm_benchmark_secs = static_cast<uint32_t>(atoi(argv[++i]));
+        else
+            rom_path = argv[i];
+    }
+
+    if (load_iterations > 0)
+    {
+        if (!BenchmarkLoad(rom_path, load_iterations))
+        {
+            std::cerr << "Couldn't load " << rom_path << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (fm_benchmark_secs > 0)
+    {
+        BenchmarkFM(fm_benchmark_secs);
+        return 0;
+    }
+
+    if (scan_path)
+    {
+        RomLibrary library;
+        library.LoadIndex(index_path);
+
+        const RomLibraryScanStats stats = library.Scan(scan_path);
+        std::cout << stats.num_files << " ROMs, " << stats.num_scanned << " scanned, " << stats.num_removed << " removed in " << stats.seconds << "s\n";
+
+        if (!library.SaveIndex(index_path))
+        {
+            std::cerr << "Couldn't write " << index_path << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
     SMS sms;
-    
-    sms.Launch("Roms/Taz-Mania.sms");
-    // sms.Launch("Roms/zexall_sdsc.sms");
+    sms.SetMovieRecording(record_path);
+
+    if (rewind_megabytes > 0)
+        sms.SetRewindMemory(static_cast<size_t>(rewind_megabytes) * 1024 * 1024);
+
+    sms.SetRunAhead(run_ahead_frames);
+    sms.SetFramePacing(frame_pacing);
+    sms.SetFrameSkip(frame_skip);
+    sms.SetFMEnabled(fm_enabled);
+
+    if (play_path)
+        return sms.PlayMovie(rom_path, play_path) ? 0 : 1;
+
+    if (headless_frames > 0)
+    {
+        if (!sms.RunHeadless(rom_path, headless_frames, profile_report_path, load_state_path, save_state_path))
+        {
+            std::cerr << "Couldn't run " << rom_path << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    sms.Launch(rom_path);
     
     return 0;
 }